@@ -45,6 +45,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofxMultiThread.h"
 
 #include "../include/ofxUtilities.H" // example support utils
+#include "../../Support/Plugins/include/ofxsPixelKernels.H" // row converters shared with the support library
+
+using OFX::PixelKernels::Half;
 
 #if defined __APPLE__ || defined linux || defined __FreeBSD__
 #  define EXPORT __attribute__((visibility("default")))
@@ -63,8 +66,13 @@ template <class T> inline T Minimum(T a, T b) {return a < b ? a : b;}
 
 static bool gSupportsBytes  = false;
 static bool gSupportsShorts = false;
+static bool gSupportsHalfs  = false;
 static bool gSupportsFloats = false;
-static int gDepthParamToBytes[3]; // maps the value of the bit depth param to a host supported bit depth
+
+// the depths we convert between, shorts and halfs are both 16 bits, so we go by the depth string rather than ofxuMapPixelDepth
+enum Depth {eDepthNone, eDepthByte, eDepthShort, eDepthHalf, eDepthFloat};
+
+static Depth gDepthParamToDepth[4]; // maps the value of the bit depth param to a host supported bit depth
 
 // pointers64 to various bits of the host
 OfxHost               *gHost;
@@ -168,23 +176,53 @@ isIdentity(OfxImageEffectHandle  effect,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// rendering routines
-template <class T> inline T 
-Clamp(T v, int min, int max)
+// pixel depths
+
+// turn a bit depth string descriptor into one of our depths
+static Depth
+mapDepth(const char *depthStr)
+{
+  if(depthStr == NULL)                         return eDepthNone;
+  if(strcmp(depthStr, kOfxBitDepthByte) == 0)  return eDepthByte;
+  if(strcmp(depthStr, kOfxBitDepthShort) == 0) return eDepthShort;
+  if(strcmp(depthStr, kOfxBitDepthHalf) == 0)  return eDepthHalf;
+  if(strcmp(depthStr, kOfxBitDepthFloat) == 0) return eDepthFloat;
+  return eDepthNone;
+}
+
+// and back again
+static const char *
+mapDepth(Depth depth)
 {
-  if(v < T(min)) return T(min);
-  if(v > T(max)) return T(max);
-  return v;
+  switch(depth) {
+  case eDepthByte  : return kOfxBitDepthByte;
+  case eDepthShort : return kOfxBitDepthShort;
+  case eDepthHalf  : return kOfxBitDepthHalf;
+  case eDepthFloat : return kOfxBitDepthFloat;
+  default          : return kOfxBitDepthNone;
+  }
 }
 
+// the depth of an image
+static Depth
+getImageDepth(OfxPropertySetHandle imageHandle)
+{
+  const char *depthStr = NULL;
+  gPropHost->propGetString(imageHandle, kOfxImageEffectPropPixelDepth, 0, &depthStr);
+  return mapDepth(depthStr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// rendering routines
+
 // look up a pixel in the image, does bounds checking to see if it is in the image rectangle
 template <class PIX> inline PIX *
-pixelAddress(PIX *img, OfxRectI rect, int x, int y, int bytesPerLine)
+pixelAddress(PIX *img, OfxRectI rect, int x, int y, int bytesPerLine, int nComponents)
 {  
-  if(x < rect.x1 || x >= rect.x2 || y < rect.y1 || y > rect.y2)
+  if(x < rect.x1 || x >= rect.x2 || y < rect.y1 || y >= rect.y2)
     return 0;
   PIX *pix = (PIX *) (((char *) img) + (y - rect.y1) * bytesPerLine);
-  pix += x - rect.x1;  
+  pix += (x - rect.x1) * nComponents;
   return pix;
 }
 
@@ -264,9 +302,8 @@ Processor::doProcessing(OfxRectI /*window*/)
 {
 }
 
-// template to do the RGBA processing
-template <class SRCPIX, int kSrcMax, int srcIsFloat,
-	  class DSTPIX, int kDstMax, int dstIsFloat>
+// template to convert the pixels from one depth to another, a row at a time with the shared row converters
+template <class SRCPIX, class DSTPIX>
 class ProcessPix : public Processor {
  public :
   ProcessPix(const Processor &p)
@@ -280,42 +317,45 @@ class ProcessPix : public Processor {
     SRCPIX *src = (SRCPIX *) srcV;
     DSTPIX *dst = (DSTPIX *) dstV;
 
-    float scaleF;
-    scaleF = float(kDstMax)/float(kSrcMax);
-
     for(int y = procWindow.y1; y < procWindow.y2; y++) {
       if(gEffectHost->abort(instance)) break;
 
-      DSTPIX *dstPix = pixelAddress(dst, dstRect, procWindow.x1, y, dstBytesPerLine);
-
-      for(int x = procWindow.x1; x < procWindow.x2; x++) {
-        
-        // if a generator, we have no source
-        SRCPIX *srcPix = pixelAddress(src, srcRect, x, y, srcBytesPerLine);        
-        
-        // change my pixel depths
-        if(srcPix) {
-          for(int c = 0; c < nComponents; c++) {
-            if(dstIsFloat)
-              dstPix[c] = srcPix[c] * scaleF;
-            else if (srcIsFloat) 
-              dstPix[c] = Clamp(srcPix[c] * scaleF, 0, kDstMax);
-            else
-              dstPix[c] = Clamp(srcPix[c] * kDstMax/kSrcMax, 0, kDstMax);	    
-          }
-          srcPix += nComponents;
-        }
-        else {
-          for(int c = 0; c < nComponents; c++)
-            dstPix[c] = 0;
-        }
-        dstPix += nComponents;
-      }
+      DSTPIX *dstPix = pixelAddress(dst, dstRect, procWindow.x1, y, dstBytesPerLine, nComponents);
+
+      // the part of the row the source covers, outside of it we are black and transparent
+      int x1 = Minimum(Maximum(srcRect.x1, procWindow.x1), procWindow.x2);
+      int x2 = Maximum(Minimum(srcRect.x2, procWindow.x2), x1);
+      if(y < srcRect.y1 || y >= srcRect.y2)
+        x1 = x2 = procWindow.x2;
+
+      memset(dstPix, 0, (x1 - procWindow.x1) * nComponents * sizeof(DSTPIX));
+      dstPix += (x1 - procWindow.x1) * nComponents;
+
+      // change my pixel depths
+      if(x2 > x1)
+        OFX::PixelKernels::convertRow(pixelAddress(src, srcRect, x1, y, srcBytesPerLine, nComponents), dstPix, (x2 - x1) * nComponents);
+      dstPix += (x2 - x1) * nComponents;
+
+      memset(dstPix, 0, (procWindow.x2 - x2) * nComponents * sizeof(DSTPIX));
     }
   }
 
 };
 
+// instantiate the templated processor for a source pixel type, depending on the dest pixel type
+template <class SRCPIX>
+static void
+processFrom(const Processor &proc, Depth dstDepth)
+{
+  switch(dstDepth) {
+  case eDepthByte :  {ProcessPix<SRCPIX, unsigned char>  pixProc(proc); break;}
+  case eDepthShort : {ProcessPix<SRCPIX, unsigned short> pixProc(proc); break;}
+  case eDepthHalf :  {ProcessPix<SRCPIX, Half>           pixProc(proc); break;}
+  case eDepthFloat : {ProcessPix<SRCPIX, float>          pixProc(proc); break;}
+  default : break;
+  }
+}
+
 // the process code  that the host sees
 static OfxStatus render(OfxImageEffectHandle effect,
                         OfxPropertySetHandle inArgs,
@@ -355,34 +395,15 @@ static OfxStatus render(OfxImageEffectHandle effect,
                    dst, dstRect, dstRowBytes,
                    renderWindow);
     
-    // now instantiate the templated processor depending on src and dest pixel types, 9 cases in all
-    switch(dstBitDepth) {
-    case 8 : {
-      switch(srcBitDepth) {
-      case 8 :  {ProcessPix<unsigned char,  255,   0, unsigned char, 255, 0> pixProc(proc); break;}
-      case 16 : {ProcessPix<unsigned short, 65535, 0, unsigned char, 255, 0> pixProc(proc); break;}
-      case 32 : {ProcessPix<float,          1,     1, unsigned char, 255, 0> pixProc(proc); break;}
-      }
-    }
-      break;
-
-    case 16 : {
-      switch(srcBitDepth) {
-      case 8 :  {ProcessPix<unsigned char,  255,   0, unsigned short, 65535, 0> pixProc(proc); break;}
-      case 16 : {ProcessPix<unsigned short, 65535, 0, unsigned short, 65535, 0> pixProc(proc); break;}
-      case 32 : {ProcessPix<float,          1,     1, unsigned short, 65535, 0> pixProc(proc); break;}
-      }
-    }
-      break;
-
-    case 32 : {
-      switch(srcBitDepth) {
-      case 8 :  {ProcessPix<unsigned char,  255,   0, float, 1, 1> pixProc(proc); break;}
-      case 16 : {ProcessPix<unsigned short, 65535, 0, float, 1, 1> pixProc(proc); break;}
-      case 32 : {ProcessPix<float,          1,     1, float, 1, 1> pixProc(proc); break;}
-      }
-    }                          
-      break;
+    // now instantiate the templated processor depending on src and dest pixel types, 16 cases in all,
+    // shorts and halfs both report 16 bits, so look at the depth strings
+    Depth srcDepth = getImageDepth(sourceImg), dstDepth = getImageDepth(outputImg);
+    switch(srcDepth) {
+    case eDepthByte :  processFrom<unsigned char>(proc, dstDepth);  break;
+    case eDepthShort : processFrom<unsigned short>(proc, dstDepth); break;
+    case eDepthHalf :  processFrom<Half>(proc, dstDepth);           break;
+    case eDepthFloat : processFrom<float>(proc, dstDepth);          break;
+    default : break;
     }
   }
   catch(OfxuNoImageException &ex) {
@@ -416,14 +437,9 @@ getClipPreferences(OfxImageEffectHandle effect,
   gParamHost->paramGetValue(myData->depthParam, &depthVal);
 
   // and set the output depths based on that
-  switch(gDepthParamToBytes[depthVal]) {
-  // byte
-  case 8 : gPropHost->propSetString(outArgs, "OfxImageClipPropDepth_Output", 0, kOfxBitDepthByte); break;
-  // short
-  case 16 : gPropHost->propSetString(outArgs, "OfxImageClipPropDepth_Output", 0, kOfxBitDepthShort); break;
-  // float
-  case 32 : gPropHost->propSetString(outArgs, "OfxImageClipPropDepth_Output", 0, kOfxBitDepthFloat); break;
-  }
+  Depth depth = gDepthParamToDepth[depthVal];
+  if(depth != eDepthNone)
+    gPropHost->propSetString(outArgs, "OfxImageClipPropDepth_Output", 0, mapDepth(depth));
 
   return kOfxStatOK;
 }
@@ -472,6 +488,7 @@ describeInContext(OfxImageEffectHandle effect, OfxPropertySetHandle inArgs)
   int i = 0;
   if(gSupportsBytes)  gPropHost->propSetString(paramProps, kOfxParamPropChoiceOption, i++, "Byte");
   if(gSupportsShorts) gPropHost->propSetString(paramProps, kOfxParamPropChoiceOption, i++, "Short");
+  if(gSupportsHalfs)  gPropHost->propSetString(paramProps, kOfxParamPropChoiceOption, i++, "Half");
   if(gSupportsFloats) gPropHost->propSetString(paramProps, kOfxParamPropChoiceOption, i++, "Float");
 
   // we convert things to 8 bits by default
@@ -529,26 +546,29 @@ describe(OfxImageEffectHandle  effect)
   // set the bit depths the plugin can handle
   gPropHost->propSetString(effectProps, kOfxImageEffectPropSupportedPixelDepths, 0, kOfxBitDepthByte);
   gPropHost->propSetString(effectProps, kOfxImageEffectPropSupportedPixelDepths, 1, kOfxBitDepthShort);
-  gPropHost->propSetString(effectProps, kOfxImageEffectPropSupportedPixelDepths, 2, kOfxBitDepthFloat);
+  gPropHost->propSetString(effectProps, kOfxImageEffectPropSupportedPixelDepths, 2, kOfxBitDepthHalf);
+  gPropHost->propSetString(effectProps, kOfxImageEffectPropSupportedPixelDepths, 3, kOfxBitDepthFloat);
 
   // figure which bit depths are supported
   int i;
   for(i = 0; i < nHostDepths; i++) {
     const char *depthStr = NULL;
     gPropHost->propGetString(gHost->host, kOfxImageEffectPropSupportedPixelDepths, i, &depthStr);
-    int nBits = ofxuMapPixelDepth(depthStr);
-    switch(nBits) {
-    case 8  : gSupportsBytes  = true; break;
-    case 16 : gSupportsShorts = true; break;
-    case 32 : gSupportsFloats = true; break;
+    switch(mapDepth(depthStr)) {
+    case eDepthByte  : gSupportsBytes  = true; break;
+    case eDepthShort : gSupportsShorts = true; break;
+    case eDepthHalf  : gSupportsHalfs  = true; break;
+    case eDepthFloat : gSupportsFloats = true; break;
+    default : break;
     }
   }
 
   // now set a mapping from parameter value to bit depth
   i = 0;
-  if(gSupportsBytes)  gDepthParamToBytes[i++] = 8; 
-  if(gSupportsShorts) gDepthParamToBytes[i++] = 16;
-  if(gSupportsFloats) gDepthParamToBytes[i++] = 32; 
+  if(gSupportsBytes)  gDepthParamToDepth[i++] = eDepthByte;
+  if(gSupportsShorts) gDepthParamToDepth[i++] = eDepthShort;
+  if(gSupportsHalfs)  gDepthParamToDepth[i++] = eDepthHalf;
+  if(gSupportsFloats) gDepthParamToDepth[i++] = eDepthFloat;
 
   // set some labels and the group it belongs to
   gPropHost->propSetString(effectProps, kOfxPropLabel, 0, "OFX Depth Converter");
@@ -0,0 +1,164 @@
+/*
+Software License :
+
+Copyright (c) 2007, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+   * Neither the name The Open Effects Association Ltd, nor the names of its
+      contributors may be used to endorse or promote products derived from this
+      software without specific prior written permission.
+
+      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+/// This example times the per frame actions of an instance, using the hostDemo
+/// host, and counts the heap allocations each call makes. The allocations made
+/// by the plugin are counted as well, as it shares our operator new.
+///
+/// Usage : actionBench [pluginId [context]]
+///
+/// The plugin is searched for on OFX_PLUGIN_PATH as usual, it defaults to the
+/// Invert example in the filter context.
+
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+
+#include "ofxCore.h"
+#include "ofxImageEffect.h"
+#include "ofxhBinary.h"
+#include "ofxhPropertySuite.h"
+#include "ofxhClip.h"
+#include "ofxhParam.h"
+#include "ofxhMemory.h"
+#include "ofxhImageEffect.h"
+#include "ofxhPluginAPICache.h"
+#include "ofxhPluginCache.h"
+#include "ofxhHost.h"
+#include "ofxhImageEffectAPI.h"
+
+#include "hostDemoHostDescriptor.h"
+
+/// number of calls to operator new so far
+static long gNAllocs = 0;
+
+void *operator new(size_t nBytes)
+{
+  ++gNAllocs;
+  void *ptr = malloc(nBytes ? nBytes : 1);
+  if(!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void *operator new[](size_t nBytes)
+{
+  return operator new(nBytes);
+}
+
+void operator delete(void *ptr) throw()
+{
+  free(ptr);
+}
+
+void operator delete[](void *ptr) throw()
+{
+  free(ptr);
+}
+
+using namespace OFX::Host;
+
+/// call f a few times to warm up, then time nCalls of it
+template <class F> void bench(const char *what, F f, int nCalls)
+{
+  for(int i = 0; i < 10; ++i)
+    f();
+
+  long nAllocs = gNAllocs;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int i = 0; i < nCalls; ++i)
+    f();
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << what << " : " << ns / nCalls << " ns/call, "
+            << double(gNAllocs - nAllocs) / nCalls << " allocs/call" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const char *pluginId = argc > 1 ? argv[1] : "net.sf.openfx.invertPlugin";
+  const char *context = argc > 2 ? argv[2] : kOfxImageEffectContextFilter;
+
+  PluginCache::getPluginCache()->setCacheVersion("actionBenchV1");
+  MyHost::Host host;
+  ImageEffect::PluginCache imageEffectPluginCache(&host);
+  imageEffectPluginCache.registerInCache(*PluginCache::getPluginCache());
+  PluginCache::getPluginCache()->scanPluginFiles();
+
+  ImageEffect::ImageEffectPlugin *plugin = imageEffectPluginCache.getPluginById(pluginId);
+  ImageEffect::Instance *instance = plugin ? plugin->createInstance(context, NULL) : NULL;
+  if(!instance || instance->createInstanceAction() != kOfxStatOK) {
+    std::cerr << "could not make an instance of " << pluginId << " in the " << context << " context" << std::endl;
+    return 1;
+  }
+  instance->getClipPreferences();
+
+  OfxPointD renderScale = {1., 1.};
+  OfxRectD roi = {0, 0, 720, 576};
+  OfxRectI window = {0, 0, 720, 576};
+  OfxRectI tile = {0, 0, 16, 16};
+  std::map<ImageEffect::ClipInstance *, OfxRectD> rois;
+  ImageEffect::RangeMap ranges;
+  std::string field = kOfxImageFieldNone;
+  std::string identityClip;
+  const int nCalls = 200000;
+
+  bench("getRegionOfDefinitionAction", [&] {
+      OfxRectD rod;
+      instance->getRegionOfDefinitionAction(1, renderScale, rod);
+    }, nCalls);
+
+  bench("getRegionOfInterestAction", [&] {
+      instance->getRegionOfInterestAction(1, renderScale, roi, rois);
+    }, nCalls);
+
+  bench("isIdentityAction", [&] {
+      OfxTime time = 1;
+      instance->isIdentityAction(time, field, window, renderScale, identityClip);
+    }, nCalls);
+
+  bench("getFrameNeededAction", [&] {
+      for(ImageEffect::RangeMap::iterator it = ranges.begin(); it != ranges.end(); ++it)
+        it->second.clear();
+      instance->getFrameNeededAction(1, ranges);
+    }, nCalls);
+
+  // this includes fetching the images, and hostDemo builds a property set for each
+  instance->beginRenderAction(0, 1, 1., false, renderScale, true, false, false);
+  bench("renderAction (16x16 tile)", [&] {
+      instance->renderAction(1, field, tile, renderScale, true, false, false);
+    }, nCalls / 10);
+  instance->endRenderAction(0, 1, 1., false, renderScale, true, false, false);
+
+  delete instance;
+  PluginCache::clearPluginCache();
+  return 0;
+}
@@ -29,9 +29,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     
 ////////////////////////////////////////////////////////////////////////////////
 /// This example shows basic plugin cache management.
+///
+/// It also writes the cache in binary form, reads that back into an empty cache and
+/// checks that it holds the same plugins as the XML cache, and fails if it does not.
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cstring>
 #include <stdexcept>
 
 #include "ofxhPluginCache.h"
@@ -148,6 +153,29 @@ public :
 #endif
 };
 
+/// read the binary cache back into an empty cache and compare it with the XML cache it was
+/// written alongside, returns false if they differ
+static bool checkBinaryCache(CacheHost &host, const std::string &fileName, const std::string &xmlCache)
+{
+  OFX::Host::PluginCache::getPluginCache()->setCacheVersion("cacheDemoV1");
+  OFX::Host::ImageEffect::PluginCache imageEffectPluginCache(&host);
+  imageEffectPluginCache.registerInCache(*OFX::Host::PluginCache::getPluginCache());
+
+  bool same = false;
+  try {
+    if(OFX::Host::PluginCache::getPluginCache()->readCache(fileName)) {
+      std::ostringstream os;
+      OFX::Host::PluginCache::getPluginCache()->writePluginCache(os);
+      same = os.str() == xmlCache;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error while reading binary cache: " << e.what() << std::endl;
+  }
+
+  OFX::Host::PluginCache::clearPluginCache();
+  return same;
+}
+
 int main(int argc, char **argv) 
 {
 #ifdef _WIN32
@@ -177,11 +205,26 @@ int main(int argc, char **argv)
   ifs.close();
 
   /// and write a new cache, long version with everything in there
+  std::ostringstream xmlCache;
+  OFX::Host::PluginCache::getPluginCache()->writePluginCache(xmlCache);
   std::ofstream of("newCache.xml");
-  OFX::Host::PluginCache::getPluginCache()->writePluginCache(of);
+  of << xmlCache.str();
   of.close();
 
+  /// and the same in binary form, which is quicker to read at startup
+  std::ofstream bof("newCache.bin", std::ios::binary);
+  bool wroteBinary = OFX::Host::PluginCache::getPluginCache()->writeBinaryPluginCache(bof);
+  bof.close();
+
   imageEffectPluginCache.dumpToStdOut();
   //Clean up, to be polite.
   OFX::Host::PluginCache::clearPluginCache();
+
+  if(!wroteBinary) {
+    std::cout << "binary cache : not written, a plugin api can't be cached as binary" << std::endl;
+    return 0;
+  }
+  bool same = checkBinaryCache(myHost, "newCache.bin", xmlCache.str());
+  std::cout << "binary cache : " << (same ? "reads back the same as the XML cache" : "DIFFERS from the XML cache") << std::endl;
+  return same ? 0 : 1;
 }
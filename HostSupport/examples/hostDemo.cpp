@@ -50,6 +50,8 @@ modification, are permitted provided that the following conditions are met:
 #include "ofxhPluginCache.h"
 #include "ofxhHost.h"
 #include "ofxhImageEffectAPI.h"
+#include "ofxhImageCache.h"
+#include "ofxhTileScheduler.h"
 
 // my host
 #include "hostDemoHostDescriptor.h"
@@ -132,7 +134,7 @@ int main(int argc, char **argv)
   of.close();
 
   // get the invert example plugin which uses the OFX C++ support code
-  OFX::Host::ImageEffect::ImageEffectPlugin* plugin = imageEffectPluginCache.getPluginById("net.sf.openfx:invertPlugin");
+  OFX::Host::ImageEffect::ImageEffectPlugin* plugin = imageEffectPluginCache.getPluginById("net.sf.openfx.invertPlugin");
 
   imageEffectPluginCache.dumpToStdOut();
 
@@ -195,6 +197,14 @@ int main(int argc, char **argv)
       MyHost::MyClipInstance* outputClip = dynamic_cast<MyHost::MyClipInstance*>(instance->getClip("Output"));
       assert(outputClip);
 
+      // cache the source images, so fetching the same frame again does not make it again
+      OFX::Host::ImageEffect::ImageCache imageCache(64 * 1024 * 1024);
+      instance->getClip("Source")->setImageCache(&imageCache);
+
+      // cuts each frame into tiles and renders them on the thread pool, if the
+      // effect can render tiles
+      OFX::Host::ImageEffect::TileScheduler tileScheduler(*instance);
+
       for(int t = 0; t <= numFramesToRender; ++t) 
       {
         // call get region of interest on each of the inputs
@@ -276,32 +286,32 @@ int main(int argc, char **argv)
           std::list<std::string> planes;
           planes.push_back(kOfxImagePlaneColour);
 #       endif
-          stat = instance->renderAction(t, //OfxTime      time,
-                                        kOfxImageFieldBoth, // const std::string &  field,
-                                        renderWindow, // const OfxRectI &renderRoI,
-                                        renderScale, // OfxPointD   renderScale,
-                                        true, // bool     sequentialRender,
-                                        false, // bool     interactiveRender,
-#                                    ifdef OFX_SUPPORTS_OPENGLRENDER
-                                        false, // bool     openGLRender,
-#                                     ifdef OFX_EXTENSIONS_NATRON
-                                        NULL, // void*    contextData,
-#                                     endif
-#                                    endif
-                                        false // bool     draftRender
-#                                    if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
-                                        ,
-                                        0 // int view
-#                                    endif
-#                                    ifdef OFX_EXTENSIONS_VEGAS
-                                        ,
-                                        1 // int nViews
-#                                    endif
-#                                    ifdef OFX_EXTENSIONS_NUKE
-                                        ,
-                                        planes // const std::list<std::string>& planes
-#                                    endif
-                                        );
+          stat = tileScheduler.render(t, //OfxTime      time,
+                                      kOfxImageFieldBoth, // const std::string &  field,
+                                      renderWindow, // const OfxRectI &renderRoI,
+                                      renderScale, // OfxPointD   renderScale,
+                                      true, // bool     sequentialRender,
+                                      false, // bool     interactiveRender,
+#                                  ifdef OFX_SUPPORTS_OPENGLRENDER
+                                      false, // bool     openGLRender,
+#                                   ifdef OFX_EXTENSIONS_NATRON
+                                      NULL, // void*    contextData,
+#                                   endif
+#                                  endif
+                                      false // bool     draftRender
+#                                  if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+                                      ,
+                                      0 // int view
+#                                  endif
+#                                  ifdef OFX_EXTENSIONS_VEGAS
+                                      ,
+                                      1 // int nViews
+#                                  endif
+#                                  ifdef OFX_EXTENSIONS_NUKE
+                                      ,
+                                      planes // const std::list<std::string>& planes
+#                                  endif
+                                      );
         assert(stat == kOfxStatOK);
 
         // get the output image buffer
@@ -325,6 +335,12 @@ int main(int argc, char **argv)
                                 , 0 /* view*/
 #                               endif
                                 );
+
+      size_t hits, misses;
+      imageCache.getStats(hits, misses);
+      std::cout << "source image cache: " << hits << " hits, " << misses << " misses" << std::endl;
+      std::cout << "tiles per frame: " << tileScheduler.getTiles().size() << std::endl;
+      instance->getClip("Source")->setImageCache(NULL);
     }
   }
   OFX::Host::PluginCache::clearPluginCache();
@@ -49,6 +49,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofxhPluginCache.h"
 #include "ofxhHost.h"
 #include "ofxhImageEffectAPI.h"
+#include "ofxhImageCache.h"
 
 // my host
 #include "hostDemoHostDescriptor.h"
@@ -237,7 +238,7 @@ namespace MyHost {
     , _name(desc->getName())
     , _outputImage(NULL)
 #ifdef OFX_EXTENSIONS_VEGAS
-    , _view(0)
+    , _outputView(0)
 #endif
   {
   }
@@ -384,10 +385,19 @@ namespace MyHost {
   OFX::Host::ImageEffect::Image* MyClipInstance::getImage(OfxTime time, const OfxRectD *optionalBounds)
   {
     if(_name == "Output") {
+#ifdef OFX_EXTENSIONS_VEGAS
+      // the view being rendered is that of the render call, not per clip state
+      int view = getRenderView();
+      if(_outputImage && view != _outputView) {
+        delete _outputImage;
+        _outputImage = NULL;
+      }
+#endif
       if(!_outputImage) {
         // make a new ref counted image
 #ifdef OFX_EXTENSIONS_VEGAS
-        _outputImage = new MyImage(*this, 0, _view);
+        _outputImage = new MyImage(*this, 0, view);
+        _outputView = view;
 #else
         _outputImage = new MyImage(*this, 0);
 #endif
@@ -410,7 +420,7 @@ namespace MyHost {
       // You should do somewhat more sophisticated image management
       // than this.
 #ifdef OFX_EXTENSIONS_VEGAS
-      MyImage *image = new MyImage(*this, time, _view);
+      MyImage *image = new MyImage(*this, time, getRenderView());
 #else
       MyImage *image = new MyImage(*this, time);
 #endif
@@ -418,6 +428,21 @@ namespace MyHost {
     }
   }
 
+  /// our input images only depend on the clip and the time, so that is what goes
+  /// in the key. A real host would make it from the effect connected upstream.
+  bool MyClipInstance::getImageCacheKey(OfxTime time, const OfxRectD *optionalBounds, OFX::Host::ImageEffect::ImageCacheKey &key)
+  {
+    key.pluginIdentifier = "hostDemo." + _name;
+    key.time = time;
+#if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+    key.view = getRenderView();
+#endif
+    key.hasRoI = optionalBounds != NULL;
+    if(optionalBounds)
+      key.roi = *optionalBounds;
+    return true;
+  }
+
 #ifdef OFX_EXTENSIONS_NUKE
   /// override this to fill in the given image plane at the given time.
   /// The bounds of the image on the image plane should be
@@ -481,16 +506,4 @@ namespace MyHost {
   }
 #endif
 
-#if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
-  /// set the default view returned by getImage()
-  void MyClipInstance::setView(int view) {
-    if (view != _view) {
-      if (_outputImage) {
-        delete _outputImage;
-        _outputImage = NULL;
-      }
-      _view = view;
-    }
-  }
-#endif
 } // MyHost
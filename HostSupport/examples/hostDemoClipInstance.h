@@ -53,8 +53,8 @@ namespace MyHost {
     MyEffectInstance *_effect;
     std::string       _name;
     MyImage          *_outputImage; ///< only set for output clips
-#if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
-    int               _view; ///< view used by the last renderAction
+#ifdef OFX_EXTENSIONS_VEGAS
+    int               _outputView; ///< view _outputImage was made for
 #endif
 
   public:
@@ -145,6 +145,9 @@ namespace MyHost {
     /// If bounds is not null, fetch the indicated section of the canonical image plane.
     virtual OFX::Host::ImageEffect::Image* getImage(OfxTime time, const OfxRectD *optionalBounds);
 
+    /// make the images of the input clips cacheable
+    virtual bool getImageCacheKey(OfxTime time, const OfxRectD *optionalBounds, OFX::Host::ImageEffect::ImageCacheKey &key);
+
 #ifdef OFX_SUPPORTS_OPENGLRENDER
     /// override this to fill in the OpenGL texture at the given time.
     /// The bounds of the image on the image plane should be
@@ -185,11 +188,6 @@ namespace MyHost {
     virtual OFX::Host::ImageEffect::Image* getStereoscopicImage(OfxTime time, int view, const OfxRectD *optionalBounds);
 #endif
 
-#if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
-    /// set the default view returned by getImage()
-    virtual void setView(int view);
-#endif
-
     /// override this to return the rod on the clip
     virtual OfxRectD getRegionOfDefinition(OfxTime time) const;
 
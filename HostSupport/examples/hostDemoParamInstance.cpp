@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <iostream>
 #include <fstream>
+#include <cmath>
 
 // ofx
 #include "ofxCore.h"
@@ -62,8 +63,10 @@ namespace MyHost {
   MyIntegerInstance::MyIntegerInstance(MyEffectInstance* effect, 
                                        const std::string& name, 
                                        OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::IntegerInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::IntegerInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyIntegerInstance::get(int&)
@@ -71,9 +74,13 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyIntegerInstance::get(OfxTime time, int&)
+  OfxStatus MyIntegerInstance::get(OfxTime time, int& i)
   {
-    return kOfxStatErrMissingHostFeature;
+    double value;
+    if(!getKeyedValues(time, &value))
+      return kOfxStatErrMissingHostFeature;
+    i = (int) floor(value + 0.5);
+    return kOfxStatOK;
   }
 
   OfxStatus MyIntegerInstance::set(int)
@@ -81,8 +88,9 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyIntegerInstance::set(OfxTime time, int) {
-    return kOfxStatErrMissingHostFeature;
+  OfxStatus MyIntegerInstance::set(OfxTime time, int i) {
+    double value = i;
+    return setKeyValues(time, &value);
   }
 
   //
@@ -92,8 +100,10 @@ namespace MyHost {
   MyDoubleInstance::MyDoubleInstance(MyEffectInstance* effect, 
                                      const std::string& name, 
                                      OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::DoubleInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::DoubleInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyDoubleInstance::get(double& d)
@@ -105,6 +115,8 @@ namespace MyHost {
 
   OfxStatus MyDoubleInstance::get(OfxTime time, double& d)
   {
+    if(getKeyedValues(time, &d))
+      return kOfxStatOK;
     // values for the Basic OFX plugin to work
     d = 2.0;
     return kOfxStatOK;
@@ -115,19 +127,9 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyDoubleInstance::set(OfxTime time, double) 
-  {
-    return kOfxStatErrMissingHostFeature;
-  }
-
-  OfxStatus MyDoubleInstance::derive(OfxTime time, double&)
+  OfxStatus MyDoubleInstance::set(OfxTime time, double d) 
   {
-    return kOfxStatErrMissingHostFeature;
-  }
-
-  OfxStatus MyDoubleInstance::integrate(OfxTime time1, OfxTime time2, double&)
-  {
-    return kOfxStatErrMissingHostFeature;
+    return setKeyValues(time, &d);
   }
 
   //
@@ -137,8 +139,10 @@ namespace MyHost {
   MyBooleanInstance::MyBooleanInstance(MyEffectInstance* effect, 
                                        const std::string& name, 
                                        OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::BooleanInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::BooleanInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyBooleanInstance::get(bool& b)
@@ -149,7 +153,8 @@ namespace MyHost {
 
   OfxStatus MyBooleanInstance::get(OfxTime time, bool& b)
   {
-    b = true;
+    double value;
+    b = getKeyedValues(time, &value) ? value != 0. : true;
     return kOfxStatOK;
   }
 
@@ -158,8 +163,9 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyBooleanInstance::set(OfxTime time, bool) {
-    return kOfxStatErrMissingHostFeature;
+  OfxStatus MyBooleanInstance::set(OfxTime time, bool b) {
+    double value = b ? 1. : 0.;
+    return setKeyValues(time, &value);
   }
 
   //
@@ -169,8 +175,10 @@ namespace MyHost {
   MyChoiceInstance::MyChoiceInstance(MyEffectInstance* effect, 
                                      const std::string& name, 
                                      OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::ChoiceInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::ChoiceInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyChoiceInstance::get(int&)
@@ -178,9 +186,13 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyChoiceInstance::get(OfxTime time, int&)
+  OfxStatus MyChoiceInstance::get(OfxTime time, int& i)
   {
-    return kOfxStatErrMissingHostFeature;
+    double value;
+    if(!getKeyedValues(time, &value))
+      return kOfxStatErrMissingHostFeature;
+    i = (int) floor(value + 0.5);
+    return kOfxStatOK;
   }
 
   OfxStatus MyChoiceInstance::set(int)
@@ -188,9 +200,10 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyChoiceInstance::set(OfxTime time, int) 
+  OfxStatus MyChoiceInstance::set(OfxTime time, int i) 
   {
-    return kOfxStatErrMissingHostFeature;
+    double value = i;
+    return setKeyValues(time, &value);
   }
 
   //
@@ -200,8 +213,10 @@ namespace MyHost {
   MyRGBAInstance::MyRGBAInstance(MyEffectInstance* effect, 
                                  const std::string& name, 
                                  OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::RGBAInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::RGBAInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyRGBAInstance::get(double&,double&,double&,double&)
@@ -209,9 +224,16 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyRGBAInstance::get(OfxTime time, double&,double&,double&,double&)
+  OfxStatus MyRGBAInstance::get(OfxTime time, double& r,double& g,double& b,double& a)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[4];
+    if(!getKeyedValues(time, values))
+      return kOfxStatErrMissingHostFeature;
+    r = values[0];
+    g = values[1];
+    b = values[2];
+    a = values[3];
+    return kOfxStatOK;
   }
 
   OfxStatus MyRGBAInstance::set(double,double,double,double)
@@ -219,9 +241,10 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyRGBAInstance::set(OfxTime time, double,double,double,double)
+  OfxStatus MyRGBAInstance::set(OfxTime time, double r,double g,double b,double a)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[4] = { r, g, b, a };
+    return setKeyValues(time, values);
   }
 
   //
@@ -231,8 +254,10 @@ namespace MyHost {
   MyRGBInstance::MyRGBInstance(MyEffectInstance* effect, 
                                const std::string& name, 
                                OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::RGBInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::RGBInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyRGBInstance::get(double&,double&,double&)
@@ -240,9 +265,15 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyRGBInstance::get(OfxTime time, double&,double&,double&)
+  OfxStatus MyRGBInstance::get(OfxTime time, double& r,double& g,double& b)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[3];
+    if(!getKeyedValues(time, values))
+      return kOfxStatErrMissingHostFeature;
+    r = values[0];
+    g = values[1];
+    b = values[2];
+    return kOfxStatOK;
   }
 
   OfxStatus MyRGBInstance::set(double,double,double)
@@ -250,9 +281,10 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyRGBInstance::set(OfxTime time, double,double,double)
+  OfxStatus MyRGBInstance::set(OfxTime time, double r,double g,double b)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[3] = { r, g, b };
+    return setKeyValues(time, values);
   }
 
   //
@@ -262,8 +294,10 @@ namespace MyHost {
   MyDouble2DInstance::MyDouble2DInstance(MyEffectInstance* effect, 
                                          const std::string& name, 
                                          OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::Double2DInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::Double2DInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyDouble2DInstance::get(double&,double&)
@@ -271,9 +305,14 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyDouble2DInstance::get(OfxTime time,double&,double&)
+  OfxStatus MyDouble2DInstance::get(OfxTime time,double& x,double& y)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[2];
+    if(!getKeyedValues(time, values))
+      return kOfxStatErrMissingHostFeature;
+    x = values[0];
+    y = values[1];
+    return kOfxStatOK;
   }
 
   OfxStatus MyDouble2DInstance::set(double,double)
@@ -281,9 +320,10 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyDouble2DInstance::set(OfxTime time,double,double)
+  OfxStatus MyDouble2DInstance::set(OfxTime time,double x,double y)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[2] = { x, y };
+    return setKeyValues(time, values);
   }
 
   //
@@ -293,8 +333,10 @@ namespace MyHost {
   MyInteger2DInstance::MyInteger2DInstance(MyEffectInstance* effect, 
                                            const std::string& name, 
                                            OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::Integer2DInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::Integer2DInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
+    // keep the keys set by the plugin in the built in curve
+    setUsesAnimationCurve(true);
   }
 
   OfxStatus MyInteger2DInstance::get(int&,int&)
@@ -302,9 +344,14 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyInteger2DInstance::get(OfxTime time,int&,int&)
+  OfxStatus MyInteger2DInstance::get(OfxTime time,int& x,int& y)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[2];
+    if(!getKeyedValues(time, values))
+      return kOfxStatErrMissingHostFeature;
+    x = (int) floor(values[0] + 0.5);
+    y = (int) floor(values[1] + 0.5);
+    return kOfxStatOK;
   }
 
   OfxStatus MyInteger2DInstance::set(int,int)
@@ -312,9 +359,10 @@ namespace MyHost {
     return kOfxStatErrMissingHostFeature;
   }
 
-  OfxStatus MyInteger2DInstance::set(OfxTime time,int,int)
+  OfxStatus MyInteger2DInstance::set(OfxTime time,int x,int y)
   {
-    return kOfxStatErrMissingHostFeature;
+    double values[2] = { x, y };
+    return setKeyValues(time, values);
   }
 
   //
@@ -324,7 +372,7 @@ namespace MyHost {
   MyPushbuttonInstance::MyPushbuttonInstance(MyEffectInstance* effect, 
                                              const std::string& name, 
                                              OFX::Host::Param::Descriptor& descriptor)
-    : OFX::Host::Param::PushbuttonInstance(descriptor), _effect(effect), _descriptor(descriptor)
+    : OFX::Host::Param::PushbuttonInstance(descriptor, effect), _effect(effect), _descriptor(descriptor)
   {
   }
 
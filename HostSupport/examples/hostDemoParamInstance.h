@@ -61,8 +61,6 @@ namespace MyHost {
     OfxStatus get(OfxTime time, double&);
     OfxStatus set(double);
     OfxStatus set(OfxTime time, double);
-    OfxStatus derive(OfxTime time, double&);
-    OfxStatus integrate(OfxTime time1, OfxTime time2, double&);
   };
 
   class MyBooleanInstance : public OFX::Host::Param::BooleanInstance {
@@ -0,0 +1,140 @@
+/*
+Software License :
+
+Copyright (c) 2007, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+   * Neither the name The Open Effects Association Ltd, nor the names of its
+      contributors may be used to endorse or promote products derived from this
+      software without specific prior written permission.
+
+      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+/// This example times property gets through the property suite.
+///
+/// It builds the property set of a clip image, the same properties that
+/// ImageEffect::Image has, and reads the values that the Support library's
+/// OFX::Image constructor reads, through the suite as a plugin would. The
+/// names are copied first, as a plugin's kOfx* strings live in the plugin
+/// binary and not at the host's addresses.
+///
+/// Usage : propertyBench [iterations]
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include "ofxCore.h"
+#include "ofxImageEffect.h"
+#include "ofxhPropertySuite.h"
+
+using namespace OFX::Host;
+
+static const Property::PropSpec imageStuffs[] = {
+  { kOfxPropType, Property::eString, 1, false, kOfxTypeImage },
+  { kOfxImageEffectPropPixelDepth, Property::eString, 1, true, kOfxBitDepthFloat },
+  { kOfxImageEffectPropComponents, Property::eString, 1, true, kOfxImageComponentRGBA },
+  { kOfxImageEffectPropPreMultiplication, Property::eString, 1, true, kOfxImageOpaque },
+  { kOfxImageEffectPropRenderScale, Property::eDouble, 2, true, "1.0" },
+  { kOfxImagePropPixelAspectRatio, Property::eDouble, 1, true, "1.0" },
+  { kOfxImagePropBounds, Property::eInt, 4, true, "0" },
+  { kOfxImagePropRegionOfDefinition, Property::eInt, 4, true, "0" },
+  { kOfxImagePropRowBytes, Property::eInt, 1, true, "0" },
+  { kOfxImagePropField, Property::eString, 1, true, "" },
+  { kOfxImagePropUniqueIdentifier, Property::eString, 1, true, "" },
+  { kOfxImagePropData, Property::ePointer, 1, true, NULL },
+  { kOfxImageClipPropConnected, Property::eInt, 1, true, "0" },
+  { kOfxImageClipPropUnmappedComponents, Property::eString, 1, true, "" },
+  { kOfxImageClipPropUnmappedPixelDepth, Property::eString, 1, true, "" },
+  { kOfxImageClipPropFieldExtraction, Property::eString, 1, true, "" },
+  { kOfxImageClipPropFieldOrder, Property::eString, 1, true, "" },
+  { kOfxImageClipPropContinuousSamples, Property::eInt, 1, true, "0" },
+  { kOfxImageEffectPropFrameRate, Property::eDouble, 1, true, "25" },
+  { kOfxImageEffectPropFrameRange, Property::eDouble, 2, true, "0" },
+  { kOfxImageClipPropOptional, Property::eInt, 1, true, "0" },
+  { kOfxImageClipPropIsMask, Property::eInt, 1, true, "0" },
+  { kOfxImageEffectPropTemporalClipAccess, Property::eInt, 1, true, "0" },
+  { kOfxImageEffectPropSupportsTiles, Property::eInt, 1, true, "1" },
+  { kOfxPropName, Property::eString, 1, true, "Source" },
+  { kOfxPropLabel, Property::eString, 1, true, "Source" },
+  { kOfxPropShortLabel, Property::eString, 1, true, "Source" },
+  { kOfxPropLongLabel, Property::eString, 1, true, "Source" },
+  Property::propSpecEnd
+};
+
+/// the properties read by the Support library's image constructor, in its order
+enum { eBounds, eRoD, eRowBytes, ePAR, eRenderScale, eData, eDepth, eComponents, ePremult, eField, eUID, eNNames };
+static const char *imageNames[eNNames] = {
+  kOfxImagePropBounds, kOfxImagePropRegionOfDefinition, kOfxImagePropRowBytes, kOfxImagePropPixelAspectRatio,
+  kOfxImageEffectPropRenderScale, kOfxImagePropData, kOfxImageEffectPropPixelDepth, kOfxImageEffectPropComponents,
+  kOfxImageEffectPropPreMultiplication, kOfxImagePropField, kOfxImagePropUniqueIdentifier
+};
+
+/// number of suite calls made by fetchImage below
+static const int kGetsPerImage = 20;
+
+/// keeps the values read from being optimised away
+static volatile long gSink;
+
+static long fetchImage(const OfxPropertySuiteV1 *suite, OfxPropertySetHandle h, char * const *names)
+{
+  long sink = 0;
+  int v;
+  double d;
+  void *p;
+  const char *s;
+  for(int i = 0; i < 4; ++i) { suite->propGetInt(h, names[eBounds], i, &v); sink += v; }
+  for(int i = 0; i < 4; ++i) { suite->propGetInt(h, names[eRoD], i, &v); sink += v; }
+  suite->propGetInt(h, names[eRowBytes], 0, &v); sink += v;
+  suite->propGetDouble(h, names[ePAR], 0, &d); sink += (long)d;
+  suite->propGetDouble(h, names[eRenderScale], 0, &d); sink += (long)d;
+  suite->propGetDouble(h, names[eRenderScale], 1, &d); sink += (long)d;
+  suite->propGetPointer(h, names[eData], 0, &p); sink += p != NULL;
+  for(int i = eDepth; i < eNNames; ++i) { suite->propGetString(h, names[i], 0, &s); sink += s[0]; }
+  return sink;
+}
+
+int main(int argc, char **argv)
+{
+  const int nIterations = argc > 1 ? atoi(argv[1]) : 1000000;
+
+  Property::Set set(imageStuffs);
+  const OfxPropertySuiteV1 *suite = (const OfxPropertySuiteV1 *) Property::GetSuite(1);
+  OfxPropertySetHandle h = set.getHandle();
+
+  char *names[eNNames];
+  for(int i = 0; i < eNNames; ++i) names[i] = strdup(imageNames[i]);
+
+  long sink = 0;
+  for(int r = 0; r < 1000; ++r) sink += fetchImage(suite, h, names);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int r = 0; r < nIterations; ++r) sink += fetchImage(suite, h, names);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "image property fetch : " << ns / nIterations << " ns per image, "
+            << ns / (nIterations * double(kGetsPerImage)) << " ns per get" << std::endl;
+  gSink = sink;
+
+  for(int i = 0; i < eNNames; ++i) free(names[i]);
+  return 0;
+}
@@ -0,0 +1,159 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#ifndef OFX_ANIMATION_CURVE_H
+#define OFX_ANIMATION_CURVE_H
+
+#include <vector>
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
+#include "ofxCore.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace Param {
+
+      /// The keyframes of an animated parameter and the curve interpolating them.
+      ///
+      /// A curve holds getDimension() values per key. The keys are kept sorted by time in
+      /// contiguous arrays, and the polynomial coefficients of every segment between two keys
+      /// are computed when the keys are edited, as is the running integral of the curve up to
+      /// each key. Evaluating the curve is then a search for the segment holding the time,
+      /// which starts with the segment found by the last evaluation so that the frames of a
+      /// sequential render are found in constant time, followed by a cubic per dimension.
+      /// Derivatives and integrals are computed exactly from the same coefficients.
+      ///
+      /// Before the first key and after the last one the curve holds the value of that key.
+      ///
+      /// Evaluation is safe from several threads at once, editing the keys is not and must
+      /// be serialised with evaluation, as with any other change to a parameter's value.
+      class AnimationCurve {
+      public :
+        /// how a curve goes from a key to the next one
+        enum Interpolation {
+          eInterpolationConstant, ///< hold the value of the key up to the next one
+          eInterpolationLinear,   ///< straight line to the next key
+          eInterpolationSmooth    ///< cubic with Catmull-Rom tangents at the keys
+        };
+
+        /// make a curve with no keys, new keys will use the given interpolation
+        explicit AnimationCurve(int nDimensions = 1, Interpolation interpolation = eInterpolationSmooth);
+
+        AnimationCurve(const AnimationCurve &other);
+
+        AnimationCurve &operator=(const AnimationCurve &other);
+
+        /// number of values per key
+        int getDimension() const { return _nDimensions; }
+
+        /// set the number of values per key, which deletes all the keys
+        void setDimension(int nDimensions);
+
+        /// interpolation given to keys made by setKey
+        Interpolation getDefaultInterpolation() const { return _interpolation; }
+        void setDefaultInterpolation(Interpolation interpolation) { _interpolation = interpolation; }
+
+        /// number of keys
+        int getNumKeys() const { return (int) _times.size(); }
+
+        /// time of the nth key
+        OfxTime getKeyTime(int nth) const { return _times[nth]; }
+
+        /// the getDimension() values of the nth key
+        const double *getKeyValues(int nth) const { return _nDimensions ? &_values[nth * _nDimensions] : 0; }
+
+        /// interpolation of the segment going from the nth key to the next one
+        Interpolation getKeyInterpolation(int nth) const { return (Interpolation) _interpolations[nth]; }
+        void setKeyInterpolation(int nth, Interpolation interpolation);
+
+        /// index of the key at the time if direction is 0, else of the first key before
+        /// (direction < 0) or after (direction > 0) the time, -1 if there is no such key
+        int getKeyIndex(OfxTime time, int direction) const;
+
+        /// set the key at the given time, making it if needed, and return its index
+        int setKey(OfxTime time, const double *values);
+
+        /// delete the key at the given time, false if there is none
+        bool deleteKey(OfxTime time);
+
+        /// delete all the keys
+        void deleteAllKeys();
+
+        /// value of the curve at a time, false if there are no keys
+        bool getValue(OfxTime time, double *values) const;
+
+        /// derivative of the curve with respect to time, false if there are no keys
+        bool getDerivative(OfxTime time, double *values) const;
+
+        /// integral of the curve from time1 to time2, false if there are no keys
+        bool getIntegral(OfxTime time1, OfxTime time2, double *values) const;
+
+      protected :
+        /// index of the segment starting at the last key at or before the time, -1 before the
+        /// first key, getNumKeys() - 1 at or after the last key
+        int findSegment(OfxTime time) const;
+
+        /// recompute the coefficients of segments first to last and the integrals after them
+        void updateSegments(int first, int last);
+
+        /// slope of the curve at the nth key used for smooth segments
+        double getTangent(int nth, int dimension) const;
+
+        /// integral of the curve from the first key to the time, segment is findSegment(time)
+        double getIntegralTo(OfxTime time, int segment, int dimension) const;
+
+        int                 _nDimensions;
+        Interpolation       _interpolation;
+        std::vector<OfxTime> _times;          ///< key times, increasing
+        std::vector<double> _values;          ///< _nDimensions values per key
+        std::vector<char>   _interpolations;  ///< per key, for the segment leaving it
+        std::vector<double> _coefficients;    ///< 4 x _nDimensions per segment, in powers of the segment's normalised time
+        std::vector<double> _integrals;       ///< _nDimensions per key, integral of the curve from the first key
+
+#if __cplusplus >= 201103L
+        mutable std::atomic<int> _lastSegment; ///< hint for findSegment
+#else
+        mutable int         _lastSegment;
+#endif
+      };
+
+    }
+
+  }
+
+}
+
+#endif
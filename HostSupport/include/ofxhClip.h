@@ -34,6 +34,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofxImageEffect.h"
 #include "ofxhUtilities.h"
 
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
 namespace OFX {
 
   namespace Host {
@@ -42,6 +46,9 @@ namespace OFX {
       // forward declarations
       class Image;
       class Instance;
+      class ImageCache;
+      struct ImageCacheKey;
+      struct RenderContext;
 #   ifdef OFX_SUPPORTS_OPENGLRENDER
       class Texture;
 #   endif
@@ -152,6 +159,7 @@ namespace OFX {
         bool  _isOutput;                         ///< are we the output clip
         std::string             _pixelDepth;     ///< what is the bit depth we is at. Set during the clip prefernces action.
         std::string             _components;     ///< what components do we have.  Set during the clip prefernces action.
+        ImageCache*             _imageCache;     ///< cache of the images fetched through this clip, not owned, may be NULL
         
       public:
         ClipInstance(ImageEffect::Instance* effectInstance, ClipDescriptor& desc);
@@ -319,7 +327,29 @@ namespace OFX {
         /// on the effect instance. Outside a render call, the optionalBounds should
         /// be 'appropriate' for the.
         /// If bounds is not null, fetch the indicated section of the canonical image plane.
+        /// This may be called concurrently from several plugin threads, and the image
+        /// returned may be shared between them, it is released with Image::releaseReference.
         virtual ImageEffect::Image* getImage(OfxTime time, const OfxRectD *optionalBounds) = 0;
+
+        /// set the cache that fetchImage looks images up in, NULL (the default) for no caching.
+        /// The cache is not owned by the clip and may be shared by several clips.
+        void setImageCache(ImageCache *cache) { _imageCache = cache; }
+
+        /// get the cache set by setImageCache
+        ImageCache *getImageCache() const { return _imageCache; }
+
+        /// override this to make the images of this clip cacheable. Fill in the key
+        /// identifying the image getImage(time, optionalBounds) would return, typically
+        /// from the effect connected upstream with ImageCacheKey(upstreamEffect, time, view,
+        /// renderScale, optionalBounds), and return true. The default returns false, meaning
+        /// the image is not to be cached.
+        virtual bool getImageCacheKey(OfxTime time, const OfxRectD *optionalBounds, ImageCacheKey &key);
+
+        /// fetch an image for the plugin, this is what clipGetImage calls. If the clip has
+        /// an image cache and getImageCacheKey gives a key, the image is looked up in the
+        /// cache first and getImage only called on a miss, its result being cached.
+        /// Images of output clips are never cached.
+        ImageEffect::Image* fetchImage(OfxTime time, const OfxRectD *optionalBounds);
                              
 #     ifdef OFX_EXTENSIONS_NUKE
                              
@@ -331,9 +361,9 @@ namespace OFX {
         /// be 'appropriate' for the image.
         /// If bounds is not null, fetch the indicated section of the canonical image plane.
         ///
-        /// This function implements both V1 of the image plane suite and V2. In the V1 the parameter view was not present and
-        /// will be passed -1, indicating that you should on your own retrieve the correct index of the view at which the render called was issues
-        /// by using thread local storage. In V2 the view index will be correctly set with a value >= 0.
+        /// This function implements both V1 of the image plane suite and V2. In the V1 the parameter view was not present,
+        /// the view of the render call being made is passed instead (see getRenderView), or -1 outside a render call.
+        /// In V2 the view index will be correctly set with a value >= 0.
         ///
         virtual ImageEffect::Image* getImagePlane(OfxTime time, int view, const std::string& plane,const OfxRectD *optionalBounds) = 0;
                     
@@ -363,14 +393,22 @@ namespace OFX {
 #     endif
 
 #     if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
-        /// override this to set the view to be returned by getImage()
-        /// This is called by Instance::renderAction() for each clip, before calling
-        /// kOfxImageEffectActionRender on the Instance.
-        /// The view number has to be stored in the Clip, so this is typically not thread-safe,
-        /// except if thread-local storage is used.
-        virtual void setView(int view) = 0;
+        /// deprecated, getImage() should use getRenderView() instead.
+        /// Instance::renderAction still calls this for each clip before the render action, for
+        /// hosts that keep the view in the clip. That is not safe when several renders run on
+        /// the instance at once. Does nothing by default.
+        virtual void setView(int /*view*/) {}
 #     endif
 
+        /// the render call the calling thread is making on our effect instance, NULL outside
+        /// one, see Instance::getRenderContext
+        const ImageEffect::RenderContext *getRenderContext() const;
+
+        /// the view getImage() should return, that of the render call the calling thread is
+        /// making on our effect instance, 0 outside one. Several views may be rendering on
+        /// the instance at once, so this is looked up per call rather than kept in the clip.
+        int getRenderView() const;
+
         /// override this to return the rod on the clip
         virtual OfxRectD getRegionOfDefinition(OfxTime time) const = 0;
 
@@ -385,7 +423,11 @@ namespace OFX {
       protected :
         /// called during ctors to get bits from the clip props into ours
         void getClipBits(ClipInstance& instance);
+#if __cplusplus >= 201103L
+        std::atomic<int> _referenceCount; ///< reference count on this image, images may be shared between plugin threads
+#else
         int _referenceCount; ///< reference count on this image
+#endif
 
       public:
         // default constructor
@@ -452,11 +494,18 @@ namespace OFX {
         /// get the full region of this image
         OfxRectI getROD() const;
 
-        /// release the reference count, which, if zero, deletes this
+        /// release the reference count, which, if zero, deletes this. This is thread safe
         void releaseReference();
 
-        /// add a reference to this image
-        void addReference() {_referenceCount++;}
+        /// add a reference to this image, this is thread safe
+        void addReference()
+        {
+#if __cplusplus >= 201103L
+          _referenceCount.fetch_add(1, std::memory_order_relaxed);
+#else
+          _referenceCount++;
+#endif
+        }
       };
 
       /// instance of an image inside an image effect
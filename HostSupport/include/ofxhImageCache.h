@@ -0,0 +1,175 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef OFX_IMAGE_CACHE_H
+#define OFX_IMAGE_CACHE_H
+
+#include <stddef.h>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
+#include "ofxCore.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace Param {
+      class SetInstance;
+    }
+
+    namespace ImageEffect {
+
+      // forward declarations
+      class Image;
+      class Instance;
+
+      /// Identifies an image rendered by an effect, so that it can be found again
+      /// in an ImageCache. Two fetches with equal keys must give the same pixels.
+      struct ImageCacheKey {
+        std::string        pluginIdentifier; ///< identifier of the effect that rendered the image
+        unsigned long long paramHash;        ///< hash of the effect's parameter values, see hashParams()
+        OfxTime            time;
+        int                view;
+        OfxPointD          renderScale;
+        bool               hasRoI;           ///< false if the whole image was fetched
+        OfxRectD           roi;              ///< the bounds fetched, in canonical coordinates, if hasRoI
+
+        ImageCacheKey();
+
+        /// make the key for an image rendered by the given effect instance, the
+        /// plugin identifier and parameter hash are taken from the instance
+        ImageCacheKey(Instance &effect,
+                      OfxTime time,
+                      int view,
+                      OfxPointD renderScale,
+                      const OfxRectD *roi);
+
+        /// hash the values of all the parameters of a set at the given time
+        static unsigned long long hashParams(const Param::SetInstance &params, OfxTime time);
+
+        bool operator<(const ImageCacheKey &other) const;
+        bool operator==(const ImageCacheKey &other) const;
+      };
+
+      /// Least recently used cache of images under a byte budget.
+      ///
+      /// The cache holds a reference on each image it contains, and hands out a
+      /// new reference on each hit, so images are released the usual way with
+      /// Image::releaseReference(). Images in the cache are shared and must not be
+      /// written to. All the members are thread safe.
+      ///
+      /// Attach a cache to the clips of an effect with ClipInstance::setImageCache.
+      class ImageCache {
+      public :
+        /// make a cache that holds at most maxBytes of image data
+        explicit ImageCache(size_t maxBytes);
+
+        /// releases all the images in the cache
+        virtual ~ImageCache();
+
+        /// look an image up, if found it is made the most recently used and is
+        /// returned with a reference added for the caller, otherwise NULL
+        Image *get(const ImageCacheKey &key);
+
+        /// add an image to the cache, the cache takes a reference of its own on
+        /// the image. An image already cached under that key is replaced. The least
+        /// recently used images are evicted to fit in the budget, an image bigger
+        /// than the whole budget is not cached.
+        void insert(const ImageCacheKey &key, Image *image);
+
+        /// release all the images in the cache
+        void clear();
+
+        /// set the byte budget, evicting as needed
+        void setMaxBytes(size_t maxBytes);
+
+        /// get the byte budget
+        size_t getMaxBytes() const;
+
+        /// bytes of image data held by the cache
+        size_t getBytes() const;
+
+        /// number of images held by the cache
+        size_t getCount() const;
+
+        /// number of successful and failed calls to get()
+        void getStats(size_t &hits, size_t &misses) const;
+
+        /// number of bytes of pixel data of an image, from its bounds and row bytes
+        static size_t getImageBytes(const Image &image);
+
+      private :
+        struct Entry {
+          ImageCacheKey key;
+          Image        *image;
+          size_t        nBytes;
+        };
+        typedef std::list<Entry> EntryList;
+        typedef std::map<ImageCacheKey, EntryList::iterator> EntryMap;
+
+        /// pop least recently used entries until the budget is met, the images are
+        /// moved to evicted to be released once the lock is dropped
+        void trim(std::vector<Image *> &evicted);
+
+        /// release the references held on some images
+        static void release(std::vector<Image *> &images);
+
+        /// scoped lock on _mutex, does nothing without C++11 threads
+        class Lock;
+
+        // not copyable
+        ImageCache(const ImageCache &);
+        ImageCache &operator=(const ImageCache &);
+
+#if __cplusplus >= 201103L
+        mutable std::mutex _mutex;
+#endif
+        EntryList _entries;  ///< most recently used first
+        EntryMap  _byKey;    ///< index on _entries
+        size_t    _maxBytes;
+        size_t    _bytes;
+        size_t    _hits;
+        size_t    _misses;
+      };
+
+    } // ImageEffect
+
+  } // Host
+
+} // OFX
+
+#endif // OFX_IMAGE_CACHE_H
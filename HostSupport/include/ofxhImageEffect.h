@@ -45,6 +45,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofxNatron.h"
 #endif
 
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
 #ifdef _MSC_VER
 //Use visual studio extension
 #define __PRETTY_FUNCTION__ __FUNCSIG__
@@ -69,6 +73,63 @@ namespace OFX {
       class Instance;
       class Descriptor;
 
+      /// The actions of the image effect API, see internAction
+      enum ActionId {
+        eActionUnknown,
+        eActionLoad,
+        eActionUnload,
+        eActionDescribe,
+        eActionDescribeInContext,
+        eActionCreateInstance,
+        eActionDestroyInstance,
+        eActionRender,
+        eActionBeginSequenceRender,
+        eActionEndSequenceRender,
+        eActionIsIdentity,
+        eActionGetRegionOfDefinition,
+        eActionGetRegionsOfInterest,
+        eActionGetFramesNeeded,
+        eActionGetClipPreferences,
+        eActionGetTimeDomain,
+        eActionPurgeCaches,
+        eActionSyncPrivateData,
+        eActionBeginInstanceChanged,
+        eActionInstanceChanged,
+        eActionEndInstanceChanged,
+        eActionBeginInstanceEdit,
+        eActionEndInstanceEdit,
+#ifdef OFX_SUPPORTS_OPENGLRENDER
+        eActionOpenGLContextAttached,
+        eActionOpenGLContextDetached,
+#endif
+#ifdef OFX_SUPPORTS_DIALOG
+        eActionDialog,
+#endif
+#ifdef OFX_EXTENSIONS_NUKE
+        eActionGetClipComponents,
+        eActionGetFrameViewsNeeded,
+        eActionGetTransform,
+#endif
+#ifdef OFX_EXTENSIONS_NATRON
+        eActionGetInverseDistortion,
+#endif
+        eActionCount
+      };
+
+      /// an action of the image effect API, with its name as a string made once
+      struct InternedAction {
+        ActionId           id;
+        const char        *name;   ///< the API's constant, NULL for unknown actions
+        const std::string *string; ///< the name as a string, NULL for unknown actions
+      };
+
+      /// Find the interned form of an action.
+      ///
+      /// The action is first looked up by address among the API's constants and the interned
+      /// strings, which is what the host passes, then by a hash of its name. Both take
+      /// constant time and allocate nothing. Actions not in the API give eActionUnknown.
+      const InternedAction &internAction(const char *action);
+
       /// An image effect host, passed to the setHost function of all image effect plugins
       class Host : public OFX::Host::Host {
       public :
@@ -126,6 +187,10 @@ namespace OFX {
         //
 
         /// @see OfxMultiThreadSuiteV1.multiThread()
+        ///
+        /// func should run with MultiThread::setThreadContext() set to the calling thread's
+        /// MultiThread::getThreadContext(), or the clips will not know which render the
+        /// plugin's threads are fetching images for.
         virtual OfxStatus multiThread(OfxThreadFunctionV1 func,unsigned int nThreads, void *customArg) = 0;
           
         /// @see OfxMultiThreadSuiteV1.multiThreadNumCPUS()
@@ -410,6 +475,24 @@ namespace OFX {
       /// a map used to specify clip components on clips
       typedef std::map<ClipInstance*,std::list<std::string> > ComponentsMap;
 #endif
+
+      /// The arguments of a render call in progress. Instance::renderAction makes one on
+      /// its stack for the duration of the call, and the clips find it through
+      /// Instance::getRenderContext() instead of keeping per clip state, so that several
+      /// render calls can run on one instance at once.
+      struct RenderContext {
+        const Instance      *instance;
+        OfxTime              time;
+        const std::string   *field;
+        OfxRectI             renderWindow;
+        OfxPointD            renderScale;
+        bool                 sequentialRender;
+        bool                 interactiveRender;
+        bool                 draftRender;
+        int                  view;      ///< 0 unless the view extensions are on
+        const RenderContext *enclosing; ///< the render the calling thread was in before this one, if any
+      };
+
       /// an image effect plugin instance.
       ///
       /// Client code needs to filling the pure virtuals in this.
@@ -436,6 +519,28 @@ namespace OFX {
         std::string                                   _outputFielding;  ///< set by clip prefs
         double                                        _outputFrameRate; ///< set by clip prefs
 
+        /// argument sets of the actions called for every frame or tile, made once and reset in place
+        Property::ReusableSet                         _renderInArgs;
+        Property::ReusableSet                         _rodInArgs;
+        Property::ReusableSet                         _rodOutArgs;
+        Property::ReusableSet                         _roiInArgs;
+        Property::ReusableSet                         _roiOutArgs;
+        Property::ReusableSet                         _framesNeededInArgs;
+        Property::ReusableSet                         _framesNeededOutArgs;
+        Property::ReusableSet                         _isIdentityInArgs;
+        Property::ReusableSet                         _isIdentityOutArgs;
+
+#if __cplusplus >= 201103L
+        /// held around the render action unless the plugin is fully render thread safe
+        std::recursive_mutex                          _renderMutex;
+#endif
+
+        /// scoped lock honouring the plugin's render thread safety, see renderAction
+        class RenderLock;
+
+        /// makes a render context current on the calling thread, see renderAction
+        class RenderScope;
+
       public:        
         /// constructor based on effect descriptor
         Instance(ImageEffectPlugin* plugin,
@@ -727,6 +832,12 @@ namespace OFX {
 #                                         endif
                                             );
 
+        /// call the render action. This may be called from several threads at once, on
+        /// different tiles, frames or views; calls are serialised as the plugin's
+        /// kOfxImageEffectPluginRenderThreadSafety requires: unsafe plugins render one call
+        /// at a time across all their instances, instance safe ones (and instances asking for
+        /// kOfxImageEffectInstancePropSequentialRender) one call at a time per instance, and
+        /// fully safe ones are not serialised at all.
         virtual OfxStatus renderAction(OfxTime      time,
                                        const std::string &  field,
                                        const OfxRectI &renderRoI,
@@ -754,6 +865,13 @@ namespace OFX {
 #                                    endif
                                        );
 
+        /// the render call on this instance the calling thread is in, the innermost one if
+        /// renders nest. The work items a plugin runs through the multithread suite are in
+        /// the render that started them, see MultiThread::getThreadContext. NULL when the
+        /// calling thread is not in a render of this instance, such as a thread the plugin
+        /// made itself.
+        const RenderContext *getRenderContext() const;
+
         virtual OfxStatus endRenderAction(OfxTime  startFrame,
                                           OfxTime  endFrame,
                                           OfxTime  step,
@@ -35,6 +35,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 #include <set>
 #include <memory>
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
 
 #include "ofxCore.h"
 #include "ofxImageEffect.h"
@@ -67,8 +70,20 @@ namespace OFX {
 
         auto_ptr<PluginHandle> _pluginHandle;
 
+#if __cplusplus >= 201103L
+        /// serialises the render actions of all the instances of a render unsafe plugin
+        std::recursive_mutex _renderMutex;
+
+        /// held while a deferred describe runs, so other threads wait for the whole descriptor
+        mutable std::recursive_mutex _describeMutex;
+#endif
+        mutable bool _describing; ///< the deferred describe is running, see describeIfPending
+
         void addContextInternal(const std::string &context) const;
 
+        /// run the describe action deferred by a lazy scan, see PluginCache::setLazyDescribe
+        void describeIfPending() const;
+
       public:
 		ImageEffectPlugin(PluginCache &pc, PluginBinary *pb, int pi, OfxPlugin *pl);
 
@@ -88,7 +103,8 @@ namespace OFX {
         APICache::PluginAPICacheI &getApiHandler();
 
 
-        /// get the base image effect descriptor
+        /// get the base image effect descriptor, this runs the describe action first if
+        /// it was deferred by a lazy scan
         Descriptor &getDescriptor();
 
         /// get the base image effect descriptor, const version
@@ -110,6 +126,12 @@ namespace OFX {
         /// the client data ptr is what is passed back to the client creation function
         ImageEffect::Instance* createInstance(const std::string &context, void *clientDataPtr);
 
+#if __cplusplus >= 201103L
+        /// held around the render action of every instance when the plugin's
+        /// kOfxImageEffectPluginRenderThreadSafety is kOfxImageEffectRenderUnsafe
+        std::recursive_mutex &getRenderMutex() { return _renderMutex; }
+#endif
+
       private:
         void unload();
       };
@@ -203,6 +225,9 @@ namespace OFX {
         /// handle the case where the info needs filling in from the file.  runs the "describe" action on the plugin.
         void loadFromPlugin(Plugin *p) const;
 
+        /// marks the plugin so that loadFromPlugin is run when it is first used
+        virtual void deferLoadFromPlugin(Plugin *p) const;
+
         /// hook run before deleting the ImageEffect
         void unloadPlugin(Plugin *p) const;
 
@@ -220,6 +245,9 @@ namespace OFX {
         
         virtual void saveXML(Plugin *ip, std::ostream &os) const;
 
+        /// the binary cache keeps the descriptor properties, as saveXML does
+        virtual Property::Set *getCacheProperties(Plugin *ip) const;
+
         void confirmPlugin(Plugin *p, const std::list<std::string>& pluginPath);
 
         virtual bool pluginSupported(Plugin *p, std::string &reason) const;
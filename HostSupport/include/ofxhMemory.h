@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OFX_MEMORY_H
 
 #include <memory>
+#include <stddef.h>
 
 namespace OFX {
 
@@ -45,6 +46,40 @@ namespace OFX {
 
     namespace Memory {
 
+      /// Counters of the image memory pool, see getPoolStats()
+      struct PoolStats {
+        size_t hits;          ///< allocations served with a block kept by the pool
+        size_t misses;        ///< allocations that had to go to the system
+        size_t bytesInUse;    ///< bytes in blocks handed out and not freed yet
+        size_t bytesResident; ///< bytes in free blocks kept by the pool for reuse
+      };
+
+      /// Image memory handed out by Instance comes from a pool of blocks aligned on
+      /// kPoolAlignment bytes. Sizes are rounded up to a size class, four per power
+      /// of two, and freed blocks are kept per class for reuse until the pool holds
+      /// more than the high water mark, beyond which they go back to the system.
+      enum { kPoolAlignment = 64 };
+
+      /// allocate a block of at least nBytes, the size actually reserved is returned
+      /// in blockSize and must be passed back to poolFree. Returns NULL on failure.
+      void *poolAlloc(size_t nBytes, size_t &blockSize);
+
+      /// give back a block allocated by poolAlloc
+      void poolFree(void *ptr, size_t blockSize);
+
+      /// release all the free blocks held by the pool to the system. This is called
+      /// when the host asks an effect instance to purge its caches.
+      void purgePool();
+
+      /// set the number of bytes of free blocks the pool may keep, 0 disables pooling
+      void setPoolHighWaterMark(size_t nBytes);
+
+      /// get the number of bytes of free blocks the pool may keep
+      size_t getPoolHighWaterMark();
+
+      /// get the pool counters
+      PoolStats getPoolStats();
+
       class Instance {
       public:
         Instance();
@@ -61,6 +96,7 @@ namespace OFX {
 
       protected:
         char*   _ptr;
+        size_t  _blockSize; ///< size of the pool block behind _ptr
         int     _locked;
       };
 
@@ -0,0 +1,122 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef OFX_MULTITHREAD_H
+#define OFX_MULTITHREAD_H
+
+#include "ofxCore.h"
+#include "ofxMultiThread.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace MultiThread {
+
+      /// The default implementation of OfxMultiThreadSuiteV1 used when the host
+      /// does not define OFX_SUPPORTS_MULTITHREAD.
+      ///
+      /// It is backed by a persistent pool of worker threads, created the first
+      /// time multiThread() is called. Each call to multiThread() pushes a batch of
+      /// nThreads work items on the queue of the calling thread, which then
+      /// processes them itself while idle workers steal from it. Because the caller
+      /// always takes part in the work, a plugin function can itself call
+      /// multiThread() from a spawned thread without deadlocking the pool.
+      ///
+      /// Without C++11 threads, every work item runs on the calling thread.
+
+      /// Set the maximum number of threads the pool may use, including the
+      /// thread calling multiThread(). 0 means one per CPU, which is the default.
+      ///
+      /// This should be called by the host before rendering starts, it must not be
+      /// called from within a multiThread() call.
+      void setMaxThreads(unsigned int nThreads);
+
+      /// the maximum number of threads the pool may use, as reported to plugins
+      unsigned int getMaxThreads();
+
+      /// @see OfxMultiThreadSuiteV1.multiThread()
+      ///
+      /// Returns kOfxStatFailed if func threw on any of the threads, once they have all finished.
+      OfxStatus multiThread(OfxThreadFunctionV1 func, unsigned int nThreads, void *customArg);
+
+      /// @see OfxMultiThreadSuiteV1.multiThreadNumCPUs()
+      OfxStatus multiThreadNumCPUs(unsigned int *nCPUs);
+
+      /// @see OfxMultiThreadSuiteV1.multiThreadIndex()
+      OfxStatus multiThreadIndex(unsigned int *threadIndex);
+
+      /// @see OfxMultiThreadSuiteV1.multiThreadIsSpawnedThread()
+      int multiThreadIsSpawnedThread();
+
+      /// The calling thread's context, an opaque pointer that ImageEffect::Instance sets
+      /// to the render call the thread is in. The work items of a multiThread() call run
+      /// with the calling thread's context, whichever thread they run on, so that a
+      /// plugin's worker threads see the render that started them.
+      const void *getThreadContext();
+
+      /// Sets the calling thread's context, see getThreadContext().
+      void setThreadContext(const void *context);
+
+      /// The mutexes handed out by the default multithread suite.
+      ///
+      /// They are recursive, as required by the suite. Locking an uncontended
+      /// mutex is a single compare and swap, a contended lock spins for a short
+      /// while before parking the thread, so the kernel is only involved when a
+      /// thread actually has to wait.
+
+      /// @see OfxMultiThreadSuiteV1.mutexCreate()
+      ///
+      /// A positive lockCount creates the mutex already locked that many times
+      /// by the calling thread, zero or negative counts create it unlocked.
+      OfxStatus mutexCreate(OfxMutexHandle *mutex, int lockCount);
+
+      /// @see OfxMultiThreadSuiteV1.mutexDestroy()
+      OfxStatus mutexDestroy(const OfxMutexHandle mutex);
+
+      /// @see OfxMultiThreadSuiteV1.mutexLock()
+      OfxStatus mutexLock(const OfxMutexHandle mutex);
+
+      /// @see OfxMultiThreadSuiteV1.mutexUnLock()
+      ///
+      /// returns kOfxStatFailed if the calling thread does not hold the lock
+      OfxStatus mutexUnLock(const OfxMutexHandle mutex);
+
+      /// @see OfxMultiThreadSuiteV1.mutexTryLock()
+      OfxStatus mutexTryLock(const OfxMutexHandle mutex);
+
+    } // MultiThread
+
+  } // Host
+
+} // OFX
+
+#endif // OFX_MULTITHREAD_H
@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 //ofxh
 #include "ofxhPropertySuite.h"
+#include "ofxhAnimationCurve.h"
 
 
 namespace OFX {
@@ -279,16 +280,62 @@ namespace OFX {
         virtual void notify(const std::string &name, bool single, int num) OFX_EXCEPTION_SPEC;
       };
 
+      /// Keyframe access of an animatable param.
+      ///
+      /// Each keyframe param holds an AnimationCurve with one dimension per value, which a
+      /// host may use to store its keys. A host opts in with setUsesAnimationCurve, then keys
+      /// the curve from its set(time, ...) with setKeyValues and evaluates it in its
+      /// get(time, ...) with getKeyedValues, see the hostDemo param instances. The default
+      /// keyframe functions answer from the curve once the host has opted in, and return
+      /// kOfxStatErrMissingHostFeature before. The default derive and integrate of the typed
+      /// instances use the curve when it has keys, and are otherwise approximated from
+      /// get(time, ...), so hosts that keep keys of their own only need to override the
+      /// keyframe functions here.
       class KeyframeParam {
       public:
+        explicit KeyframeParam(int nDimensions = 1,
+                               AnimationCurve::Interpolation interpolation = AnimationCurve::eInterpolationSmooth)
+          : _curve(nDimensions, interpolation)
+          , _usesCurve(false)
+        {}
+
         virtual OfxStatus getNumKeys(unsigned int &nKeys) const ;
         virtual OfxStatus getKeyTime(int nth, OfxTime& time) const ;
         virtual OfxStatus getKeyIndex(OfxTime time, int direction, int & index) const ;
         virtual OfxStatus deleteKey(OfxTime time) ;
         virtual OfxStatus deleteAllKeys() ;
 
+        /// the built in curve of the param
+        AnimationCurve &getAnimationCurve() { return _curve; }
+        const AnimationCurve &getAnimationCurve() const { return _curve; }
+
+        /// whether the host keeps the keys of the param in the built in curve
+        bool usesAnimationCurve() const { return _usesCurve; }
+        void setUsesAnimationCurve(bool usesCurve) { _usesCurve = usesCurve; }
+
         virtual ~KeyframeParam() {
         }
+
+      protected :
+        /// value of the param at a time as doubles, one per dimension of the curve, used to
+        /// approximate derivatives and integrals when the curve has no keys
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
+
+        /// derivative of the curve, or a centred difference over a frame of getValueAtTime
+        OfxStatus deriveCurve(OfxTime time, double *values);
+
+        /// integral of the curve, or Simpson's rule over half frames of getValueAtTime
+        OfxStatus integrateCurve(OfxTime time1, OfxTime time2, double *values);
+
+        /// key the curve at a time, one value per dimension, for a host's set(time, ...)
+        OfxStatus setKeyValues(OfxTime time, const double *values);
+
+        /// value of the curve at a time for a host's get(time, ...), false if the host does
+        /// not use the curve or it has no keys, in which case the param is not animated
+        bool getKeyedValues(OfxTime time, double *values) const;
+
+        AnimationCurve _curve;
+        bool           _usesCurve;
       };
 
       class GroupInstance : public Instance {
@@ -317,7 +364,7 @@ namespace OFX {
 
       class IntegerInstance : public Instance, public KeyframeParam {
       public:
-        IntegerInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        IntegerInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(1) {}
 
         // Deriving implementatation needs to overide these 
         virtual OfxStatus get(int&) = 0;
@@ -325,7 +372,7 @@ namespace OFX {
         virtual OfxStatus set(int) = 0;
         virtual OfxStatus set(OfxTime time, int) = 0;
 
-        // probably derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, int&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, int&) ;
 
@@ -346,6 +393,10 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class ChoiceInstance : public Instance, public KeyframeParam {
@@ -379,15 +430,17 @@ namespace OFX {
 
       class DoubleInstance : public Instance, public KeyframeParam {
       public:
-        DoubleInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        DoubleInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(1) {}
 
         // Deriving implementatation needs to overide these 
         virtual OfxStatus get(double&) = 0;
         virtual OfxStatus get(OfxTime time, double&) = 0;
         virtual OfxStatus set(double) = 0;
         virtual OfxStatus set(OfxTime time, double) = 0;
-        virtual OfxStatus derive(OfxTime time, double&) = 0;
-        virtual OfxStatus integrate(OfxTime time1, OfxTime time2, double&) = 0;
+
+        // derived class does not need to implement, default uses the animation curve
+        virtual OfxStatus derive(OfxTime time, double&) ;
+        virtual OfxStatus integrate(OfxTime time1, OfxTime time2, double&) ;
 
         /// implementation of var args function
         virtual OfxStatus getV(va_list arg);
@@ -406,11 +459,15 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class BooleanInstance : public Instance, public KeyframeParam {
       public:
-        BooleanInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        BooleanInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(1, AnimationCurve::eInterpolationConstant) {}
 
         // Deriving implementatation needs to overide these
         virtual OfxStatus get(bool&) = 0;
@@ -433,7 +490,7 @@ namespace OFX {
 
       class RGBAInstance : public Instance, public KeyframeParam {
       public:
-        RGBAInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        RGBAInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(4) {}
 
         // Deriving implementatation needs to overide these
         virtual OfxStatus get(double&,double&,double&,double&) = 0;
@@ -441,7 +498,7 @@ namespace OFX {
         virtual OfxStatus set(double,double,double,double) = 0;
         virtual OfxStatus set(OfxTime time, double,double,double,double) = 0;
 
-        // derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, double&,double&,double&,double&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, double&,double&,double&,double&) ;
 
@@ -462,11 +519,15 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class RGBInstance : public Instance, public KeyframeParam {
       public:
-        RGBInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        RGBInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(3) {}
 
         // Deriving implementatation needs to overide these
         virtual OfxStatus get(double&,double&,double&) = 0;
@@ -474,7 +535,7 @@ namespace OFX {
         virtual OfxStatus set(double,double,double) = 0;
         virtual OfxStatus set(OfxTime time, double,double,double) = 0;
 
-        // derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, double&,double&,double&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, double&,double&,double&) ;
 
@@ -495,11 +556,15 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
         
       class Double2DInstance : public Instance, public KeyframeParam {
       public:
-        Double2DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        Double2DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(2) {}
 
         // Deriving implementatation needs to overide these
         virtual OfxStatus get(double&,double&) = 0;
@@ -507,7 +572,7 @@ namespace OFX {
         virtual OfxStatus set(double,double) = 0;
         virtual OfxStatus set(OfxTime time, double,double) = 0;
 
-        // derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, double&,double&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, double&,double&) ;
 
@@ -528,11 +593,15 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class Integer2DInstance : public Instance, public KeyframeParam {
       public:
-        Integer2DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        Integer2DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(2) {}
 
         // Deriving implementatation needs to overide these
         virtual OfxStatus get(int&,int&) = 0;
@@ -540,7 +609,7 @@ namespace OFX {
         virtual OfxStatus set(int,int) = 0;
         virtual OfxStatus set(OfxTime time, int,int) = 0;
 
-        // derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, int&,int&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, int&,int&) ;
 
@@ -561,11 +630,15 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class Double3DInstance : public Instance , public KeyframeParam{
       public:
-        Double3DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        Double3DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(3) {}
 
         // Deriving implementatation needs to overide these
         virtual OfxStatus get(double&,double&,double&)  = 0;
@@ -573,7 +646,7 @@ namespace OFX {
         virtual OfxStatus set(double,double,double)  = 0;
         virtual OfxStatus set(OfxTime time, double,double,double)  = 0;
 
-        // derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, double&,double&,double&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, double&,double&,double&) ;
 
@@ -594,18 +667,22 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class Integer3DInstance : public Instance, public KeyframeParam {
       public:
-        Integer3DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        Integer3DInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(3) {}
 
         virtual OfxStatus get(int&,int&,int&) = 0;
         virtual OfxStatus get(OfxTime time, int&,int&,int&) = 0;
         virtual OfxStatus set(int,int,int) = 0;
         virtual OfxStatus set(OfxTime time, int,int,int) = 0;
 
-        // derived class does not need to implement, default is an approximation
+        // derived class does not need to implement, default uses the animation curve
         virtual OfxStatus derive(OfxTime time, int&,int&,int&) ;
         virtual OfxStatus integrate(OfxTime time1, OfxTime time2, int&,int&,int&) ;
 
@@ -626,12 +703,16 @@ namespace OFX {
 
         /// implementation of var args function
         virtual OfxStatus integrateV(OfxTime time1, OfxTime time2, va_list arg);
+
+      protected :
+        /// overridden from KeyframeParam
+        virtual OfxStatus getValueAtTime(OfxTime time, double *values);
       };
 
       class StringInstance : public Instance, public KeyframeParam {
         std::string _returnValue; ///< location to hold temporary return value. Should delegate this to implementation!!!
       public:
-        StringInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        StringInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(0) {}
 
         virtual OfxStatus get(std::string &) = 0;
         virtual OfxStatus get(OfxTime time, std::string &) = 0;
@@ -662,7 +743,7 @@ namespace OFX {
 
       class PushbuttonInstance : public Instance, public KeyframeParam {
       public:
-        PushbuttonInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance) {}
+        PushbuttonInstance(Descriptor& descriptor, Param::SetInstance* instance = 0) : Instance(descriptor,instance), KeyframeParam(0) {}
       };
 
       /// A set of parameters
@@ -75,6 +75,11 @@ namespace OFX
         
         virtual void loadFromPlugin(Plugin *) const = 0;
 
+        /// called instead of loadFromPlugin by a lazy scan, see PluginCache::setLazyDescribe.
+        /// The default loads the plugin straight away; apis that can describe a plugin on
+        /// first use mark it with Plugin::setDescribePending instead.
+        virtual void deferLoadFromPlugin(Plugin *p) const { loadFromPlugin(p); }
+
         virtual void unloadPlugin(Plugin *) const = 0;
 
         /// factory method, to create a new plugin (from binary)
@@ -92,6 +97,11 @@ namespace OFX
         
         virtual void saveXML(Plugin *, std::ostream &) const = 0;
 
+        /// the property set the binary cache keeps for a plugin, this must hold all the
+        /// state saveXML writes. The default returns NULL, meaning plugins of this api
+        /// can only be cached as XML.
+        virtual Property::Set *getCacheProperties(Plugin *) const { return 0; }
+
         virtual void confirmPlugin(Plugin *, const std::list<std::string>& pluginPath) = 0;
 
         virtual bool pluginSupported(Plugin *, std::string &reason) const = 0;
@@ -102,6 +112,9 @@ namespace OFX
       /// helper function to build a property set from XML. Really should be a member of the property set!!!
       void propertySetXMLRead(const std::string &el, std::map<std::string, std::string> map, Property::Set &set, Property::Property*&);
 
+      /// helper function to fetch a property read from a cache from a set, adding it if it is not there yet.
+      Property::Property *propertySetDefine(Property::Set &set, const std::string &name, Property::TypeEnum type, int dimension);
+
       /// helper function to write a property set to XML. Really should be a member of the property set!!!
       void propertySetXMLWrite(std::ostream &o, const Property::Set &set, int indent=0);
 
@@ -35,6 +35,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <list>
 #include <set>
 #include <iostream>
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
 
 #include <stdio.h>
 
@@ -152,6 +155,11 @@ namespace OFX {
     protected :
       PluginBinary *_binary; ///< the file I live inside
       int           _index;  ///< where I live inside that file
+#if __cplusplus >= 201103L
+      std::atomic<bool> _describePending; ///< describe was deferred by a lazy scan, see PluginCache::setLazyDescribe
+#else
+      bool          _describePending; ///< describe was deferred by a lazy scan, see PluginCache::setLazyDescribe
+#endif
     public :
       Plugin();
 
@@ -171,7 +179,7 @@ namespace OFX {
       }
 
       /// construct this based on the struct returned by the getNthPlugin() in the binary
-      Plugin(PluginBinary *bin, int idx, OfxPlugin *o) : PluginDesc(o), _binary(bin), _index(idx)
+      Plugin(PluginBinary *bin, int idx, OfxPlugin *o) : PluginDesc(o), _binary(bin), _index(idx), _describePending(false)
       {
       }
       
@@ -183,12 +191,24 @@ namespace OFX {
         : PluginDesc(api, apiVersion, identifier, rawIdentifier, majorVersion, minorVersion)
         , _binary(bin)
         , _index(idx) 
+        , _describePending(false)
       {
       }
 
       virtual ~Plugin() {
       }
 
+      /// has the describe action not been run yet, and is it to be run when the plugin is first used?
+      bool isDescribePending() const
+      {
+        return _describePending;
+      }
+
+      void setDescribePending(bool pending)
+      {
+        _describePending = pending;
+      }
+
       virtual APICache::PluginAPICacheI &getApiHandler() = 0;
 
       bool trumps(Plugin *other) {
@@ -243,6 +263,7 @@ namespace OFX {
       off_t _fileSize;                ///< file size last time we check, used for caching
       bool _binaryChanged;            ///< whether the timestamp/filesize in this cache is different from that in the actual binary
       bool _binaryInvalid;            ///< whether we could open and stat the binary or not
+      bool _ownsBinaryRef;            ///< loadPluginInfo() took a reference on _binary, dropped by releaseBinary() or the dtor
 
     public :
 
@@ -258,6 +279,7 @@ namespace OFX {
         , _fileSize(size)
         , _binaryChanged(false)
         , _binaryInvalid(false)
+        , _ownsBinaryRef(false)
       {
         if (isInvalid()) {
           _binaryInvalid = true;
@@ -279,6 +301,7 @@ namespace OFX {
         , _bundlePath(bundlePath)
         , _binaryChanged(false)
         , _binaryInvalid(false)
+        , _ownsBinaryRef(false)
       {
         if (_binary->isInvalid()) {
           _binaryInvalid = true;
@@ -304,6 +327,7 @@ namespace OFX {
       , _fileSize()
       , _binaryChanged(true)
       , _binaryInvalid(false)
+      , _ownsBinaryRef(false)
       {
         _binaryInvalid = !Binary::getFileModTimeAndSize(hostAppBinFilePath, _fileModificationTime, _fileSize);
         if (cachedHostAppBinFilePath && cachedFileModificationTime && cachedFileSize) {
@@ -360,6 +384,10 @@ namespace OFX {
 
       void loadPluginInfo(PluginCache *);
 
+      /// drop the reference loadPluginInfo() took on the binary, so that it stays unloaded
+      /// until a PluginHandle needs it
+      void releaseBinary();
+
       /// how many plugins?
       int getNPlugins() const {return (int)_plugins.size(); }
 
@@ -434,11 +462,47 @@ namespace OFX {
 
       void scanDirectory(std::set<std::string> &foundBinFiles, const std::string &dir, bool recurse);
 
+      /// scan all of _pluginPath, listing directories and loading new binaries in parallel
+      void scanDirectoriesParallel(std::set<std::string> &foundBinFiles);
+
+      /// path of the binary in a bundle found in dir, bundlename is set to the bundle path
+      std::string bundleBinaryPath(const std::string &dir, const std::string &name, std::string &bundlename) const;
+
+      /// open a binary that was not in the cache and make its plugins
+      PluginBinary *probeBinary(const std::string &binpath, const std::string &bundlename);
+
+      /// run the describe action of a plugin, or defer it if _lazyDescribe is set
+      void describePlugin(Plugin *plug);
+
+      /// run the describe actions of the plugins of a binary
+      void describeBinary(PluginBinary *pb);
+
+      /// work item of scanDirectoriesParallel, probes and describes a binary
+      static void probeBinaryThread(unsigned int threadIndex, unsigned int threadMax, void *arg);
+
+      /// make a binary read from the cache and add it to our binaries, returns NULL if the cache is to be ignored
+      PluginBinary *addCachedBinary(bool isStaticBinary, const std::string &fname, const std::string &bname, time_t mtime, off_t size);
+
+      /// make a plugin read from the cache and add it to its binary, returns NULL if the api is not handled
+      Plugin *addCachedPlugin(PluginBinary *pb, const std::string &api, int apiVersion, const std::string &rawIdentifier,
+                              int index, int majorVersion, int minorVersion, bool describePending);
+
+      /// populate the cache from a buffer holding either an XML or a binary cache
+      void readCache(const char *data, size_t size);
+
+      /// populate the cache from a buffer holding an XML cache
+      void readXMLCache(const char *data, size_t size);
+
+      /// populate the cache from a buffer holding a binary cache, see writeBinaryPluginCache
+      void readBinaryCache(const char *data, size_t size);
+
       bool _ignoreCache;
       std::string _cacheVersion;
 
       bool _dirty;
       bool _enablePluginSeek;       ///< Turn off to make all seekPluginFile() calls return an empty string
+      bool _parallelScan;           ///< Turn on to make scanPluginFiles() work on several threads
+      bool _lazyDescribe;           ///< Turn on to make scanPluginFiles() defer the describe actions
 
       static bool _useStdOFXPluginsLocation;
       static PluginCache* gPluginCachePtr; ///< singleton plugin cache
@@ -506,8 +570,14 @@ namespace OFX {
       }
 
       // populate the cache.  must call scanPluginFiles() after to check for changes.
+      // The stream may hold either an XML or a binary cache.
       void readCache(std::istream &is);
 
+      /// populate the cache from a file, which is memory mapped rather than read.
+      /// The file may hold either an XML or a binary cache. Returns false if the
+      /// file could not be opened, throws std::runtime_error if it is corrupt.
+      bool readCache(const std::string &fileName);
+
       // seek a particular file on the OFX plugin path
       std::string seekPluginFile(const std::string &baseName) const;
       
@@ -515,11 +585,34 @@ namespace OFX {
       /// Enable (the default): normal operation; disable: returns an empty string instead
       void setPluginSeekEnabled(bool enabled) { _enablePluginSeek = enabled; }
 
+      /// Sets whether scanPluginFiles() works in parallel, off by default.
+      /// When on, directories are listed and the binaries that were not in the cache are
+      /// loaded and described on the threads of the host multithread pool (see
+      /// ofxhMultiThread.h). Host::makeDescriptor and Host::loadingStatus are then called
+      /// from several threads at once, for different binaries. The cache ends up the same
+      /// as with a serial scan.
+      void setParallelScan(bool enabled) { _parallelScan = enabled; }
+
+      /// Sets whether scanPluginFiles() describes new plugins lazily, off by default.
+      /// When on, binaries that were not in the cache (or have changed) are only opened to
+      /// read the identifier and version of their plugins, then unloaded again. The load and
+      /// describe actions are run when the plugin is first used, e.g. by
+      /// ImageEffectPlugin::getContexts() or createInstance(), which loads the binary again.
+      /// Plugins that have not been described when the cache is written are saved as such,
+      /// and are described on first use by whichever session reads that cache.
+      void setLazyDescribe(bool enabled) { _lazyDescribe = enabled; }
+
       /// scan for plugins
       void scanPluginFiles();
 
       // write the plugin cache output file to the given stream
       void writePluginCache(std::ostream &os) const;
+
+      /// write the plugin cache in binary form, which is much faster to read back than the XML
+      /// one, see readCache. The binary form is native endian and only meant to be read by the
+      /// same build of the host. Returns false, having written nothing, if the cache holds plugins
+      /// of an api that cannot be cached as binary (see PluginAPICacheI::getCacheProperties).
+      bool writeBinaryPluginCache(std::ostream &os) const;
       
       // callback function for the XML
       void elementBeginCallback(void *userData, const XML_Char *name, const XML_Char **attrs);
@@ -35,6 +35,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 #include <algorithm>
 #include <sstream> // stringstream
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
 
 #ifndef WINDOWS
 #if __cplusplus < 201103L
@@ -391,6 +394,44 @@ namespace OFX {
       /// A std::map of properties by name
       typedef std::map<std::string, Property *> PropertyMap;
 
+      /// Open addressing hash table from property names to the properties of a Set.
+      ///
+      /// This is what Set uses to look properties up, PropertyMap is only kept for
+      /// ownership and ordered iteration. Keys point at the property's own name, so
+      /// they live as long as the property. A lookup hashes the C string it is given
+      /// and only compares strings on a hash match, comparing pointers first, so no
+      /// std::string is built. Lookups do not modify the table and are safe to make
+      /// from several threads at once.
+      class PropertyIndex {
+      public :
+        PropertyIndex();
+
+        /// add a property, replacing any property of the same name
+        void insert(Property *prop);
+
+        /// find a property by name, returns NULL if it is not there
+        Property *find(const char *name) const;
+
+        /// remove everything
+        void clear();
+
+        /// hash function used on names
+        static unsigned int hash(const char *name);
+
+      private :
+        struct Entry {
+          unsigned int hash;
+          const char  *name;
+          Property    *prop;
+        };
+
+        /// double the size of the table and rehash everything
+        void grow();
+
+        std::vector<Entry> _entries; ///< size is zero or a power of two
+        size_t             _count;   ///< number of entries in use
+      };
+
 
       //................................................................................
       /// Class that holds a set of properties and manipulates them
@@ -403,6 +444,7 @@ namespace OFX {
 
       protected :
         PropertyMap _props; ///< Our properties.
+        PropertyIndex _index; ///< Hash index on _props, used for lookups
 
         /// chained property set, which is read only
         /// these are searched on a get if not found 
@@ -413,22 +455,22 @@ namespace OFX {
         void operator=(const Set &);
 
         /// set a particular property
-        template<class T> void setProperty(const std::string &property, int index, const typename T::Type &value);
+        template<class T> void setProperty(const char *property, int index, const typename T::Type &value);
 
         /// set the first N of a particular property
-        template<class T> void setPropertyN(const std::string &property, int count, const typename T::APIType *value);
+        template<class T> void setPropertyN(const char *property, int count, const typename T::APIType *value);
 
         /// get a particular property
-        template<class T> typename T::ReturnType getProperty(const std::string &property, int index)  const;
+        template<class T> typename T::ReturnType getProperty(const char *property, int index)  const;
 
         /// get the first N of a particular property
-        template<class T> void getPropertyN(const std::string &property, int index, typename T::APIType *v)  const;
+        template<class T> void getPropertyN(const char *property, int index, typename T::APIType *v)  const;
 
         /// get a particular property without going through any getHook
-        template<class T> typename T::ReturnType getPropertyRaw(const std::string &property, int index)  const;
+        template<class T> typename T::ReturnType getPropertyRaw(const char *property, int index)  const;
 
         /// get a particular property without going through any getHook
-        template<class T> void getPropertyRawN(const std::string &property, int count, typename T::APIType *v)  const;
+        template<class T> void getPropertyRawN(const char *property, int count, typename T::APIType *v)  const;
 
       public :
         /// take an array of of PropSpecs (which must be terminated with an entry in which
@@ -472,13 +514,26 @@ namespace OFX {
                 
         /// Fetchs a pointer to a property of the given name, following the property chain if the
         /// 'followChain' arg is not false.
-        Property *fetchProperty(const std::string &name, bool followChain = false) const;
+        Property *fetchProperty(const char *name, bool followChain = false) const;
+
+        /// Fetchs a pointer to a property of the given name, following the property chain if the
+        /// 'followChain' arg is not false.
+        Property *fetchProperty(const std::string &name, bool followChain = false) const
+        {
+          return fetchProperty(name.c_str(), followChain);
+        }
 
         /// get property with the particular name and type.  if the property is 
         /// missing or is of the wrong type, return an error status.  if this is a sloppy
         /// property set and the property is missing, a new one will be created of the right
         /// type
-        template<class T> bool fetchTypedProperty(const std::string &name, T *&prop, bool followChain = false) const;
+        template<class T> bool fetchTypedProperty(const char *name, T *&prop, bool followChain = false) const;
+
+        /// get property with the particular name and type, see above
+        template<class T> bool fetchTypedProperty(const std::string &name, T *&prop, bool followChain = false) const
+        {
+          return fetchTypedProperty(name.c_str(), prop, followChain);
+        }
 
         /// retrieve the nameed string property
         String *fetchStringProperty(const std::string &name,  bool followChain = false) const;
@@ -495,59 +550,76 @@ namespace OFX {
 
 
         /// get a particular int property without fetching via a get hook, useful for notifies
-        int getIntPropertyRaw(const std::string &property, int index = 0) const;
+        int getIntPropertyRaw(const char *property, int index = 0) const;
+        int getIntPropertyRaw(const std::string &property, int index = 0) const { return getIntPropertyRaw(property.c_str(), index); }
         
         /// get a particular double property without fetching via a get hook, useful for notifies
-        double getDoublePropertyRaw(const std::string &property, int index = 0) const;
+        double getDoublePropertyRaw(const char *property, int index = 0) const;
+        double getDoublePropertyRaw(const std::string &property, int index = 0) const { return getDoublePropertyRaw(property.c_str(), index); }
 
         /// get a particular pointer property without fetching via a get hook, useful for notifies
-        void *getPointerPropertyRaw(const std::string &property, int index = 0) const;
+        void *getPointerPropertyRaw(const char *property, int index = 0) const;
+        void *getPointerPropertyRaw(const std::string &property, int index = 0) const { return getPointerPropertyRaw(property.c_str(), index); }
 
         /// get a particular string property
-        const std::string &getStringPropertyRaw(const std::string &property, int index = 0) const;
+        const std::string &getStringPropertyRaw(const char *property, int index = 0) const;
+        const std::string &getStringPropertyRaw(const std::string &property, int index = 0) const { return getStringPropertyRaw(property.c_str(), index); }
                 
         /// get the value of a particular string property
-        const std::string &getStringProperty(const std::string &property, int index = 0) const;
+        const std::string &getStringProperty(const char *property, int index = 0) const;
+        const std::string &getStringProperty(const std::string &property, int index = 0) const { return getStringProperty(property.c_str(), index); }
         
         /// get the value of a particular int property
-        int getIntProperty(const std::string &property, int index = 0) const;
+        int getIntProperty(const char *property, int index = 0) const;
+        int getIntProperty(const std::string &property, int index = 0) const { return getIntProperty(property.c_str(), index); }
         
         /// get the value of a particular double property
-        void getIntPropertyN(const std::string &property,  int *v, int N) const;
+        void getIntPropertyN(const char *property, int *v, int N) const;
+        void getIntPropertyN(const std::string &property, int *v, int N) const { getIntPropertyN(property.c_str(), v, N); }
 
         /// get the value of a particular double property
-        double getDoubleProperty(const std::string &property, int index = 0) const;
+        double getDoubleProperty(const char *property, int index = 0) const;
+        double getDoubleProperty(const std::string &property, int index = 0) const { return getDoubleProperty(property.c_str(), index); }
 
         /// get the value of a particular double property
-        void getDoublePropertyN(const std::string &property,  double *v, int N) const;
+        void getDoublePropertyN(const char *property, double *v, int N) const;
+        void getDoublePropertyN(const std::string &property, double *v, int N) const { getDoublePropertyN(property.c_str(), v, N); }
 
         /// get the value of a particular pointer property
-        void *getPointerProperty(const std::string &property, int index = 0) const;
+        void *getPointerProperty(const char *property, int index = 0) const;
+        void *getPointerProperty(const std::string &property, int index = 0) const { return getPointerProperty(property.c_str(), index); }
 
 
 
         /// set a particular string property without fetching via a get hook, useful for notifies
-        void setStringProperty(const std::string &property, const std::string &value, int index = 0);
+        void setStringProperty(const char *property, const std::string &value, int index = 0);
+        void setStringProperty(const std::string &property, const std::string &value, int index = 0) { setStringProperty(property.c_str(), value, index); }
 
         /// get a particular int property
-        void setIntProperty(const std::string &property, int v, int index = 0);
+        void setIntProperty(const char *property, int v, int index = 0);
+        void setIntProperty(const std::string &property, int v, int index = 0) { setIntProperty(property.c_str(), v, index); }
 
         /// get a particular double property
-        void setIntPropertyN(const std::string &property, const int *v, int N);
+        void setIntPropertyN(const char *property, const int *v, int N);
+        void setIntPropertyN(const std::string &property, const int *v, int N) { setIntPropertyN(property.c_str(), v, N); }
         
         /// get a particular double property
-        void setDoubleProperty(const std::string &property, double v, int index = 0);
+        void setDoubleProperty(const char *property, double v, int index = 0);
+        void setDoubleProperty(const std::string &property, double v, int index = 0) { setDoubleProperty(property.c_str(), v, index); }
 
         /// get a particular double property
-        void setDoublePropertyN(const std::string &property, const double *v, int N);
+        void setDoublePropertyN(const char *property, const double *v, int N);
+        void setDoublePropertyN(const std::string &property, const double *v, int N) { setDoublePropertyN(property.c_str(), v, N); }
 
         /// get a particular double property
-        void setPointerProperty(const std::string &property,  void *v, int index = 0);
+        void setPointerProperty(const char *property, void *v, int index = 0);
+        void setPointerProperty(const std::string &property, void *v, int index = 0) { setPointerProperty(property.c_str(), v, index); }
         
 
 
         /// get the dimension of a particular property
-        int getDimension(const std::string &property) const;
+        int getDimension(const char *property) const;
+        int getDimension(const std::string &property) const { return getDimension(property.c_str()); }
 
         /// is the given string one of the values of a multi-dimensional string prop
         /// this returns a non negative index if it is found, otherwise, -1
@@ -565,9 +637,69 @@ namespace OFX {
         bool verifyMagic() { return _magic == kMagic; }
       };
 
+      /// A Set made from an array of PropSpecs the first time it is needed, then reused
+      /// for every call of an action, so that passing arguments to a plugin does not
+      /// allocate. The set is used through a ReusableSet::Lease, which resets all of its
+      /// properties to their defaults. If the set is already leased, e.g. by a call on
+      /// another thread, the lease makes a temporary set from the specs instead.
+      class ReusableSet {
+      public :
+        ReusableSet();
+
+        ~ReusableSet();
+
+        /// Gives a reset set for the duration of an action
+        class Lease {
+        public :
+          /// spec is used when a set has to be made, it must be the same on every
+          /// lease of a given ReusableSet
+          Lease(ReusableSet &owner, const PropSpec *spec);
+
+          ~Lease();
+
+          Set &operator*() const { return *_set; }
+          Set *operator->() const { return _set; }
+          Set *get() const { return _set; }
+
+          /// is the set new, rather than reused? The caller then adds the properties
+          /// the specs cannot describe, such as the per clip ones.
+          bool isFresh() const { return _fresh; }
+
+          /// properties the caller added to a fresh set, kept with the set so that
+          /// later leases get them in the same order without looking them up by name
+          std::vector<Property *> &getExtraProperties() const { return *_extra; }
+
+        private :
+          ReusableSet             &_owner;
+          Set                     *_set;
+          std::vector<Property *> *_extra;
+          std::vector<Property *>  _temporaryExtra;
+          bool                     _fresh;
+          bool                     _temporary;
+
+          Lease(const Lease &);
+          void operator=(const Lease &);
+        };
+
+      private :
+        Set                     *_set;   ///< made by the first lease
+        std::vector<Property *>  _extra;
+#if __cplusplus >= 201103L
+        std::atomic<bool>        _leased;
+#else
+        bool                     _leased;
+#endif
+
+        ReusableSet(const ReusableSet &);
+        void operator=(const ReusableSet &);
+      };
+
       
       /// return the OFX function suite that manages properties
       const void *GetSuite(int version);
+
+      /// return the OFX function suite that gets and sets several properties at once
+      const void *GetBatchSuite(int version);
     }
   }
 }
@@ -0,0 +1,196 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#ifndef OFX_TILE_SCHEDULER_H
+#define OFX_TILE_SCHEDULER_H
+
+#include <stddef.h>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ofxCore.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace ImageEffect {
+
+      // forward declarations
+      class ClipInstance;
+      class Instance;
+
+      /// a piece of a render window, with the regions of the inputs needed to render it
+      struct RenderTile {
+        OfxRectI                            renderWindow; ///< in pixels
+        std::map<ClipInstance *, OfxRectD>  rois;         ///< per input clip, in canonical coordinates
+      };
+
+      /// Renders a window of an effect instance as a set of tiles run on the thread pool.
+      ///
+      /// The window is cut into bands of whole rows, each holding about getTileBytes() of
+      /// output pixels so that a tile stays in the cache while it is rendered, or into tiles
+      /// of a fixed size set with setTileSize(). The regions of interest of each tile are
+      /// computed with Instance::getRegionOfInterestAction on the calling thread, then the
+      /// tiles are rendered with the multithread suite, each thread taking the next tile
+      /// when it is done with its last one.
+      ///
+      /// Effects that do not support tiles (kOfxImageEffectPropSupportsTiles unset on the
+      /// effect or on one of its clips) are rendered as one tile covering the window, as are
+      /// OpenGL renders. The tiles of effects that are not fully render thread safe, or that
+      /// require sequential render, are rendered one after the other on the calling thread.
+      ///
+      /// The host's output clip must hand the same image to all the tiles of a render, and
+      /// for fully thread safe effects getImage may be called from several threads at once.
+      class TileScheduler {
+      public :
+        /// make a scheduler for the given instance, which must outlive it
+        explicit TileScheduler(Instance &instance);
+
+        virtual ~TileScheduler();
+
+        /// set the number of bytes of output pixels in a band, 0 for the default of 256KB
+        void setTileBytes(size_t nBytes);
+
+        /// get the number of bytes of output pixels in a band
+        size_t getTileBytes() const;
+
+        /// cut the window into tiles of this size rather than bands, 0 to go back to bands
+        void setTileSize(int width, int height);
+
+        /// set the most threads a render may use, 0 (the default) for as many as the
+        /// multithread suite has
+        void setMaxThreads(unsigned int nThreads);
+
+        /// does the effect render tiles, rather than a full window in one go?
+        bool rendersTiles() const;
+
+        /// the number of threads the tiles of a render would be spread over
+        unsigned int getThreadCount(size_t nTiles) const;
+
+        /// cut a render window into tiles, without their regions of interest
+        void makeTiles(const OfxRectI &renderWindow, std::vector<RenderTile> &tiles) const;
+
+        /// render a window, the arguments are those of Instance::renderAction.
+        /// Returns the status of the first tile that failed, the remaining tiles are not
+        /// rendered, or kOfxStatOK. A scheduler runs one render at a time.
+        OfxStatus render(OfxTime      time,
+                         const std::string &field,
+                         const OfxRectI &renderWindow,
+                         OfxPointD   renderScale,
+                         bool     sequentialRender,
+                         bool     interactiveRender,
+#                      ifdef OFX_SUPPORTS_OPENGLRENDER
+                         bool     openGLRender,
+#                       ifdef OFX_EXTENSIONS_NATRON
+                         void*    contextData,
+#                       endif
+#                      endif
+                         bool     draftRender
+#                      if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+                         ,
+                         int view
+#                      endif
+#                      ifdef OFX_EXTENSIONS_VEGAS
+                         ,
+                         int nViews
+#                      endif
+#                      ifdef OFX_EXTENSIONS_NUKE
+                         ,
+                         const std::list<std::string>& planes
+#                      endif
+                         );
+
+        /// the tiles of the last render
+        const std::vector<RenderTile> &getTiles() const { return _tiles; }
+
+      protected :
+        /// render one tile, this calls Instance::renderAction. Override it to prepare the
+        /// inputs of the tile from tile.rois first. Called from several threads at once for
+        /// fully thread safe effects.
+        virtual OfxStatus renderTile(const RenderTile &tile);
+
+        Instance                &_instance;
+
+      private :
+        /// the arguments of the render in progress
+        struct RenderArgs {
+          OfxTime                   time;
+          const std::string        *field;
+          OfxPointD                 renderScale;
+          bool                      sequentialRender;
+          bool                      interactiveRender;
+#       ifdef OFX_SUPPORTS_OPENGLRENDER
+          bool                      openGLRender;
+#        ifdef OFX_EXTENSIONS_NATRON
+          void                     *contextData;
+#        endif
+#       endif
+          bool                      draftRender;
+#       if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+          int                       view;
+#       endif
+#       ifdef OFX_EXTENSIONS_VEGAS
+          int                       nViews;
+#       endif
+#       ifdef OFX_EXTENSIONS_NUKE
+          const std::list<std::string> *planes;
+#       endif
+        };
+
+        /// the multithread suite function rendering tiles
+        static void renderTiles(unsigned int threadIndex, unsigned int threadMax, void *arg);
+
+        /// bytes of one pixel of the output clip
+        size_t getOutputPixelBytes() const;
+
+        // not copyable
+        TileScheduler(const TileScheduler &);
+        TileScheduler &operator=(const TileScheduler &);
+
+        size_t                   _tileBytes;
+        int                      _tileWidth;
+        int                      _tileHeight;
+        unsigned int             _maxThreads;
+        std::vector<RenderTile>  _tiles;
+        RenderArgs               _args;
+      };
+
+    } // ImageEffect
+
+  } // Host
+
+} // OFX
+
+#endif // OFX_TILE_SCHEDULER_H
@@ -0,0 +1,324 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <algorithm>
+
+// ofx
+#include "ofxCore.h"
+
+// ofx host
+#include "ofxhAnimationCurve.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace Param {
+
+      AnimationCurve::AnimationCurve(int nDimensions, Interpolation interpolation)
+        : _nDimensions(nDimensions)
+        , _interpolation(interpolation)
+        , _lastSegment(0)
+      {
+      }
+
+      AnimationCurve::AnimationCurve(const AnimationCurve &other)
+        : _nDimensions(other._nDimensions)
+        , _interpolation(other._interpolation)
+        , _times(other._times)
+        , _values(other._values)
+        , _interpolations(other._interpolations)
+        , _coefficients(other._coefficients)
+        , _integrals(other._integrals)
+        , _lastSegment(0)
+      {
+      }
+
+      AnimationCurve &AnimationCurve::operator=(const AnimationCurve &other)
+      {
+        _nDimensions = other._nDimensions;
+        _interpolation = other._interpolation;
+        _times = other._times;
+        _values = other._values;
+        _interpolations = other._interpolations;
+        _coefficients = other._coefficients;
+        _integrals = other._integrals;
+        _lastSegment = 0;
+        return *this;
+      }
+
+      void AnimationCurve::setDimension(int nDimensions)
+      {
+        deleteAllKeys();
+        _nDimensions = nDimensions;
+      }
+
+      void AnimationCurve::setKeyInterpolation(int nth, Interpolation interpolation)
+      {
+        _interpolations[nth] = (char) interpolation;
+        updateSegments(nth, nth);
+      }
+
+      int AnimationCurve::getKeyIndex(OfxTime time, int direction) const
+      {
+        std::vector<OfxTime>::const_iterator i;
+        if(direction == 0) {
+          i = std::lower_bound(_times.begin(), _times.end(), time);
+          if(i == _times.end() || *i != time)
+            return -1;
+        }
+        else if(direction < 0) {
+          i = std::lower_bound(_times.begin(), _times.end(), time);
+          if(i == _times.begin())
+            return -1;
+          --i;
+        }
+        else {
+          i = std::upper_bound(_times.begin(), _times.end(), time);
+          if(i == _times.end())
+            return -1;
+        }
+        return (int) (i - _times.begin());
+      }
+
+      int AnimationCurve::setKey(OfxTime time, const double *values)
+      {
+        int n = (int) _times.size();
+        int i = (int) (std::lower_bound(_times.begin(), _times.end(), time) - _times.begin());
+
+        if(i < n && _times[i] == time) {
+          std::copy(values, values + _nDimensions, _values.begin() + i * _nDimensions);
+        }
+        else {
+          _times.insert(_times.begin() + i, time);
+          _values.insert(_values.begin() + i * _nDimensions, values, values + _nDimensions);
+          _interpolations.insert(_interpolations.begin() + i, (char) _interpolation);
+          _integrals.insert(_integrals.begin() + i * _nDimensions, _nDimensions, 0.);
+          ++n;
+          // the segment leading to the old key at i is split in two
+          if(n >= 2)
+            _coefficients.insert(_coefficients.begin() + std::min(i, n - 2) * 4 * _nDimensions, 4 * _nDimensions, 0.);
+        }
+
+        // tangents depend on the neighbouring keys, so two segments either side change
+        updateSegments(i - 2, i + 1);
+        return i;
+      }
+
+      bool AnimationCurve::deleteKey(OfxTime time)
+      {
+        int i = getKeyIndex(time, 0);
+        if(i < 0)
+          return false;
+
+        int n = (int) _times.size();
+        _times.erase(_times.begin() + i);
+        _values.erase(_values.begin() + i * _nDimensions, _values.begin() + (i + 1) * _nDimensions);
+        _interpolations.erase(_interpolations.begin() + i);
+        _integrals.erase(_integrals.begin() + i * _nDimensions, _integrals.begin() + (i + 1) * _nDimensions);
+        // the two segments either side of the key are merged
+        if(n >= 2) {
+          int segment = std::min(i, n - 2);
+          _coefficients.erase(_coefficients.begin() + segment * 4 * _nDimensions,
+                              _coefficients.begin() + (segment + 1) * 4 * _nDimensions);
+        }
+
+        updateSegments(i - 2, i);
+        return true;
+      }
+
+      void AnimationCurve::deleteAllKeys()
+      {
+        _times.clear();
+        _values.clear();
+        _interpolations.clear();
+        _coefficients.clear();
+        _integrals.clear();
+        _lastSegment = 0;
+      }
+
+      int AnimationCurve::findSegment(OfxTime time) const
+      {
+        int n = (int) _times.size();
+
+        // try the segment of the last evaluation and the one after it first
+        int hint = _lastSegment;
+        if(hint >= 0 && hint < n && _times[hint] <= time) {
+          if(hint + 1 == n || time < _times[hint + 1])
+            return hint;
+          if(hint + 2 == n || time < _times[hint + 2]) {
+            _lastSegment = hint + 1;
+            return hint + 1;
+          }
+        }
+
+        if(n == 0 || time < _times[0])
+          return -1;
+
+        int segment = (int) (std::upper_bound(_times.begin(), _times.end(), time) - _times.begin()) - 1;
+        _lastSegment = segment;
+        return segment;
+      }
+
+      double AnimationCurve::getTangent(int nth, int dimension) const
+      {
+        int n = (int) _times.size();
+        int previous = std::max(nth - 1, 0);
+        int next = std::min(nth + 1, n - 1);
+        if(previous == next)
+          return 0.;
+        return (_values[next * _nDimensions + dimension] - _values[previous * _nDimensions + dimension]) /
+          (_times[next] - _times[previous]);
+      }
+
+      void AnimationCurve::updateSegments(int first, int last)
+      {
+        int nSegments = (int) _times.size() - 1;
+        if(nSegments < 0)
+          return;
+
+        first = std::max(first, 0);
+        last = std::min(last, nSegments - 1);
+
+        for(int s = first; s <= last; ++s) {
+          double dt = _times[s + 1] - _times[s];
+          for(int d = 0; d < _nDimensions; ++d) {
+            double p0 = _values[s * _nDimensions + d];
+            double p1 = _values[(s + 1) * _nDimensions + d];
+            double *c = &_coefficients[(s * _nDimensions + d) * 4];
+            c[0] = p0;
+            switch(_interpolations[s]) {
+            case eInterpolationConstant :
+              c[1] = c[2] = c[3] = 0.;
+              break;
+            case eInterpolationLinear :
+              c[1] = p1 - p0;
+              c[2] = c[3] = 0.;
+              break;
+            default : {
+              // cubic Hermite, with the tangents scaled to the segment's normalised time
+              double m0 = getTangent(s, d) * dt;
+              double m1 = getTangent(s + 1, d) * dt;
+              c[1] = m0;
+              c[2] = 3. * (p1 - p0) - 2. * m0 - m1;
+              c[3] = 2. * (p0 - p1) + m0 + m1;
+            }
+            }
+          }
+        }
+
+        // running integrals, from the first segment changed to the end of the curve
+        if(first == 0)
+          std::fill(_integrals.begin(), _integrals.begin() + _nDimensions, 0.);
+        for(int s = first; s < nSegments; ++s) {
+          double dt = _times[s + 1] - _times[s];
+          for(int d = 0; d < _nDimensions; ++d) {
+            const double *c = &_coefficients[(s * _nDimensions + d) * 4];
+            _integrals[(s + 1) * _nDimensions + d] = _integrals[s * _nDimensions + d] +
+              dt * (c[0] + c[1] / 2. + c[2] / 3. + c[3] / 4.);
+          }
+        }
+      }
+
+      bool AnimationCurve::getValue(OfxTime time, double *values) const
+      {
+        int n = (int) _times.size();
+        if(n == 0)
+          return false;
+
+        int s = findSegment(time);
+        if(s < 0 || s >= n - 1) {
+          const double *key = &_values[(s < 0 ? 0 : n - 1) * _nDimensions];
+          std::copy(key, key + _nDimensions, values);
+          return true;
+        }
+
+        double u = (time - _times[s]) / (_times[s + 1] - _times[s]);
+        const double *c = &_coefficients[s * _nDimensions * 4];
+        for(int d = 0; d < _nDimensions; ++d, c += 4)
+          values[d] = c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+        return true;
+      }
+
+      bool AnimationCurve::getDerivative(OfxTime time, double *values) const
+      {
+        int n = (int) _times.size();
+        if(n == 0)
+          return false;
+
+        int s = findSegment(time);
+        if(s < 0 || s >= n - 1) {
+          std::fill(values, values + _nDimensions, 0.);
+          return true;
+        }
+
+        double dt = _times[s + 1] - _times[s];
+        double u = (time - _times[s]) / dt;
+        const double *c = &_coefficients[s * _nDimensions * 4];
+        for(int d = 0; d < _nDimensions; ++d, c += 4)
+          values[d] = (c[1] + u * (2. * c[2] + u * 3. * c[3])) / dt;
+        return true;
+      }
+
+      double AnimationCurve::getIntegralTo(OfxTime time, int segment, int dimension) const
+      {
+        int n = (int) _times.size();
+        if(segment < 0)
+          return (time - _times[0]) * _values[dimension];
+        if(segment >= n - 1)
+          return _integrals[(n - 1) * _nDimensions + dimension] +
+            (time - _times[n - 1]) * _values[(n - 1) * _nDimensions + dimension];
+
+        double dt = _times[segment + 1] - _times[segment];
+        double u = (time - _times[segment]) / dt;
+        const double *c = &_coefficients[(segment * _nDimensions + dimension) * 4];
+        return _integrals[segment * _nDimensions + dimension] +
+          dt * u * (c[0] + u * (c[1] / 2. + u * (c[2] / 3. + u * c[3] / 4.)));
+      }
+
+      bool AnimationCurve::getIntegral(OfxTime time1, OfxTime time2, double *values) const
+      {
+        if(_times.empty())
+          return false;
+
+        int s1 = findSegment(time1);
+        int s2 = findSegment(time2);
+        for(int d = 0; d < _nDimensions; ++d)
+          values[d] = getIntegralTo(time2, s2, d) - getIntegralTo(time1, s1, d);
+        return true;
+      }
+
+    }
+
+  }
+
+}
@@ -37,6 +37,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofxhPropertySuite.h"
 #include "ofxhClip.h"
 #include "ofxhImageEffect.h"
+#include "ofxhImageCache.h"
 #ifdef OFX_EXTENSIONS_VEGAS
 #include "ofxSonyVegas.h"
 #endif
@@ -280,6 +281,7 @@ namespace OFX {
         , _isOutput(desc.isOutput())
         , _pixelDepth(kOfxBitDepthNone) 
         , _components(kOfxImageComponentNone)
+        , _imageCache(NULL)
       {
         // this will add parameters that are needed in an instance but not a
         // Descriptor
@@ -658,6 +660,37 @@ namespace OFX {
 
         return none;
       }
+
+      bool ClipInstance::getImageCacheKey(OfxTime /*time*/, const OfxRectD */*optionalBounds*/, ImageCacheKey &/*key*/)
+      {
+        return false;
+      }
+
+      Image* ClipInstance::fetchImage(OfxTime time, const OfxRectD *optionalBounds)
+      {
+        ImageCacheKey key;
+        if(!_imageCache || _isOutput || !getImageCacheKey(time, optionalBounds, key))
+          return getImage(time, optionalBounds);
+
+        Image *image = _imageCache->get(key);
+        if(!image) {
+          image = getImage(time, optionalBounds);
+          if(image)
+            _imageCache->insert(key, image);
+        }
+        return image;
+      }
+
+      const RenderContext *ClipInstance::getRenderContext() const
+      {
+        return _effectInstance ? _effectInstance->getRenderContext() : NULL;
+      }
+
+      int ClipInstance::getRenderView() const
+      {
+        const RenderContext *context = getRenderContext();
+        return context ? context->view : 0;
+      }
       
       
       ////////////////////////////////////////////////////////////////////////////////
@@ -781,9 +814,16 @@ namespace OFX {
       // release the reference 
       void ImageBase::releaseReference()
       {
+#if __cplusplus >= 201103L
+        // acquire/release so that whatever the other threads did to the image
+        // happens before the delete by the thread that drops the last reference
+        if(_referenceCount.fetch_sub(1, std::memory_order_acq_rel) <= 1)
+          delete this;
+#else
         _referenceCount -= 1;
         if(_referenceCount <= 0)
           delete this;
+#endif
       }
 
 
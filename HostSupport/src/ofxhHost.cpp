@@ -35,6 +35,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // ofx
 #include "ofxCore.h"
 #include "ofxProperty.h"
+#include "ofxPropertyBatch.h"
 #include "ofxMultiThread.h"
 #include "ofxMemory.h"
 #ifdef OFX_SUPPORTS_OPENGLRENDER
@@ -141,6 +142,9 @@ namespace OFX {
       if (strcmp(suiteName, kOfxPropertySuite)==0  && suiteVersion == 1) {
         return Property::GetSuite(suiteVersion);
       }
+      else if (strcmp(suiteName, kOfxPropertyBatchSuite)==0) {
+        return Property::GetBatchSuite(suiteVersion);
+      }
       else if (strcmp(suiteName, kOfxMemorySuite)==0 && suiteVersion == 1) {
         return (void*)&Memory::gMallocSuite;
       }  
@@ -0,0 +1,392 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <string.h>
+#include <algorithm>
+
+// ofx
+#include "ofxCore.h"
+#include "ofxImageEffect.h"
+
+// ofx host
+#include "ofxhBinary.h"
+#include "ofxhPropertySuite.h"
+#include "ofxhClip.h"
+#include "ofxhParam.h"
+#include "ofxhMemory.h"
+#include "ofxhImageEffect.h"
+#include "ofxhPluginAPICache.h"
+#include "ofxhPluginCache.h"
+#include "ofxhHost.h"
+#include "ofxhImageEffectAPI.h"
+#include "ofxhImageCache.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace ImageEffect {
+
+      namespace {
+
+        /// 64 bit FNV-1a, fed a few bytes at a time
+        class Hasher {
+        public :
+          Hasher() : _h(14695981039346656037ULL) {}
+
+          void add(const void *data, size_t n)
+          {
+            const unsigned char *p = (const unsigned char *) data;
+            for(size_t i = 0; i < n; ++i) {
+              _h ^= p[i];
+              _h *= 1099511628211ULL;
+            }
+          }
+
+          void add(const std::string &s) { add(s.data(), s.size() + 1); }
+          void add(int v) { add(&v, sizeof(v)); }
+          void add(double v) { add(&v, sizeof(v)); }
+
+          unsigned long long value() const { return _h; }
+
+        private :
+          unsigned long long _h;
+        };
+
+        /// add the value of a param at a time to a hash, returns false for
+        /// params that have no value
+        bool hashParam(Hasher &hasher, Param::Instance *param, OfxTime time)
+        {
+          if(Param::IntegerInstance *p = dynamic_cast<Param::IntegerInstance *>(param)) {
+            int v = 0;
+            p->get(time, v);
+            hasher.add(v);
+          }
+          else if(Param::ChoiceInstance *p = dynamic_cast<Param::ChoiceInstance *>(param)) {
+            int v = 0;
+            p->get(time, v);
+            hasher.add(v);
+          }
+          else if(Param::DoubleInstance *p = dynamic_cast<Param::DoubleInstance *>(param)) {
+            double v = 0.;
+            p->get(time, v);
+            hasher.add(v);
+          }
+          else if(Param::BooleanInstance *p = dynamic_cast<Param::BooleanInstance *>(param)) {
+            bool v = false;
+            p->get(time, v);
+            hasher.add(int(v));
+          }
+          else if(Param::RGBAInstance *p = dynamic_cast<Param::RGBAInstance *>(param)) {
+            double v[4] = {0., 0., 0., 0.};
+            p->get(time, v[0], v[1], v[2], v[3]);
+            hasher.add(v, sizeof(v));
+          }
+          else if(Param::RGBInstance *p = dynamic_cast<Param::RGBInstance *>(param)) {
+            double v[3] = {0., 0., 0.};
+            p->get(time, v[0], v[1], v[2]);
+            hasher.add(v, sizeof(v));
+          }
+          else if(Param::Double2DInstance *p = dynamic_cast<Param::Double2DInstance *>(param)) {
+            double v[2] = {0., 0.};
+            p->get(time, v[0], v[1]);
+            hasher.add(v, sizeof(v));
+          }
+          else if(Param::Integer2DInstance *p = dynamic_cast<Param::Integer2DInstance *>(param)) {
+            int v[2] = {0, 0};
+            p->get(time, v[0], v[1]);
+            hasher.add(v, sizeof(v));
+          }
+          else if(Param::Double3DInstance *p = dynamic_cast<Param::Double3DInstance *>(param)) {
+            double v[3] = {0., 0., 0.};
+            p->get(time, v[0], v[1], v[2]);
+            hasher.add(v, sizeof(v));
+          }
+          else if(Param::Integer3DInstance *p = dynamic_cast<Param::Integer3DInstance *>(param)) {
+            int v[3] = {0, 0, 0};
+            p->get(time, v[0], v[1], v[2]);
+            hasher.add(v, sizeof(v));
+          }
+          else if(Param::StringInstance *p = dynamic_cast<Param::StringInstance *>(param)) {
+            // also custom params
+            std::string v;
+            p->get(time, v);
+            hasher.add(v);
+          }
+          else {
+            // groups, pages, push buttons...
+            return false;
+          }
+          return true;
+        }
+
+        template <class T> int compare(const T &a, const T &b)
+        {
+          return a < b ? -1 : (b < a ? 1 : 0);
+        }
+
+      } // anonymous namespace
+
+      ////////////////////////////////////////////////////////////////////////////////
+      // ImageCacheKey
+
+      ImageCacheKey::ImageCacheKey()
+        : paramHash(0)
+        , time(0.)
+        , view(0)
+        , hasRoI(false)
+      {
+        renderScale.x = renderScale.y = 1.;
+        roi.x1 = roi.y1 = roi.x2 = roi.y2 = 0.;
+      }
+
+      ImageCacheKey::ImageCacheKey(Instance &effect,
+                                   OfxTime t,
+                                   int v,
+                                   OfxPointD rs,
+                                   const OfxRectD *bounds)
+        : paramHash(hashParams(effect, t))
+        , time(t)
+        , view(v)
+        , renderScale(rs)
+        , hasRoI(bounds != NULL)
+      {
+        if(effect.getPlugin())
+          pluginIdentifier = effect.getPlugin()->getIdentifier();
+        if(bounds)
+          roi = *bounds;
+        else
+          roi.x1 = roi.y1 = roi.x2 = roi.y2 = 0.;
+      }
+
+      unsigned long long ImageCacheKey::hashParams(const Param::SetInstance &params, OfxTime time)
+      {
+        Hasher hasher;
+        const std::list<Param::Instance *> &paramList = params.getParamList();
+        for(std::list<Param::Instance *>::const_iterator it = paramList.begin(); it != paramList.end(); ++it) {
+          Hasher value;
+          if(hashParam(value, *it, time)) {
+            hasher.add((*it)->getName());
+            unsigned long long v = value.value();
+            hasher.add(&v, sizeof(v));
+          }
+        }
+        return hasher.value();
+      }
+
+      bool ImageCacheKey::operator<(const ImageCacheKey &other) const
+      {
+        int c;
+        if((c = compare(paramHash, other.paramHash)) != 0) return c < 0;
+        if((c = compare(time, other.time)) != 0) return c < 0;
+        if((c = compare(view, other.view)) != 0) return c < 0;
+        if((c = compare(renderScale.x, other.renderScale.x)) != 0) return c < 0;
+        if((c = compare(renderScale.y, other.renderScale.y)) != 0) return c < 0;
+        if((c = compare(hasRoI, other.hasRoI)) != 0) return c < 0;
+        if((c = compare(roi.x1, other.roi.x1)) != 0) return c < 0;
+        if((c = compare(roi.y1, other.roi.y1)) != 0) return c < 0;
+        if((c = compare(roi.x2, other.roi.x2)) != 0) return c < 0;
+        if((c = compare(roi.y2, other.roi.y2)) != 0) return c < 0;
+        // the identifier last, it is the most expensive to compare
+        return pluginIdentifier < other.pluginIdentifier;
+      }
+
+      bool ImageCacheKey::operator==(const ImageCacheKey &other) const
+      {
+        return !(*this < other) && !(other < *this);
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////
+      // ImageCache
+
+#if __cplusplus >= 201103L
+      class ImageCache::Lock {
+      public :
+        explicit Lock(const ImageCache &cache) : _guard(cache._mutex) {}
+      private :
+        std::lock_guard<std::mutex> _guard;
+      };
+#else
+      // no portable mutex before C++11, the host must use the cache from one thread at a time
+      class ImageCache::Lock {
+      public :
+        explicit Lock(const ImageCache &) {}
+      };
+#endif
+
+      ImageCache::ImageCache(size_t maxBytes)
+        : _maxBytes(maxBytes)
+        , _bytes(0)
+        , _hits(0)
+        , _misses(0)
+      {
+      }
+
+      ImageCache::~ImageCache()
+      {
+        clear();
+      }
+
+      Image *ImageCache::get(const ImageCacheKey &key)
+      {
+        Lock lock(*this);
+        EntryMap::iterator it = _byKey.find(key);
+        if(it == _byKey.end()) {
+          ++_misses;
+          return NULL;
+        }
+        ++_hits;
+        // move it to the front, this does not invalidate the iterator
+        _entries.splice(_entries.begin(), _entries, it->second);
+        Image *image = it->second->image;
+        image->addReference();
+        return image;
+      }
+
+      void ImageCache::insert(const ImageCacheKey &key, Image *image)
+      {
+        if(!image)
+          return;
+
+        size_t nBytes = getImageBytes(*image);
+        std::vector<Image *> evicted;
+        {
+          Lock lock(*this);
+          EntryMap::iterator it = _byKey.find(key);
+          if(it != _byKey.end()) {
+            if(it->second->image == image)
+              return;
+            _bytes -= it->second->nBytes;
+            evicted.push_back(it->second->image);
+            _entries.erase(it->second);
+            _byKey.erase(it);
+          }
+          if(nBytes <= _maxBytes) {
+            Entry entry;
+            entry.key = key;
+            entry.image = image;
+            entry.nBytes = nBytes;
+            image->addReference();
+            _entries.push_front(entry);
+            _byKey[key] = _entries.begin();
+            _bytes += nBytes;
+            trim(evicted);
+          }
+        }
+        release(evicted);
+      }
+
+      void ImageCache::clear()
+      {
+        std::vector<Image *> evicted;
+        {
+          Lock lock(*this);
+          for(EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it)
+            evicted.push_back(it->image);
+          _entries.clear();
+          _byKey.clear();
+          _bytes = 0;
+        }
+        release(evicted);
+      }
+
+      void ImageCache::setMaxBytes(size_t maxBytes)
+      {
+        std::vector<Image *> evicted;
+        {
+          Lock lock(*this);
+          _maxBytes = maxBytes;
+          trim(evicted);
+        }
+        release(evicted);
+      }
+
+      size_t ImageCache::getMaxBytes() const
+      {
+        Lock lock(*this);
+        return _maxBytes;
+      }
+
+      size_t ImageCache::getBytes() const
+      {
+        Lock lock(*this);
+        return _bytes;
+      }
+
+      size_t ImageCache::getCount() const
+      {
+        Lock lock(*this);
+        return _entries.size();
+      }
+
+      void ImageCache::getStats(size_t &hits, size_t &misses) const
+      {
+        Lock lock(*this);
+        hits = _hits;
+        misses = _misses;
+      }
+
+      size_t ImageCache::getImageBytes(const Image &image)
+      {
+        OfxRectI bounds = image.getBounds();
+        int rowBytes = image.getIntProperty(kOfxImagePropRowBytes);
+        if(rowBytes < 0)
+          rowBytes = -rowBytes;
+        int height = bounds.y2 - bounds.y1;
+        if(height <= 0)
+          return 0;
+        return size_t(rowBytes) * size_t(height);
+      }
+
+      void ImageCache::trim(std::vector<Image *> &evicted)
+      {
+        while(_bytes > _maxBytes && !_entries.empty()) {
+          Entry &entry = _entries.back();
+          _bytes -= entry.nBytes;
+          evicted.push_back(entry.image);
+          _byKey.erase(entry.key);
+          _entries.pop_back();
+        }
+      }
+
+      void ImageCache::release(std::vector<Image *> &images)
+      {
+        // done outside the lock, as dropping the last reference deletes the image
+        for(size_t i = 0; i < images.size(); ++i)
+          images[i]->releaseReference();
+        images.clear();
+      }
+
+    } // ImageEffect
+
+  } // Host
+
+} // OFX
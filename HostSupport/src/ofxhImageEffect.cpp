@@ -54,6 +54,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofxhClip.h"
 #include "ofxhParam.h"
 #include "ofxhMemory.h"
+#include "ofxhMultiThread.h"
 #include "ofxhImageEffect.h"
 #include "ofxhPluginAPICache.h"
 #include "ofxhPluginCache.h"
@@ -920,11 +921,147 @@ namespace OFX {
           return instance;
         else{
           Memory::Instance* instance = new Memory::Instance;
-          instance->alloc(nBytes);
+          if(!instance->alloc(nBytes)) {
+            delete instance;
+            return 0;
+          }
           return instance;
         }
       }
 
+      namespace {
+
+        /// the API's actions and their ids
+        const struct {
+          ActionId    id;
+          const char *name;
+        } gActionNames[] = {
+          { eActionLoad,                   kOfxActionLoad },
+          { eActionUnload,                 kOfxActionUnload },
+          { eActionDescribe,               kOfxActionDescribe },
+          { eActionDescribeInContext,      kOfxImageEffectActionDescribeInContext },
+          { eActionCreateInstance,         kOfxActionCreateInstance },
+          { eActionDestroyInstance,        kOfxActionDestroyInstance },
+          { eActionRender,                 kOfxImageEffectActionRender },
+          { eActionBeginSequenceRender,    kOfxImageEffectActionBeginSequenceRender },
+          { eActionEndSequenceRender,      kOfxImageEffectActionEndSequenceRender },
+          { eActionIsIdentity,             kOfxImageEffectActionIsIdentity },
+          { eActionGetRegionOfDefinition,  kOfxImageEffectActionGetRegionOfDefinition },
+          { eActionGetRegionsOfInterest,   kOfxImageEffectActionGetRegionsOfInterest },
+          { eActionGetFramesNeeded,        kOfxImageEffectActionGetFramesNeeded },
+          { eActionGetClipPreferences,     kOfxImageEffectActionGetClipPreferences },
+          { eActionGetTimeDomain,          kOfxImageEffectActionGetTimeDomain },
+          { eActionPurgeCaches,            kOfxActionPurgeCaches },
+          { eActionSyncPrivateData,        kOfxActionSyncPrivateData },
+          { eActionBeginInstanceChanged,   kOfxActionBeginInstanceChanged },
+          { eActionInstanceChanged,        kOfxActionInstanceChanged },
+          { eActionEndInstanceChanged,     kOfxActionEndInstanceChanged },
+          { eActionBeginInstanceEdit,      kOfxActionBeginInstanceEdit },
+          { eActionEndInstanceEdit,        kOfxActionEndInstanceEdit },
+#ifdef OFX_SUPPORTS_OPENGLRENDER
+          { eActionOpenGLContextAttached,  kOfxActionOpenGLContextAttached },
+          { eActionOpenGLContextDetached,  kOfxActionOpenGLContextDetached },
+#endif
+#ifdef OFX_SUPPORTS_DIALOG
+          { eActionDialog,                 kOfxActionDialog },
+#endif
+#ifdef OFX_EXTENSIONS_NUKE
+          { eActionGetClipComponents,      kFnOfxImageEffectActionGetClipComponents },
+          { eActionGetFrameViewsNeeded,    kFnOfxImageEffectActionGetFrameViewsNeeded },
+          { eActionGetTransform,           kFnOfxImageEffectActionGetTransform },
+#endif
+#ifdef OFX_EXTENSIONS_NATRON
+          { eActionGetInverseDistortion,   kOfxImageEffectActionGetInverseDistortion },
+#endif
+        };
+
+        /// the interned actions, with open addressed tables to find them by address and by name
+        class ActionTable {
+        public :
+          ActionTable()
+          {
+            _unknown.id = eActionUnknown;
+            _unknown.name = NULL;
+            _unknown.string = NULL;
+            for(int i = 0; i < kNSlots; ++i) {
+              _byAddress[i].key = NULL;
+              _byName[i].key = NULL;
+            }
+
+            const int n = (int) (sizeof(gActionNames) / sizeof(gActionNames[0]));
+            for(int i = 0; i < n; ++i) {
+              InternedAction &action = _actions[i];
+              _strings[i] = gActionNames[i].name;
+              action.id = gActionNames[i].id;
+              action.name = gActionNames[i].name;
+              action.string = &_strings[i];
+              insert(_byAddress, hashAddress(action.name), action.name, &action);
+              insert(_byAddress, hashAddress(_strings[i].c_str()), _strings[i].c_str(), &action);
+              insert(_byName, hashName(action.name), action.name, &action);
+            }
+          }
+
+          const InternedAction &find(const char *name) const
+          {
+            if(!name)
+              return _unknown;
+            for(unsigned i = hashAddress(name); _byAddress[i].key; i = (i + 1) & (kNSlots - 1)) {
+              if(_byAddress[i].key == name)
+                return *_byAddress[i].action;
+            }
+            for(unsigned i = hashName(name); _byName[i].key; i = (i + 1) & (kNSlots - 1)) {
+              if(strcmp(_byName[i].key, name) == 0)
+                return *_byName[i].action;
+            }
+            return _unknown;
+          }
+
+        private :
+          enum { kNSlots = 256 }; ///< a power of two, well over twice the number of keys
+
+          struct Slot {
+            const char           *key;
+            const InternedAction *action;
+          };
+
+          static unsigned hashAddress(const char *p)
+          {
+            size_t v = (size_t) p;
+            return (unsigned) ((v >> 3) ^ (v >> 11)) & (kNSlots - 1);
+          }
+
+          /// FNV-1a
+          static unsigned hashName(const char *name)
+          {
+            unsigned h = 2166136261u;
+            for(; *name; ++name)
+              h = (h ^ (unsigned char) *name) * 16777619u;
+            return h & (kNSlots - 1);
+          }
+
+          static void insert(Slot *slots, unsigned i, const char *key, const InternedAction *action)
+          {
+            while(slots[i].key && slots[i].key != key)
+              i = (i + 1) & (kNSlots - 1);
+            slots[i].key = key;
+            slots[i].action = action;
+          }
+
+          InternedAction _actions[eActionCount];
+          std::string    _strings[eActionCount];
+          InternedAction _unknown;
+          Slot           _byAddress[kNSlots];
+          Slot           _byName[kNSlots];
+        };
+      }
+
+      /// find the interned form of an action
+      const InternedAction &internAction(const char *action)
+      {
+        static const ActionTable table;
+        return table.find(action);
+      }
+
       // call the effect entry point
       OfxStatus Instance::mainEntry(const char *action, 
                                     const void *handle, 
@@ -937,15 +1074,20 @@ namespace OFX {
             OfxPlugin* ofxPlugin = pHandle->getOfxPlugin();
             if(ofxPlugin){
               
+              // the hooks take a string, which for the API's actions was made once
+              const InternedAction &interned = internAction(action);
+              std::string custom;
+              const std::string &actionString = interned.string ? *interned.string : (custom = action);
+
               OfxPropertySetHandle inHandle = 0;
               if(inArgs) {
-                setCustomInArgs(action, *inArgs);
+                setCustomInArgs(actionString, *inArgs);
                 inHandle = inArgs->getHandle();
               }
               
               OfxPropertySetHandle outHandle = 0;
               if(outArgs) {
-                setCustomOutArgs(action, *outArgs);
+                setCustomOutArgs(actionString, *outArgs);
                 outHandle = outArgs->getHandle();
               }
                 
@@ -955,7 +1097,7 @@ namespace OFX {
               } CatchAllSetStatus(stat, gImageEffectHost, ofxPlugin, action);
 
               if(outArgs) 
-                examineOutArgs(action, stat, *outArgs);
+                examineOutArgs(actionString, stat, *outArgs);
 
               return stat;
             }
@@ -1135,6 +1277,8 @@ namespace OFX {
           std::cout << "OFX: "<<(void*)this<<"->"<<kOfxActionPurgeCaches<<"()"<<std::endl;
 #       endif
         OfxStatus st = mainEntry(kOfxActionPurgeCaches ,this->getHandle(),0,0);
+        // give the free image memory blocks back to the system as well
+        Memory::purgePool();
 #       ifdef OFX_DEBUG_ACTIONS
           std::cout << "OFX: "<<(void*)this<<"->"<<kOfxActionPurgeCaches<<"()->"<<StatStr(st)<<std::endl;
 #       endif
@@ -1354,6 +1498,83 @@ namespace OFX {
         return st;
       }
 
+#if __cplusplus >= 201103L
+      class Instance::RenderLock {
+      public :
+        explicit RenderLock(Instance &instance)
+        {
+          const std::string &safety = instance.getRenderThreadSafety();
+          if(safety == kOfxImageEffectRenderUnsafe && instance._plugin)
+            _lock = std::unique_lock<std::recursive_mutex>(instance._plugin->getRenderMutex());
+          else if(safety != kOfxImageEffectRenderFullySafe || instance.requiresSequentialRender())
+            _lock = std::unique_lock<std::recursive_mutex>(instance._renderMutex);
+        }
+      private :
+        std::unique_lock<std::recursive_mutex> _lock;
+      };
+#else
+      // no portable mutex before C++11, so the plugin's render thread safety is not enforced,
+      // the host must not render an instance, or any instance of an unsafe plugin, on several
+      // threads at once
+      class Instance::RenderLock {
+      public :
+        explicit RenderLock(Instance &) {}
+      };
+#endif
+
+#if defined(OFX_EXTENSIONS_NUKE) || defined(OFX_EXTENSIONS_NATRON)
+      /// the render window of the actions that are not renders
+      static const OfxRectI kNoRenderWindow = { 0, 0, 0, 0 };
+#endif
+
+      /// makes a render context the calling thread's current one for its lifetime, which the
+      /// multithread suite passes on to the work items the plugin runs
+      class Instance::RenderScope {
+      public :
+        RenderScope(RenderContext &context,
+                    Instance &instance,
+                    OfxTime time,
+                    const std::string &field,
+                    const OfxRectI &renderWindow,
+                    OfxPointD renderScale,
+                    bool sequentialRender,
+                    bool interactiveRender,
+                    bool draftRender,
+                    int view)
+          : _context(context)
+        {
+          context.instance = &instance;
+          context.time = time;
+          context.field = &field;
+          context.renderWindow = renderWindow;
+          context.renderScale = renderScale;
+          context.sequentialRender = sequentialRender;
+          context.interactiveRender = interactiveRender;
+          context.draftRender = draftRender;
+          context.view = view;
+
+          context.enclosing = static_cast<const RenderContext *>(MultiThread::getThreadContext());
+          MultiThread::setThreadContext(&context);
+        }
+
+        ~RenderScope()
+        {
+          MultiThread::setThreadContext(_context.enclosing);
+        }
+
+      private :
+        RenderContext &_context;
+      };
+
+      const RenderContext *Instance::getRenderContext() const
+      {
+        for(const RenderContext *context = static_cast<const RenderContext *>(MultiThread::getThreadContext()); context; context = context->enclosing) {
+          if(context->instance == this)
+            return context;
+        }
+        return NULL;
+      }
+
       OfxStatus Instance::renderAction(OfxTime      time,
                                        const std::string &  field,
                                        const OfxRectI    &renderRoI,
@@ -1384,6 +1605,8 @@ namespace OFX {
         if ( OFX::IsNaN(time) ) {
           return kOfxStatFailed;
         }
+        RenderLock lock(*this);
+
         static const Property::PropSpec inStuff[] = {
           { kOfxPropTime, Property::eDouble, 1, true, "0" },
           { kOfxImageEffectPropFieldToRender, Property::eString, 1, true, "" }, 
@@ -1415,32 +1638,33 @@ namespace OFX {
           Property::propSpecEnd
         };
 
-        Property::Set inArgs(inStuff);
+        Property::ReusableSet::Lease inArgs(_renderInArgs, inStuff);
         
-        inArgs.setStringProperty(kOfxImageEffectPropFieldToRender,field);
-        inArgs.setDoubleProperty(kOfxPropTime,time);
-        inArgs.setIntPropertyN(kOfxImageEffectPropRenderWindow, &renderRoI.x1, 4);
-        inArgs.setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
-        inArgs.setIntProperty(kOfxImageEffectPropSequentialRenderStatus,sequentialRender);
-        inArgs.setIntProperty(kOfxImageEffectPropInteractiveRenderStatus,interactiveRender);
+        inArgs->setStringProperty(kOfxImageEffectPropFieldToRender,field);
+        inArgs->setDoubleProperty(kOfxPropTime,time);
+        inArgs->setIntPropertyN(kOfxImageEffectPropRenderWindow, &renderRoI.x1, 4);
+        inArgs->setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
+        inArgs->setIntProperty(kOfxImageEffectPropSequentialRenderStatus,sequentialRender);
+        inArgs->setIntProperty(kOfxImageEffectPropInteractiveRenderStatus,interactiveRender);
 #     ifdef OFX_SUPPORTS_OPENGLRENDER
-        inArgs.setIntProperty(kOfxImageEffectPropOpenGLEnabled,openGLRender);
+        inArgs->setIntProperty(kOfxImageEffectPropOpenGLEnabled,openGLRender);
 #      ifdef OFX_EXTENSIONS_NATRON
-        inArgs.setPointerProperty(kNatronOfxImageEffectPropOpenGLContextData, contextData);
+        inArgs->setPointerProperty(kNatronOfxImageEffectPropOpenGLContextData, contextData);
 #      endif
 #     endif
-        inArgs.setIntProperty(kOfxImageEffectPropRenderQualityDraft,draftRender);
+        inArgs->setIntProperty(kOfxImageEffectPropRenderQualityDraft,draftRender);
 #     ifdef OFX_EXTENSIONS_VEGAS
-        inArgs.setIntProperty(kOfxImageEffectPropRenderView,view);
-        inArgs.setIntProperty(kOfxImageEffectPropViewsToRender,nViews);
+        inArgs->setIntProperty(kOfxImageEffectPropRenderView,view);
+        inArgs->setIntProperty(kOfxImageEffectPropViewsToRender,nViews);
 #     endif
 #     ifdef OFX_EXTENSIONS_NUKE
-        inArgs.setIntProperty(kFnOfxImageEffectPropView,view);
+        inArgs->setIntProperty(kFnOfxImageEffectPropView,view);
         int k = 0;
         for (std::list<std::string>::const_iterator it = planes.begin(); it != planes.end(); ++it,++k) {
-            inArgs.setStringProperty(kOfxImageEffectPropRenderPlanes,*it,k);
+            inArgs->setStringProperty(kOfxImageEffectPropRenderPlanes,*it,k);
         }
 #     endif
+
 #     if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
         for(std::map<std::string, ClipInstance*>::iterator it=_clips.begin();
             it!=_clips.end();
@@ -1449,6 +1673,14 @@ namespace OFX {
         }
 #     endif
 
+        /// what the clips see of this call, in place of per clip view state
+        RenderContext context;
+#     if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+        RenderScope scope(context, *this, time, field, renderRoI, renderScale, sequentialRender, interactiveRender, draftRender, view);
+#     else
+        RenderScope scope(context, *this, time, field, renderRoI, renderScale, sequentialRender, interactiveRender, draftRender, 0);
+#     endif
+
 #       ifdef OFX_DEBUG_ACTIONS
           OfxPlugin *ofxp = _plugin->getPluginHandle()->getOfxPlugin();
           const char* id = ofxp->pluginIdentifier;
@@ -1462,7 +1694,7 @@ namespace OFX {
           <<")"<<std::endl;
 #       endif
 
-        OfxStatus st = mainEntry(kOfxImageEffectActionRender,this->getHandle(), &inArgs, 0);
+        OfxStatus st = mainEntry(kOfxImageEffectActionRender,this->getHandle(), inArgs.get(), 0);
 #       ifdef OFX_DEBUG_ACTIONS
           std::cout << "OFX: "<<id<<"("<<(void*)ofxp<<")->"<<kOfxImageEffectActionRender<<"("<<time<<","<<field<<",("<<renderRoI.x1<<","<<renderRoI.y1<<","<<renderRoI.x2<<","<<renderRoI.y2<<"),("<<renderScale.x<<","<<renderScale.y<<"),"<<sequentialRender<<","<<interactiveRender<<","<<draftRender
 #         if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
@@ -1579,6 +1811,8 @@ namespace OFX {
         if ( OFX::IsNaN(time) ) {
           return kOfxStatFailed;
         }
+        RenderLock lock(*this);
+
         static const Property::PropSpec inStuff[] = {
           { kOfxPropTime, Property::eDouble, 1, true, "0" },
           { kOfxImageEffectPropFieldToRender, Property::eString, 1, true, "" }, 
@@ -1607,6 +1841,8 @@ namespace OFX {
             ++it) {
             it->second->setView(view);
         }
+        RenderContext context;
+        RenderScope scope(context, *this, time, field, kNoRenderWindow, renderScale, false, false, draftRender, view);
 
 #       ifdef OFX_DEBUG_ACTIONS
           OfxPlugin *ofxp = _plugin->getPluginHandle()->getOfxPlugin();
@@ -1644,6 +1880,8 @@ namespace OFX {
         if ( OFX::IsNaN(time) ) {
           return kOfxStatFailed;
         }
+        RenderLock lock(*this);
+
         static const Property::PropSpec inStuff[] = {
           { kOfxPropTime, Property::eDouble, 1, true, "0" },
           { kOfxImageEffectPropFieldToRender, Property::eString, 1, true, "" },
@@ -1674,8 +1912,10 @@ namespace OFX {
         for(std::map<std::string, ClipInstance*>::iterator it=_clips.begin();
             it!=_clips.end();
             ++it) {
-          it->second->setView(view);
+            it->second->setView(view);
         }
+        RenderContext context;
+        RenderScope scope(context, *this, time, field, kNoRenderWindow, renderScale, false, false, draftRender, view);
 
 #       ifdef OFX_DEBUG_ACTIONS
         OfxPlugin *ofxp = _plugin->getPluginHandle()->getOfxPlugin();
@@ -1852,14 +2092,14 @@ namespace OFX {
           Property::propSpecEnd
         };
 
-        Property::Set inArgs(inStuff);
-        Property::Set outArgs(outStuff);
+        Property::ReusableSet::Lease inArgs(_rodInArgs, inStuff);
+        Property::ReusableSet::Lease outArgs(_rodOutArgs, outStuff);
         
-        inArgs.setDoubleProperty(kOfxPropTime,time);
+        inArgs->setDoubleProperty(kOfxPropTime,time);
 #ifdef OFX_EXTENSIONS_NUKE
-        inArgs.setIntProperty(kFnOfxImageEffectPropView, view);
+        inArgs->setIntProperty(kFnOfxImageEffectPropView, view);
 #endif
-        inArgs.setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
+        inArgs->setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
 
 #       ifdef OFX_DEBUG_ACTIONS
           OfxPlugin *ofxp = _plugin->getPluginHandle()->getOfxPlugin();
@@ -1868,10 +2108,10 @@ namespace OFX {
 #       endif
         OfxStatus stat = mainEntry(kOfxImageEffectActionGetRegionOfDefinition,
                                    this->getHandle(),
-                                   &inArgs,
-                                   &outArgs);
+                                   inArgs.get(),
+                                   outArgs.get());
         if(stat == kOfxStatOK) {
-          outArgs.getDoublePropertyN(kOfxImageEffectPropRegionOfDefinition, &rod.x1, 4);
+          outArgs->getDoublePropertyN(kOfxImageEffectPropRegionOfDefinition, &rod.x1, 4);
         }
         else if(stat == kOfxStatReplyDefault) {
           rod = calcDefaultRegionOfDefinition(time, renderScale
@@ -1908,8 +2148,15 @@ namespace OFX {
         }
         OfxStatus stat = kOfxStatReplyDefault;
 
-        // reset the map
-        rois.clear();
+        // reset the map. Entries for our own clips are all overwritten or erased below, so
+        // keep their nodes, the map is then reused without allocating when called per tile.
+        for (std::map<ClipInstance *, OfxRectD>::const_iterator it = rois.begin(); it != rois.end(); ++it) {
+          std::map<std::string, ClipInstance*>::const_iterator found = _clips.find(it->first->getName());
+          if (found == _clips.end() || found->second != it->first) {
+            rois.clear();
+            break;
+          }
+        }
 
         // If an effect does not support tiles, it cannot *render* tiles, but it still may implement
         // kOfxImageEffectActionGetRegionsOfInterest. For example, if an input clip is not needed, it can
@@ -1934,16 +2181,22 @@ namespace OFX {
 #         endif
           Property::propSpecEnd
         };
-        Property::Set inArgs(inStuff);
+        Property::ReusableSet::Lease inArgs(_roiInArgs, inStuff);
 
-        inArgs.setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
-        inArgs.setDoubleProperty(kOfxPropTime,time);
-        inArgs.setDoublePropertyN(kOfxImageEffectPropRegionOfInterest, &roi.x1, 4);
+        inArgs->setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
+        inArgs->setDoubleProperty(kOfxPropTime,time);
+        inArgs->setDoublePropertyN(kOfxImageEffectPropRegionOfInterest, &roi.x1, 4);
 #       ifdef OFX_EXTENSIONS_NUKE
-        inArgs.setIntProperty(kFnOfxImageEffectPropView, view);
+        inArgs->setIntProperty(kFnOfxImageEffectPropView, view);
 #       endif
 
-        Property::Set outArgs;
+        static const Property::PropSpec outStuff[] = {
+          Property::propSpecEnd
+        };
+        Property::ReusableSet::Lease outArgs(_roiOutArgs, outStuff);
+        // one RoI property per clip, in the order of _clips
+        std::vector<Property::Property *> &clipRoIs = outArgs.getExtraProperties();
+        size_t nClipRoIs = 0;
         for (std::map<std::string, ClipInstance*>::iterator it=_clips.begin();
             it!=_clips.end();
             ++it) {
@@ -1952,19 +2205,23 @@ namespace OFX {
               getContext() == kOfxImageEffectContextReader ||
 #             endif
               getContext() == kOfxImageEffectContextGenerator) {
-            Property::PropSpec s;
-            std::string name = "OfxImageClipPropRoI_"+it->first;
+            if (outArgs.isFresh()) {
+              Property::PropSpec s;
+              std::string name = "OfxImageClipPropRoI_"+it->first;
 
-            s.name = name.c_str();
-            s.type = Property::eDouble;
-            s.dimension = 4;
-            s.readonly = false;
-            s.defaultValue = "";
-            outArgs.createProperty(s);
+              s.name = name.c_str();
+              s.type = Property::eDouble;
+              s.dimension = 4;
+              s.readonly = false;
+              s.defaultValue = "";
+              outArgs->createProperty(s);
+              clipRoIs.push_back(outArgs->fetchProperty(name));
+            }
+            Property::Double *clipRoI = static_cast<Property::Double *>(clipRoIs[nClipRoIs++]);
             
             /// initialise to the default
             if (supportstiles && it->second->supportsTiles()) {
-              outArgs.setDoublePropertyN(s.name, &roi.x1, 4);
+              clipRoI->setValueN(&roi.x1, 4);
             } else {
               OfxRectD rod = roi;
               // needed to be able to fetch the RoD
@@ -1975,7 +2232,7 @@ namespace OFX {
                 rod = it->second->getRegionOfDefinition(time);
 #               endif
               }
-              outArgs.setDoublePropertyN(s.name, &rod.x1, 4);
+              clipRoI->setValueN(&rod.x1, 4);
             }
           }
         }
@@ -1988,8 +2245,8 @@ namespace OFX {
         /// call the action
         stat = mainEntry(kOfxImageEffectActionGetRegionsOfInterest,
                          this->getHandle(),
-                         &inArgs,
-                         &outArgs);
+                         inArgs.get(),
+                         outArgs.get());
 
 #       ifdef OFX_DEBUG_ACTIONS
         std::cout << "OFX: "<<id<<"("<<(void*)ofxp<<")->"<<kOfxImageEffectActionGetRegionsOfInterest<<"("<<time<<",("<<renderScale.x<<","<<renderScale.y<<"),("<<roi.x1<<","<<roi.y1<<","<<roi.x2<<","<<roi.y2<<"))->"<<StatStr(stat);
@@ -2000,16 +2257,17 @@ namespace OFX {
               ++it) {
             std::string name = "OfxImageClipPropRoI_"+it->first;
             OfxRectD thisRoi;
-            thisRoi.x1 = outArgs.getDoubleProperty(name,0);
-            thisRoi.y1 = outArgs.getDoubleProperty(name,1);
-            thisRoi.x2 = outArgs.getDoubleProperty(name,2);
-            thisRoi.y2 = outArgs.getDoubleProperty(name,3);
+            thisRoi.x1 = outArgs->getDoubleProperty(name,0);
+            thisRoi.y1 = outArgs->getDoubleProperty(name,1);
+            thisRoi.x2 = outArgs->getDoubleProperty(name,2);
+            thisRoi.y2 = outArgs->getDoubleProperty(name,3);
             std::cout << it->first << "->("<<thisRoi.x1<<","<<thisRoi.y1<<","<<thisRoi.x2<<","<<thisRoi.y2<<") ";
           }
         }
         std::cout << std::endl;
 #       endif
         // get the results
+        nClipRoIs = 0;
         for (std::map<std::string, ClipInstance*>::iterator it=_clips.begin();
              it!=_clips.end();
              ++it) {
@@ -2018,14 +2276,14 @@ namespace OFX {
               getContext() == kOfxImageEffectContextReader ||
 #endif
               getContext() == kOfxImageEffectContextGenerator) {
+            Property::Double *clipRoI = static_cast<Property::Double *>(clipRoIs[nClipRoIs++]);
             if (it->second->isOutput() || it->second->getConnected()) { // needed to be able to fetch the RoD
                   
-              std::string name = "OfxImageClipPropRoI_"+it->first;
               OfxRectD thisRoi;
-              thisRoi.x1 = outArgs.getDoubleProperty(name,0);
-              thisRoi.y1 = outArgs.getDoubleProperty(name,1);
-              thisRoi.x2 = outArgs.getDoubleProperty(name,2);
-              thisRoi.y2 = outArgs.getDoubleProperty(name,3);
+              clipRoI->getValueN(&thisRoi.x1, 4);
+              if (OFX::IsNaN(thisRoi.x1) || OFX::IsNaN(thisRoi.y1) || OFX::IsNaN(thisRoi.x2) || OFX::IsNaN(thisRoi.y2)) {
+                throw Property::Exception(kOfxStatErrValue);
+              }
                   
               // and DON'T clamp it to the clip's rod
               // We cannot clip it against the RoD because the RoI may be used for frames
@@ -2034,8 +2292,10 @@ namespace OFX {
               // the host can do the correct clipping.
               //thisRoi = Clamp(thisRoi, rod);
               rois[it->second] = thisRoi;
+              continue;
             }
           }
+          rois.erase(it->second);
         }
         return stat;
       }
@@ -2310,7 +2570,13 @@ namespace OFX {
           return kOfxStatFailed;
         }
         OfxStatus stat = kOfxStatReplyDefault;
-        Property::Set outArgs;
+        static const Property::PropSpec outStuff[] = {
+          Property::propSpecEnd
+        };
+        Property::ReusableSet::Lease outArgs(_framesNeededOutArgs, outStuff);
+        // one frame range property per input clip, in the order of _clips
+        std::vector<Property::Property *> &clipRanges = outArgs.getExtraProperties();
+        size_t nClipRanges = 0;
       
         if(temporalAccess()) {
           static const Property::PropSpec inStuff[] = {
@@ -2320,26 +2586,30 @@ namespace OFX {
 #endif
             Property::propSpecEnd
           };
-          Property::Set inArgs(inStuff);       
-          inArgs.setDoubleProperty(kOfxPropTime,time);
+          Property::ReusableSet::Lease inArgs(_framesNeededInArgs, inStuff);
+          inArgs->setDoubleProperty(kOfxPropTime,time);
         
         
           for(std::map<std::string, ClipInstance*>::iterator it=_clips.begin();
               it!=_clips.end();
               ++it) {
             if(!it->second->isOutput()) {
-              Property::PropSpec s;
-              std::string name = "OfxImageClipPropFrameRange_"+it->first;
+              if (outArgs.isFresh()) {
+                Property::PropSpec s;
+                std::string name = "OfxImageClipPropFrameRange_"+it->first;
               
-              s.name = name.c_str();
-              s.type = Property::eDouble;
-              s.dimension = 0;
-              s.readonly = false;
-              s.defaultValue = "";
-              outArgs.createProperty(s);
+                s.name = name.c_str();
+                s.type = Property::eDouble;
+                s.dimension = 0;
+                s.readonly = false;
+                s.defaultValue = "";
+                outArgs->createProperty(s);
+                clipRanges.push_back(outArgs->fetchProperty(name));
+              }
+              Property::Double *clipRange = static_cast<Property::Double *>(clipRanges[nClipRanges++]);
               /// intialise it to the current frame
-              outArgs.setDoubleProperty(name, time, 0);
-              outArgs.setDoubleProperty(name, time, 1);
+              clipRange->setValue(time, 0);
+              clipRange->setValue(time, 1);
             }
           }
 
@@ -2350,8 +2620,8 @@ namespace OFX {
 #         endif
           stat = mainEntry(kOfxImageEffectActionGetFramesNeeded,
                            this->getHandle(),
-                           &inArgs,
-                           &outArgs);
+                           inArgs.get(),
+                           outArgs.get());
 #         ifdef OFX_DEBUG_ACTIONS
             std::cout << "OFX: "<<id<<"("<<(void*)ofxp<<")->"<<kOfxImageEffectActionGetFramesNeeded<<"("<<time<<")->"<<StatStr(stat);
             if (stat == kOfxStatOK) {
@@ -2365,10 +2635,10 @@ namespace OFX {
                         std::string name = "OfxImageClipPropFrameRange_"+it->first;
                         std::cout << it->first << "->[";
 
-                        int nRanges = outArgs.getDimension(name);
+                        int nRanges = outArgs->getDimension(name);
                         for(int r=0;r<nRanges;){
-                            double min = outArgs.getDoubleProperty(name,r);
-                            double max = outArgs.getDoubleProperty(name,r+1);
+                            double min = outArgs->getDoubleProperty(name,r);
+                            double max = outArgs->getDoubleProperty(name,r+1);
                             r += 2;
                             std::cout <<"("<<min<<","<<max<<")";
                             if (r < nRanges-1) {
@@ -2387,6 +2657,7 @@ namespace OFX {
         defaultRange.min = 
           defaultRange.max = time;
 
+        nClipRanges = 0;
         for(std::map<std::string, ClipInstance*>::iterator it=_clips.begin();
             it!=_clips.end();
             ++it) {
@@ -2397,9 +2668,9 @@ namespace OFX {
               rangeMap[clip].push_back(defaultRange);
             }
             else {
-              std::string name = "OfxImageClipPropFrameRange_"+it->first;
+              Property::Double *clipRange = static_cast<Property::Double *>(clipRanges[nClipRanges++]);
           
-              int nRanges = outArgs.getDimension(name);
+              int nRanges = clipRange->getDimension();
               if(nRanges%2 != 0)
                 return kOfxStatFailed; // bad! needs to be divisible by 2
 
@@ -2408,8 +2679,8 @@ namespace OFX {
               }
               else {
                 for(int r=0;r<nRanges;){
-                  double min = outArgs.getDoubleProperty(name,r);
-                  double max = outArgs.getDoubleProperty(name,r+1);
+                  double min = clipRange->getValue(r);
+                  double max = clipRange->getValue(r+1);
                   r += 2;
                 
                   OfxRangeD range;
@@ -2460,22 +2731,22 @@ namespace OFX {
           Property::propSpecEnd
         };
 
-        Property::Set inArgs(inStuff);        
+        Property::ReusableSet::Lease inArgs(_isIdentityInArgs, inStuff);
 
-        inArgs.setStringProperty(kOfxImageEffectPropFieldToRender,field);
-        inArgs.setDoubleProperty(kOfxPropTime,time);
-        inArgs.setIntPropertyN(kOfxImageEffectPropRenderWindow, &renderRoI.x1, 4);
-        inArgs.setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
+        inArgs->setStringProperty(kOfxImageEffectPropFieldToRender,field);
+        inArgs->setDoubleProperty(kOfxPropTime,time);
+        inArgs->setIntPropertyN(kOfxImageEffectPropRenderWindow, &renderRoI.x1, 4);
+        inArgs->setDoublePropertyN(kOfxImageEffectPropRenderScale, &renderScale.x, 2);
 #ifdef OFX_EXTENSIONS_NUKE
-        inArgs.setIntProperty(kFnOfxImageEffectPropView, view);
-        inArgs.setStringProperty(kOfxImageEffectPropIdentityPlane, plane);
+        inArgs->setIntProperty(kFnOfxImageEffectPropView, view);
+        inArgs->setStringProperty(kOfxImageEffectPropIdentityPlane, plane);
 #endif
           
-        Property::Set outArgs(outStuff);
+        Property::ReusableSet::Lease outArgs(_isIdentityOutArgs, outStuff);
 #ifdef OFX_EXTENSIONS_NUKE
         // set the default value on outArgs for backward compatibility
-        outArgs.setIntProperty(kFnOfxImageEffectPropView, view);
-        outArgs.setStringProperty(kOfxImageEffectPropIdentityPlane, plane);
+        outArgs->setIntProperty(kFnOfxImageEffectPropView, view);
+        outArgs->setStringProperty(kOfxImageEffectPropIdentityPlane, plane);
 #endif
 
 #       ifdef OFX_DEBUG_ACTIONS
@@ -2483,27 +2754,27 @@ namespace OFX {
           const char* id = ofxp->pluginIdentifier;
           std::cout << "OFX: "<<id<<"("<<(void*)ofxp<<")->"<<kOfxImageEffectActionIsIdentity<<"("<<time<<","<<field<<",("<<renderRoI.x1<<","<<renderRoI.y1<<","<<renderRoI.x2<<","<<renderRoI.y2<<"),("<<renderScale.x<<","<<renderScale.y<<"))"<<std::endl;
 #       endif
-        outArgs.setDoubleProperty(kOfxPropTime,time);
+        outArgs->setDoubleProperty(kOfxPropTime,time);
 
         OfxStatus st = mainEntry(kOfxImageEffectActionIsIdentity,
                                  this->getHandle(),
-                                 &inArgs,
-                                 &outArgs);        
+                                 inArgs.get(),
+                                 outArgs.get());        
 
 #       ifdef OFX_DEBUG_ACTIONS
           std::cout << "OFX: "<<id<<"("<<(void*)ofxp<<")->"<<kOfxImageEffectActionIsIdentity<<"("<<time<<","<<field<<",("<<renderRoI.x1<<","<<renderRoI.y1<<","<<renderRoI.x2<<","<<renderRoI.y2<<"),("<<renderScale.x<<","<<renderScale.y<<"))->"<<StatStr(st);
           if(st==kOfxStatOK){
-              std::cout << ": "<<outArgs.getDoubleProperty(kOfxPropTime)<<","<<outArgs.getStringProperty(kOfxPropName);
+              std::cout << ": "<<outArgs->getDoubleProperty(kOfxPropTime)<<","<<outArgs->getStringProperty(kOfxPropName);
           }
           std::cout<<std::endl;
 #       endif
 
         if(st==kOfxStatOK){
-          time = outArgs.getDoubleProperty(kOfxPropTime);
-          clip = outArgs.getStringProperty(kOfxPropName);
+          time = outArgs->getDoubleProperty(kOfxPropTime);
+          clip = outArgs->getStringProperty(kOfxPropName);
 #ifdef OFX_EXTENSIONS_NUKE
-          view = outArgs.getIntProperty(kFnOfxImageEffectPropView);
-          plane = outArgs.getStringProperty(kOfxImageEffectPropIdentityPlane);
+          view = outArgs->getIntProperty(kFnOfxImageEffectPropView);
+          plane = outArgs->getStringProperty(kOfxImageEffectPropIdentityPlane);
 #endif
         }
         
@@ -3246,7 +3517,7 @@ namespace OFX {
           return kOfxStatErrBadHandle;
         }
 
-        Image* image = clipInstance->getImage(time,h2);
+        Image* image = clipInstance->fetchImage(time,h2);
         if(!image) {
           *h3 = NULL;
 
@@ -3563,6 +3834,10 @@ namespace OFX {
 
             return kOfxStatFailed;
           }
+          if (view < 0 && clipInstance->getRenderContext()) {
+            // V1 of the suite has no view argument, use the one being rendered
+            view = clipInstance->getRenderView();
+          }
           Image* image = clipInstance->getImagePlane(time, view, plane, region);
           if(!image) {
             *imageHandle = NULL;
@@ -4062,72 +4337,47 @@ namespace OFX {
         return gImageEffectHost->mutexTryLock(mutex);
       }
 #else // !OFX_SUPPORTS_MULTITHREAD
-      /// a simple multithread suite
+      /// the multithread suite, running on the built in thread pool
       static OfxStatus multiThread(OfxThreadFunctionV1 func,
-                                   unsigned int /*nThreads*/,
+                                   unsigned int nThreads,
                                    void *customArg)
       {
-        if (!func)
-          return kOfxStatFailed;
-        func(0,1,customArg);
-        return kOfxStatOK;
+        return MultiThread::multiThread(func, nThreads, customArg);
       }
 
       static OfxStatus multiThreadNumCPUs(unsigned int *nCPUs)
       {
-        if (!nCPUs)
-          return kOfxStatFailed;
-        *nCPUs = 1;
-        return kOfxStatOK;
+        return MultiThread::multiThreadNumCPUs(nCPUs);
       }
 
       static OfxStatus multiThreadIndex(unsigned int *threadIndex){
-        if (!threadIndex)
-          return kOfxStatFailed;
-        *threadIndex = 0;
-        return kOfxStatOK;
+        return MultiThread::multiThreadIndex(threadIndex);
       }
 
       static int multiThreadIsSpawnedThread(void){
-        return false;
+        return MultiThread::multiThreadIsSpawnedThread();
       }
 
-      static OfxStatus mutexCreate(OfxMutexHandle *mutex, int /*lockCount*/)
+      static OfxStatus mutexCreate(OfxMutexHandle *mutex, int lockCount)
       {
-        if (!mutex)
-          return kOfxStatFailed;
-        // do nothing single threaded
-        *mutex = 0;
-        return kOfxStatOK;
+        return MultiThread::mutexCreate(mutex, lockCount);
       }
 
       static OfxStatus mutexDestroy(const OfxMutexHandle mutex)
       {
-        if (mutex != 0)
-          return kOfxStatErrBadHandle;
-        // do nothing single threaded
-        return kOfxStatOK;
+        return MultiThread::mutexDestroy(mutex);
       }
 
       static OfxStatus mutexLock(const OfxMutexHandle mutex){
-        if (mutex != 0)
-          return kOfxStatErrBadHandle;
-        // do nothing single threaded
-        return kOfxStatOK;
+        return MultiThread::mutexLock(mutex);
       }
        
       static OfxStatus mutexUnLock(const OfxMutexHandle mutex){
-        if (mutex != 0)
-          return kOfxStatErrBadHandle;
-        // do nothing single threaded
-        return kOfxStatOK;
+        return MultiThread::mutexUnLock(mutex);
       }       
 
       static OfxStatus mutexTryLock(const OfxMutexHandle mutex){
-        if (mutex != 0)
-          return kOfxStatErrBadHandle;
-        // do nothing single threaded
-        return kOfxStatOK;
+        return MultiThread::mutexTryLock(mutex);
       }
 #endif // !OFX_SUPPORTS_MULTITHREAD
        
@@ -4253,7 +4503,10 @@ namespace OFX {
           return instance;
         else{
           Memory::Instance* instance = new Memory::Instance;
-          instance->alloc(nBytes);
+          if(!instance->alloc(nBytes)) {
+            delete instance;
+            return 0;
+          }
           return instance;
         }
       }
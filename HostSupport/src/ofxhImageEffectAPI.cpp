@@ -70,6 +70,7 @@ namespace OFX {
         , _baseDescriptor(NULL)
         , _madeKnownContexts(false)
         , _pluginHandle()
+        , _describing(false)
       {
         _baseDescriptor = gImageEffectHost->makeDescriptor(this);
       }
@@ -88,6 +89,7 @@ namespace OFX {
         , _baseDescriptor(NULL) 
         , _madeKnownContexts(false)
         , _pluginHandle()
+        , _describing(false)
       {        
         _baseDescriptor = gImageEffectHost->makeDescriptor(this);
       }
@@ -112,13 +114,36 @@ namespace OFX {
       }
 
 
+      void ImageEffectPlugin::describeIfPending() const
+      {
+        if (!isDescribePending()) {
+          return;
+        }
+#if __cplusplus >= 201103L
+        std::lock_guard<std::recursive_mutex> guard(_describeMutex);
+#endif
+        // loadFromPlugin gets the descriptor again on this thread, and another
+        // thread may have finished the describe while we waited
+        if (_describing || !isDescribePending()) {
+          return;
+        }
+        ImageEffectPlugin *self = const_cast<ImageEffectPlugin *>(this);
+        _describing = true;
+        _pc.loadFromPlugin(self);
+        _describing = false;
+        // cleared last, so that other threads never see a half filled descriptor
+        self->setDescribePending(false);
+      }
+
       /// get the image effect descriptor
       Descriptor &ImageEffectPlugin::getDescriptor() {
+        describeIfPending();
         return *_baseDescriptor;
       }
 
       /// get the image effect descriptor const version
       const Descriptor &ImageEffectPlugin::getDescriptor() const {
+        describeIfPending();
         return *_baseDescriptor;
       }
 
@@ -147,6 +172,7 @@ namespace OFX {
       }
 
       const std::set<std::string> &ImageEffectPlugin::getContexts() const {
+        describeIfPending();
         if (_madeKnownContexts) {
           return _knownContexts;
         } 
@@ -163,6 +189,9 @@ namespace OFX {
 
       PluginHandle *ImageEffectPlugin::getPluginHandle() 
       {
+        // before we load the plugin for good, as describing runs the unload action
+        describeIfPending();
+
         if(!_pluginHandle.get()) {
           _pluginHandle.reset(new OFX::Host::PluginHandle(this, _pc.getHost())); 
           
@@ -210,6 +239,8 @@ namespace OFX {
 
       Descriptor *ImageEffectPlugin::getContext(const std::string &context) 
       {
+        describeIfPending();
+
         std::map<std::string, Descriptor *>::iterator it = _contexts.find(context);
 
         if (it != _contexts.end()) {
@@ -462,6 +493,10 @@ namespace OFX {
         }
       }
 
+      void PluginCache::deferLoadFromPlugin(Plugin *op) const {
+        op->setDescribePending(true);
+      }
+
       void PluginCache::unloadPlugin(Plugin *op) const {
         _host->loadingStatus(false, op->getRawIdentifier(), op->getVersionMajor(), op->getVersionMinor());
       }
@@ -553,6 +588,14 @@ namespace OFX {
         }
       }
 
+      Property::Set *PluginCache::getCacheProperties(Plugin *ip) const {
+        ImageEffectPlugin *p = dynamic_cast<ImageEffectPlugin*>(ip);
+        if (p) {
+          return &p->getDescriptor().getProps();
+        }
+        return 0;
+      }
+
       void PluginCache::confirmPlugin(Plugin *p, const std::list<std::string>& pluginPath) {
         ImageEffectPlugin *plugin = dynamic_cast<ImageEffectPlugin*>(p);
         if (!plugin) {
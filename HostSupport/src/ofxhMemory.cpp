@@ -36,24 +36,221 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // ofx host
 #include "ofxhMemory.h"
 
+#include <stdlib.h>
+#include <map>
+#include <vector>
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+#if defined(_WIN32) || defined(_WIN64)
+#include <malloc.h>
+#endif
+
 namespace OFX {
 
   namespace Host {
 
     namespace Memory {
 
-      Instance::Instance() : _ptr(NULL), _locked(0) {}
+      namespace {
+
+        /// default for the high water mark, 256Mb
+        const size_t kDefaultHighWaterMark = size_t(256) * 1024 * 1024;
+
+        void *alignedAlloc(size_t nBytes)
+        {
+#if defined(_WIN32) || defined(_WIN64)
+          return _aligned_malloc(nBytes, kPoolAlignment);
+#else
+          void *ptr = NULL;
+          if(posix_memalign(&ptr, kPoolAlignment, nBytes) != 0)
+            return NULL;
+          return ptr;
+#endif
+        }
+
+        void alignedFree(void *ptr)
+        {
+#if defined(_WIN32) || defined(_WIN64)
+          _aligned_free(ptr);
+#else
+          free(ptr);
+#endif
+        }
+
+        /// the largest size class, bigger blocks go straight to the system allocator.
+        /// Rounding anything larger up to a power of two could overflow a size_t.
+        const size_t kLargestSizeClass = (~size_t(0) >> 2) + 1;
+
+        /// round a size up to its size class, there are four classes per power of two
+        size_t sizeClass(size_t nBytes)
+        {
+          if(nBytes <= kPoolAlignment)
+            return kPoolAlignment;
+          if(nBytes > kLargestSizeClass)
+            return nBytes;
+          size_t power = kPoolAlignment;
+          while(power < nBytes)
+            power <<= 1;
+          size_t step = power / 8; // nBytes is in (power/2, power], split that in four
+          return (nBytes + step - 1) / step * step;
+        }
+
+        class Pool {
+        public :
+          Pool() : _highWaterMark(kDefaultHighWaterMark)
+          {
+            _stats.hits = _stats.misses = _stats.bytesInUse = _stats.bytesResident = 0;
+          }
+
+          ~Pool() { purge(); }
+
+          void *alloc(size_t nBytes, size_t &blockSize)
+          {
+            blockSize = sizeClass(nBytes);
+            {
+              Lock lock(*this);
+              std::map<size_t, std::vector<void *> >::iterator it = _free.find(blockSize);
+              if(it != _free.end() && !it->second.empty()) {
+                void *ptr = it->second.back();
+                it->second.pop_back();
+                ++_stats.hits;
+                _stats.bytesResident -= blockSize;
+                _stats.bytesInUse += blockSize;
+                return ptr;
+              }
+              ++_stats.misses;
+            }
+
+            void *ptr = alignedAlloc(blockSize);
+            if(ptr) {
+              Lock lock(*this);
+              _stats.bytesInUse += blockSize;
+            }
+            return ptr;
+          }
+
+          void free(void *ptr, size_t blockSize)
+          {
+            {
+              Lock lock(*this);
+              _stats.bytesInUse -= blockSize;
+              if(blockSize <= kLargestSizeClass && _stats.bytesResident + blockSize <= _highWaterMark) {
+                _free[blockSize].push_back(ptr);
+                _stats.bytesResident += blockSize;
+                return;
+              }
+            }
+            alignedFree(ptr);
+          }
+
+          void purge()
+          {
+            std::map<size_t, std::vector<void *> > blocks;
+            {
+              Lock lock(*this);
+              blocks.swap(_free);
+              _stats.bytesResident = 0;
+            }
+            for(std::map<size_t, std::vector<void *> >::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+              for(size_t i = 0; i < it->second.size(); ++i)
+                alignedFree(it->second[i]);
+            }
+          }
+
+          void setHighWaterMark(size_t nBytes)
+          {
+            {
+              Lock lock(*this);
+              _highWaterMark = nBytes;
+              if(_stats.bytesResident <= _highWaterMark)
+                return;
+            }
+            // simplest is to start again from an empty pool
+            purge();
+          }
+
+          size_t getHighWaterMark()
+          {
+            Lock lock(*this);
+            return _highWaterMark;
+          }
+
+          PoolStats getStats()
+          {
+            Lock lock(*this);
+            return _stats;
+          }
+
+        private :
+#if __cplusplus >= 201103L
+          typedef std::lock_guard<std::mutex> Guard;
+          struct Lock : Guard {
+            Lock(Pool &pool) : Guard(pool._mutex) {}
+          };
+          std::mutex _mutex;
+#else
+          // no portable mutex before C++11, the host must not allocate from several threads at once
+          struct Lock {
+            Lock(Pool &) {}
+          };
+#endif
+          std::map<size_t, std::vector<void *> > _free; ///< free blocks by size class
+          size_t    _highWaterMark;
+          PoolStats _stats;
+        };
+
+        Pool &pool()
+        {
+          static Pool gPool;
+          return gPool;
+        }
+
+      } // anonymous namespace
+
+      void *poolAlloc(size_t nBytes, size_t &blockSize)
+      {
+        return pool().alloc(nBytes, blockSize);
+      }
+
+      void poolFree(void *ptr, size_t blockSize)
+      {
+        if(ptr)
+          pool().free(ptr, blockSize);
+      }
+
+      void purgePool()
+      {
+        pool().purge();
+      }
+
+      void setPoolHighWaterMark(size_t nBytes)
+      {
+        pool().setHighWaterMark(nBytes);
+      }
+
+      size_t getPoolHighWaterMark()
+      {
+        return pool().getHighWaterMark();
+      }
+
+      PoolStats getPoolStats()
+      {
+        return pool().getStats();
+      }
+
+      Instance::Instance() : _ptr(NULL), _blockSize(0), _locked(0) {}
 
       Instance::~Instance() {
-        delete [] _ptr;
+        poolFree(_ptr, _blockSize);
       }
 
       bool Instance::alloc(size_t nBytes) {
         if(!_locked){
           if(_ptr)
             freeMem(); // ignore return value
-          _ptr = new char[nBytes];
-          return true;
+          _ptr = (char *) poolAlloc(nBytes, _blockSize);
+          return _ptr != NULL;
         }
         else
           return false;
@@ -64,8 +261,9 @@ namespace OFX {
       }
 
       bool Instance::freeMem(){
-        delete [] _ptr;
+        poolFree(_ptr, _blockSize);
         _ptr = 0;
+        _blockSize = 0;
         _locked = 0;
         return true;
       }
@@ -89,4 +287,3 @@ namespace OFX {
   } // Host
 
 } // OFX
-
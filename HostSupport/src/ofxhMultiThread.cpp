@@ -0,0 +1,616 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+// ofx
+#include "ofxCore.h"
+#include "ofxMultiThread.h"
+
+// ofx host
+#include "ofxhMultiThread.h"
+
+#if __cplusplus >= 201103L
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+#endif
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace MultiThread {
+
+#if __cplusplus >= 201103L
+
+      namespace {
+
+        /// the work spawned by a single call to multiThread
+        struct Batch {
+          Batch(OfxThreadFunctionV1 *f, unsigned int n, void *arg, const void *c)
+            : func(f), nThreads(n), customArg(arg), context(c), next(0), failed(false), users(0)
+          {}
+
+          OfxThreadFunctionV1 *func;
+          unsigned int nThreads;
+          void *customArg;
+          const void *context;             ///< the context of the thread that made the batch
+          std::atomic<unsigned int> next;  ///< next thread index to be claimed
+          std::atomic<bool> failed;        ///< an item threw
+          unsigned int users;              ///< thieves working on the batch, guarded by mutex
+          std::mutex mutex;
+          std::condition_variable cond;    ///< signalled when users drops to 0
+        };
+
+        /// batches pushed by one thread, that other threads can steal from
+        struct WorkQueue {
+          std::mutex mutex;
+          std::deque<Batch *> batches;
+        };
+
+        /// the thread index and spawned status seen by the current thread
+        thread_local unsigned int tlsThreadIndex = 0;
+        thread_local bool tlsIsSpawned = false;
+
+        /// see getThreadContext
+        thread_local const void *tlsContext = 0;
+
+        /// the work queue owned by the current thread, 0 for threads not in the pool
+        thread_local size_t tlsQueue = 0;
+
+        /// run one item of a batch, with the thread index and context set as the plugin expects
+        void runItem(Batch &batch, unsigned int index)
+        {
+          unsigned int savedIndex = tlsThreadIndex;
+          bool savedSpawned = tlsIsSpawned;
+          const void *savedContext = tlsContext;
+          tlsThreadIndex = index;
+          tlsIsSpawned = true;
+          tlsContext = batch.context;
+          try {
+            batch.func(index, batch.nThreads, batch.customArg);
+          }
+          catch (...) {
+            // plugins should never throw across the API, multiThread reports it as a failure
+            batch.failed.store(true, std::memory_order_relaxed);
+          }
+          tlsThreadIndex = savedIndex;
+          tlsIsSpawned = savedSpawned;
+          tlsContext = savedContext;
+        }
+
+        /// claim and run items of a batch until there are none left
+        void drainBatch(Batch &batch)
+        {
+          unsigned int index;
+          while((index = batch.next.fetch_add(1)) < batch.nThreads)
+            runItem(batch, index);
+        }
+
+        unsigned int hardwareThreads()
+        {
+          unsigned int n = std::thread::hardware_concurrency();
+          return n > 0 ? n : 1;
+        }
+
+        /// persistent pool of worker threads with one work queue per worker
+        class ThreadPool {
+        public :
+          ThreadPool() : _maxThreads(0), _started(false), _stop(false), _signal(0) {}
+
+          ~ThreadPool() { stop(); }
+
+          void setMaxThreads(unsigned int nThreads)
+          {
+            std::lock_guard<std::mutex> guard(_poolMutex);
+            if(nThreads != _maxThreads) {
+              stopLocked();
+              _maxThreads = nThreads;
+            }
+          }
+
+          unsigned int getMaxThreads()
+          {
+            std::lock_guard<std::mutex> guard(_poolMutex);
+            return _maxThreads ? _maxThreads : hardwareThreads();
+          }
+
+          OfxStatus multiThread(OfxThreadFunctionV1 *func, unsigned int nThreads, void *customArg)
+          {
+            Batch batch(func, nThreads, customArg, tlsContext);
+
+            if(nThreads == 1 || !start()) {
+              // nothing to share the work with
+              drainBatch(batch);
+              return batch.failed.load(std::memory_order_relaxed) ? kOfxStatFailed : kOfxStatOK;
+            }
+
+            WorkQueue &queue = *_queues[tlsQueue];
+            {
+              std::lock_guard<std::mutex> guard(queue.mutex);
+              queue.batches.push_back(&batch);
+            }
+            wake();
+
+            // do our share of the work, then make sure nobody can steal the batch any more
+            drainBatch(batch);
+            {
+              std::lock_guard<std::mutex> guard(queue.mutex);
+              queue.batches.erase(std::find(queue.batches.begin(), queue.batches.end(), &batch));
+            }
+
+            // wait for the thieves still running items
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            while(batch.users > 0)
+              batch.cond.wait(lock);
+            return batch.failed.load(std::memory_order_relaxed) ? kOfxStatFailed : kOfxStatOK;
+          }
+
+        private :
+          /// start the workers if need be, returns false if the pool has no workers
+          bool start()
+          {
+            if(_started.load(std::memory_order_acquire))
+              return _threads.size() > 0;
+
+            std::lock_guard<std::mutex> guard(_poolMutex);
+            if(!_started.load(std::memory_order_relaxed)) {
+              unsigned int nWorkers = (_maxThreads ? _maxThreads : hardwareThreads()) - 1;
+              _stop = false;
+              // queue 0 is shared by all the threads outside of the pool
+              for(unsigned int i = 0; i <= nWorkers; ++i)
+                _queues.push_back(new WorkQueue);
+              try {
+                for(unsigned int i = 0; i < nWorkers; ++i)
+                  _threads.push_back(std::thread(&ThreadPool::workerMain, this, i + 1));
+              }
+              catch (const std::system_error &) {
+                // run with the workers we managed to make
+              }
+              _started.store(true, std::memory_order_release);
+            }
+            return _threads.size() > 0;
+          }
+
+          void stop()
+          {
+            std::lock_guard<std::mutex> guard(_poolMutex);
+            stopLocked();
+          }
+
+          void stopLocked()
+          {
+            if(!_started.load(std::memory_order_relaxed))
+              return;
+            {
+              std::lock_guard<std::mutex> guard(_sleepMutex);
+              _stop = true;
+            }
+            _sleepCond.notify_all();
+            for(size_t i = 0; i < _threads.size(); ++i)
+              _threads[i].join();
+            _threads.clear();
+            for(size_t i = 0; i < _queues.size(); ++i)
+              delete _queues[i];
+            _queues.clear();
+            _started.store(false, std::memory_order_release);
+          }
+
+          /// tell sleeping workers that there is work about
+          void wake()
+          {
+            {
+              std::lock_guard<std::mutex> guard(_sleepMutex);
+              ++_signal;
+            }
+            _sleepCond.notify_all();
+          }
+
+          /// find a batch with unclaimed items, looking in our own queue first
+          Batch *steal(size_t self)
+          {
+            size_t nQueues = _queues.size();
+            for(size_t i = 0; i < nQueues; ++i) {
+              WorkQueue &queue = *_queues[(self + i) % nQueues];
+              std::lock_guard<std::mutex> guard(queue.mutex);
+              // newest first, nested batches are at the back
+              for(std::deque<Batch *>::reverse_iterator it = queue.batches.rbegin(); it != queue.batches.rend(); ++it) {
+                Batch *batch = *it;
+                if(batch->next.load(std::memory_order_relaxed) < batch->nThreads) {
+                  // the owner can't remove the batch while we hold the queue lock
+                  std::lock_guard<std::mutex> batchGuard(batch->mutex);
+                  ++batch->users;
+                  return batch;
+                }
+              }
+            }
+            return 0;
+          }
+
+          void workerMain(size_t self)
+          {
+            tlsQueue = self;
+            for(;;) {
+              unsigned long long signal;
+              {
+                std::lock_guard<std::mutex> guard(_sleepMutex);
+                if(_stop)
+                  return;
+                signal = _signal;
+              }
+
+              if(Batch *batch = steal(self)) {
+                drainBatch(*batch);
+                std::lock_guard<std::mutex> guard(batch->mutex);
+                if(--batch->users == 0)
+                  batch->cond.notify_all();
+                continue;
+              }
+
+              std::unique_lock<std::mutex> lock(_sleepMutex);
+              while(!_stop && signal == _signal)
+                _sleepCond.wait(lock);
+            }
+          }
+
+          unsigned int _maxThreads;
+          std::atomic<bool> _started;
+          std::mutex _poolMutex;           ///< guards starting and stopping the pool
+          std::vector<std::thread> _threads;
+          std::vector<WorkQueue *> _queues;
+
+          std::mutex _sleepMutex;
+          std::condition_variable _sleepCond;
+          bool _stop;
+          unsigned long long _signal;      ///< bumped each time work is pushed
+        };
+
+        ThreadPool &pool()
+        {
+          static ThreadPool gPool;
+          return gPool;
+        }
+
+        /// hint to the CPU that we are in a spin loop
+        inline void cpuRelax()
+        {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+          _mm_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+          __builtin_ia32_pause();
+#endif
+        }
+
+        /// unique per thread, its address identifies the thread owning a mutex
+        thread_local char tlsThreadTag;
+
+        /// recursive mutex, futex style.
+        ///
+        /// _state is 0 when unlocked, 1 when locked and 2 when locked with threads
+        /// (possibly) parked on it. Only the owner touches _count.
+        class Mutex {
+        public :
+          enum { kMagic = 0x6d757478, kSpinCount = 100 };
+
+          explicit Mutex(int lockCount)
+            : _magic(kMagic), _state(0), _owner(0), _count(0)
+          {
+            if(lockCount > 0) {
+              _state.store(1, std::memory_order_relaxed);
+              _owner.store(&tlsThreadTag, std::memory_order_relaxed);
+              _count = lockCount;
+            }
+          }
+
+          ~Mutex() { _magic = 0; }
+
+          bool verifyMagic() const { return _magic == kMagic; }
+
+          void lock()
+          {
+            if(_owner.load(std::memory_order_relaxed) == &tlsThreadTag) {
+              ++_count;
+              return;
+            }
+
+            int c = 0;
+            if(!_state.compare_exchange_strong(c, 1, std::memory_order_acquire)) {
+              // contended, spin for a while in case the owner is about to let go
+              for(int i = 0; i < kSpinCount; ++i) {
+                cpuRelax();
+                c = _state.load(std::memory_order_relaxed);
+                // c is left non zero if the exchange fails
+                if(c == 0 && _state.compare_exchange_strong(c, 1, std::memory_order_acquire))
+                  break;
+              }
+              // still not ours, mark the mutex as waited on and park until released
+              if(c != 0) {
+                if(c != 2)
+                  c = _state.exchange(2, std::memory_order_acquire);
+                while(c != 0) {
+                  {
+                    std::unique_lock<std::mutex> lock(_parkMutex);
+                    while(_state.load(std::memory_order_relaxed) == 2)
+                      _parkCond.wait(lock);
+                  }
+                  c = _state.exchange(2, std::memory_order_acquire);
+                }
+              }
+            }
+
+            _owner.store(&tlsThreadTag, std::memory_order_relaxed);
+            _count = 1;
+          }
+
+          bool tryLock()
+          {
+            if(_owner.load(std::memory_order_relaxed) == &tlsThreadTag) {
+              ++_count;
+              return true;
+            }
+            int c = 0;
+            if(!_state.compare_exchange_strong(c, 1, std::memory_order_acquire))
+              return false;
+            _owner.store(&tlsThreadTag, std::memory_order_relaxed);
+            _count = 1;
+            return true;
+          }
+
+          bool unlock()
+          {
+            if(_owner.load(std::memory_order_relaxed) != &tlsThreadTag)
+              return false;
+            if(--_count > 0)
+              return true;
+
+            _owner.store(0, std::memory_order_relaxed);
+            if(_state.fetch_sub(1, std::memory_order_release) != 1) {
+              // someone is parked, release fully and wake one of them
+              _state.store(0, std::memory_order_release);
+              { std::lock_guard<std::mutex> guard(_parkMutex); }
+              _parkCond.notify_one();
+            }
+            return true;
+          }
+
+        private :
+          int _magic;
+          std::atomic<int> _state;
+          std::atomic<char *> _owner;
+          int _count;
+          std::mutex _parkMutex;
+          std::condition_variable _parkCond;
+        };
+
+      } // anonymous namespace
+
+      void setMaxThreads(unsigned int nThreads)
+      {
+        pool().setMaxThreads(nThreads);
+      }
+
+      unsigned int getMaxThreads()
+      {
+        return pool().getMaxThreads();
+      }
+
+      OfxStatus multiThread(OfxThreadFunctionV1 func, unsigned int nThreads, void *customArg)
+      {
+        if (!func)
+          return kOfxStatFailed;
+        return pool().multiThread(func, nThreads ? nThreads : 1, customArg);
+      }
+
+      OfxStatus multiThreadIndex(unsigned int *threadIndex)
+      {
+        if (!threadIndex)
+          return kOfxStatFailed;
+        *threadIndex = tlsThreadIndex;
+        return kOfxStatOK;
+      }
+
+      int multiThreadIsSpawnedThread()
+      {
+        return tlsIsSpawned;
+      }
+
+      const void *getThreadContext()
+      {
+        return tlsContext;
+      }
+
+      void setThreadContext(const void *context)
+      {
+        tlsContext = context;
+      }
+
+      OfxStatus mutexCreate(OfxMutexHandle *mutex, int lockCount)
+      {
+        if (!mutex)
+          return kOfxStatFailed;
+        *mutex = (OfxMutexHandle) new Mutex(lockCount);
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexDestroy(const OfxMutexHandle mutex)
+      {
+        Mutex *m = (Mutex *) mutex;
+        if (!m || !m->verifyMagic())
+          return kOfxStatErrBadHandle;
+        delete m;
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexLock(const OfxMutexHandle mutex)
+      {
+        Mutex *m = (Mutex *) mutex;
+        if (!m || !m->verifyMagic())
+          return kOfxStatErrBadHandle;
+        m->lock();
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexUnLock(const OfxMutexHandle mutex)
+      {
+        Mutex *m = (Mutex *) mutex;
+        if (!m || !m->verifyMagic())
+          return kOfxStatErrBadHandle;
+        return m->unlock() ? kOfxStatOK : kOfxStatFailed;
+      }
+
+      OfxStatus mutexTryLock(const OfxMutexHandle mutex)
+      {
+        Mutex *m = (Mutex *) mutex;
+        if (!m || !m->verifyMagic())
+          return kOfxStatErrBadHandle;
+        return m->tryLock() ? kOfxStatOK : kOfxStatFailed;
+      }
+
+#else // __cplusplus < 201103L
+
+      /// no portable threads, everything runs on the calling thread
+      void setMaxThreads(unsigned int /*nThreads*/)
+      {
+      }
+
+      unsigned int getMaxThreads()
+      {
+        return 1;
+      }
+
+      OfxStatus multiThread(OfxThreadFunctionV1 func, unsigned int /*nThreads*/, void *customArg)
+      {
+        if (!func)
+          return kOfxStatFailed;
+        try {
+          func(0,1,customArg);
+        }
+        catch (...) {
+          // plugins should never throw across the API
+          return kOfxStatFailed;
+        }
+        return kOfxStatOK;
+      }
+
+      OfxStatus multiThreadIndex(unsigned int *threadIndex)
+      {
+        if (!threadIndex)
+          return kOfxStatFailed;
+        *threadIndex = 0;
+        return kOfxStatOK;
+      }
+
+      int multiThreadIsSpawnedThread()
+      {
+        return false;
+      }
+
+      /// see getThreadContext, the work items run on the calling thread so they see it anyway
+      static const void *gContext = 0;
+
+      const void *getThreadContext()
+      {
+        return gContext;
+      }
+
+      void setThreadContext(const void *context)
+      {
+        gContext = context;
+      }
+
+      /// single threaded, a mutex only has to count its locks
+      struct Mutex {
+        int count;
+      };
+
+      OfxStatus mutexCreate(OfxMutexHandle *mutex, int lockCount)
+      {
+        if (!mutex)
+          return kOfxStatFailed;
+        Mutex *m = new Mutex;
+        m->count = lockCount > 0 ? lockCount : 0;
+        *mutex = (OfxMutexHandle) m;
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexDestroy(const OfxMutexHandle mutex)
+      {
+        if (!mutex)
+          return kOfxStatErrBadHandle;
+        delete (Mutex *) mutex;
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexLock(const OfxMutexHandle mutex)
+      {
+        if (!mutex)
+          return kOfxStatErrBadHandle;
+        ++((Mutex *) mutex)->count;
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexUnLock(const OfxMutexHandle mutex)
+      {
+        if (!mutex)
+          return kOfxStatErrBadHandle;
+        Mutex *m = (Mutex *) mutex;
+        if (m->count <= 0)
+          return kOfxStatFailed;
+        --m->count;
+        return kOfxStatOK;
+      }
+
+      OfxStatus mutexTryLock(const OfxMutexHandle mutex)
+      {
+        return mutexLock(mutex);
+      }
+
+#endif // __cplusplus < 201103L
+
+      OfxStatus multiThreadNumCPUs(unsigned int *nCPUs)
+      {
+        if (!nCPUs)
+          return kOfxStatFailed;
+        *nCPUs = getMaxThreads();
+        return kOfxStatOK;
+      }
+
+    } // MultiThread
+
+  } // Host
+
+} // OFX
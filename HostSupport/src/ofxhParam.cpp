@@ -51,8 +51,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assert.h>
 #include <float.h>
 #include <limits.h>
+#include <math.h>
 #include <stdarg.h>
 #include <sstream> // stringstream
+#include <vector>
+#include <algorithm>
 
 namespace OFX {
 
@@ -850,24 +853,98 @@ namespace OFX {
       // KeyframeParam
       // 
 
-      OfxStatus KeyframeParam::getNumKeys(unsigned int &/*nKeys*/) const {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus KeyframeParam::getNumKeys(unsigned int &nKeys) const {
+        if(!_usesCurve)
+          return kOfxStatErrMissingHostFeature;
+        nKeys = (unsigned int) _curve.getNumKeys();
+        return kOfxStatOK;
       }
 
-      OfxStatus KeyframeParam::getKeyTime(int /*nth*/, OfxTime& /*time*/) const {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus KeyframeParam::getKeyTime(int nth, OfxTime& time) const {
+        if(!_usesCurve)
+          return kOfxStatErrMissingHostFeature;
+        if(nth < 0 || nth >= _curve.getNumKeys())
+          return kOfxStatErrBadIndex;
+        time = _curve.getKeyTime(nth);
+        return kOfxStatOK;
       }
 
-      OfxStatus KeyframeParam::getKeyIndex(OfxTime /*time*/, int /*direction*/, int & /*index*/) const {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus KeyframeParam::getKeyIndex(OfxTime time, int direction, int & index) const {
+        if(!_usesCurve)
+          return kOfxStatErrMissingHostFeature;
+        index = _curve.getKeyIndex(time, direction);
+        return index < 0 ? kOfxStatFailed : kOfxStatOK;
       }
 
-      OfxStatus KeyframeParam::deleteKey(OfxTime /*time*/) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus KeyframeParam::deleteKey(OfxTime time) {
+        if(!_usesCurve)
+          return kOfxStatErrMissingHostFeature;
+        return _curve.deleteKey(time) ? kOfxStatOK : kOfxStatErrBadIndex;
       }
 
       OfxStatus KeyframeParam::deleteAllKeys() { 
-        return kOfxStatErrMissingHostFeature; 
+        if(!_usesCurve)
+          return kOfxStatErrMissingHostFeature;
+        _curve.deleteAllKeys();
+        return kOfxStatOK;
+      }
+
+      OfxStatus KeyframeParam::setKeyValues(OfxTime time, const double *values) {
+        if(!_usesCurve)
+          return kOfxStatErrMissingHostFeature;
+        if(OFX::IsNaN(time))
+          return kOfxStatErrValue;
+        _curve.setKey(time, values);
+        return kOfxStatOK;
+      }
+
+      bool KeyframeParam::getKeyedValues(OfxTime time, double *values) const {
+        return _usesCurve && _curve.getValue(time, values);
+      }
+
+      OfxStatus KeyframeParam::getValueAtTime(OfxTime /*time*/, double * /*values*/) {
+        return kOfxStatErrMissingHostFeature;
+      }
+
+      OfxStatus KeyframeParam::deriveCurve(OfxTime time, double *values) {
+        if(_usesCurve && _curve.getDerivative(time, values))
+          return kOfxStatOK;
+
+        // the host keeps its own keys, difference the values half a frame either side
+        int n = _curve.getDimension();
+        std::vector<double> before(n), after(n);
+        OfxStatus stat = getValueAtTime(time - 0.5, n ? &before[0] : 0);
+        if(stat == kOfxStatOK)
+          stat = getValueAtTime(time + 0.5, n ? &after[0] : 0);
+        if(stat != kOfxStatOK)
+          return stat;
+        for(int d = 0; d < n; ++d)
+          values[d] = after[d] - before[d];
+        return kOfxStatOK;
+      }
+
+      OfxStatus KeyframeParam::integrateCurve(OfxTime time1, OfxTime time2, double *values) {
+        if(_usesCurve && _curve.getIntegral(time1, time2, values))
+          return kOfxStatOK;
+
+        // the host keeps its own keys, Simpson's rule with samples every half frame or so
+        int n = _curve.getDimension();
+        int nSteps = 2 * (int) ceil(fabs(time2 - time1));
+        nSteps = std::min(std::max(nSteps, 2), 2048);
+        double step = (time2 - time1) / nSteps;
+        std::vector<double> sample(n);
+        std::fill(values, values + n, 0.);
+        for(int i = 0; i <= nSteps; ++i) {
+          OfxStatus stat = getValueAtTime(time1 + i * step, n ? &sample[0] : 0);
+          if(stat != kOfxStatOK)
+            return stat;
+          double weight = (i == 0 || i == nSteps) ? 1. : (i % 2 ? 4. : 2.);
+          for(int d = 0; d < n; ++d)
+            values[d] += weight * sample[d];
+        }
+        for(int d = 0; d < n; ++d)
+          values[d] *= step / 3.;
+        return kOfxStatOK;
       }
 
       //
@@ -939,6 +1016,7 @@ namespace OFX {
       /// make a parameter, with the given type and name
       ChoiceInstance::ChoiceInstance(Descriptor& descriptor, Param::SetInstance* instance)
         : Instance(descriptor,instance)
+        , KeyframeParam(1, AnimationCurve::eInterpolationConstant)
       {
         _properties.addNotifyHook(kOfxParamPropChoiceOption, this);
       }
@@ -1018,12 +1096,29 @@ namespace OFX {
       //
       // IntegerInstance
       //
-      OfxStatus IntegerInstance::derive(OfxTime /*time*/, int&) {
-        return kOfxStatErrUnsupported; 
+      OfxStatus IntegerInstance::derive(OfxTime time, int& i) {
+        double values[1];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          i = (int) floor(values[0] + 0.5);
+        }
+        return stat;
+      }
+
+      OfxStatus IntegerInstance::integrate(OfxTime time1, OfxTime time2, int& i) {
+        double values[1];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          i = (int) floor(values[0] + 0.5);
+        }
+        return stat;
       }
 
-      OfxStatus IntegerInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, int&) {
-        return kOfxStatErrUnsupported; 
+      OfxStatus IntegerInstance::getValueAtTime(OfxTime time, double *values) {
+        int i;
+        OfxStatus stat = get(time, i);
+        values[0] = i;
+        return stat;
       }
 
       /// implementation of var args function
@@ -1113,6 +1208,28 @@ namespace OFX {
       //
       // DoubleInstance
       //
+      OfxStatus DoubleInstance::derive(OfxTime time, double& d) {
+        double values[1];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          d = values[0];
+        }
+        return stat;
+      }
+
+      OfxStatus DoubleInstance::integrate(OfxTime time1, OfxTime time2, double& d) {
+        double values[1];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          d = values[0];
+        }
+        return stat;
+      }
+
+      OfxStatus DoubleInstance::getValueAtTime(OfxTime time, double *values) {
+        return get(time, values[0]);
+      }
+
       /// implementation of var args function
       OfxStatus DoubleInstance::getV(va_list arg)
       {
@@ -1260,12 +1377,32 @@ namespace OFX {
       // RGBAInstance
       // 
 
-      OfxStatus RGBAInstance::derive(OfxTime /*time*/, double&, double&, double&, double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus RGBAInstance::derive(OfxTime time, double& r,double& g,double& b,double& a) {
+        double values[4];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          r = values[0];
+          g = values[1];
+          b = values[2];
+          a = values[3];
+        }
+        return stat;
       }
 
-      OfxStatus RGBAInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, double&,double&,double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus RGBAInstance::integrate(OfxTime time1, OfxTime time2, double& r,double& g,double& b,double& a) {
+        double values[4];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          r = values[0];
+          g = values[1];
+          b = values[2];
+          a = values[3];
+        }
+        return stat;
+      }
+
+      OfxStatus RGBAInstance::getValueAtTime(OfxTime time, double *values) {
+        return get(time, values[0], values[1], values[2], values[3]);
       }
 
       /// implementation of var args function
@@ -1373,12 +1510,30 @@ namespace OFX {
       //
       // RGBInstance
       //
-      OfxStatus RGBInstance::derive(OfxTime /*time*/, double&,double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus RGBInstance::derive(OfxTime time, double& r,double& g,double& b) {
+        double values[3];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          r = values[0];
+          g = values[1];
+          b = values[2];
+        }
+        return stat;
       }
 
-      OfxStatus RGBInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, double&,double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus RGBInstance::integrate(OfxTime time1, OfxTime time2, double& r,double& g,double& b) {
+        double values[3];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          r = values[0];
+          g = values[1];
+          b = values[2];
+        }
+        return stat;
+      }
+
+      OfxStatus RGBInstance::getValueAtTime(OfxTime time, double *values) {
+        return get(time, values[0], values[1], values[2]);
       }
 
       /// implementation of var args function
@@ -1481,12 +1636,28 @@ namespace OFX {
       // Double2DInstance
       //
 
-      OfxStatus Double2DInstance::derive(OfxTime /*time*/, double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Double2DInstance::derive(OfxTime time, double& x,double& y) {
+        double values[2];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          x = values[0];
+          y = values[1];
+        }
+        return stat;
       }
 
-      OfxStatus Double2DInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Double2DInstance::integrate(OfxTime time1, OfxTime time2, double& x,double& y) {
+        double values[2];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          x = values[0];
+          y = values[1];
+        }
+        return stat;
+      }
+
+      OfxStatus Double2DInstance::getValueAtTime(OfxTime time, double *values) {
+        return get(time, values[0], values[1]);
       }
 
       OfxStatus Double2DInstance::getV(va_list arg)
@@ -1582,12 +1753,32 @@ namespace OFX {
       // Integer2DInstance
       //
 
-      OfxStatus Integer2DInstance::derive(OfxTime /*time*/, int&,int&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Integer2DInstance::derive(OfxTime time, int& x,int& y) {
+        double values[2];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          x = (int) floor(values[0] + 0.5);
+          y = (int) floor(values[1] + 0.5);
+        }
+        return stat;
       }
 
-      OfxStatus Integer2DInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, int&,int&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Integer2DInstance::integrate(OfxTime time1, OfxTime time2, int& x,int& y) {
+        double values[2];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          x = (int) floor(values[0] + 0.5);
+          y = (int) floor(values[1] + 0.5);
+        }
+        return stat;
+      }
+
+      OfxStatus Integer2DInstance::getValueAtTime(OfxTime time, double *values) {
+        int x, y;
+        OfxStatus stat = get(time, x, y);
+        values[0] = x;
+        values[1] = y;
+        return stat;
       }
 
       OfxStatus Integer2DInstance::getV(va_list arg)
@@ -1683,12 +1874,30 @@ namespace OFX {
       // Double3DInstance
       //
 
-      OfxStatus Double3DInstance::derive(OfxTime /*time*/, double&,double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Double3DInstance::derive(OfxTime time, double& x,double& y,double& z) {
+        double values[3];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          x = values[0];
+          y = values[1];
+          z = values[2];
+        }
+        return stat;
       }
 
-      OfxStatus Double3DInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, double&,double&,double&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Double3DInstance::integrate(OfxTime time1, OfxTime time2, double& x,double& y,double& z) {
+        double values[3];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          x = values[0];
+          y = values[1];
+          z = values[2];
+        }
+        return stat;
+      }
+
+      OfxStatus Double3DInstance::getValueAtTime(OfxTime time, double *values) {
+        return get(time, values[0], values[1], values[2]);
       }
 
       OfxStatus Double3DInstance::getV(va_list arg)
@@ -1789,12 +1998,35 @@ namespace OFX {
       //
       // Integer3DInstance
       //
-      OfxStatus Integer3DInstance::derive(OfxTime /*time*/, int&,int&,int&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Integer3DInstance::derive(OfxTime time, int& x,int& y,int& z) {
+        double values[3];
+        OfxStatus stat = deriveCurve(time, values);
+        if(stat == kOfxStatOK) {
+          x = (int) floor(values[0] + 0.5);
+          y = (int) floor(values[1] + 0.5);
+          z = (int) floor(values[2] + 0.5);
+        }
+        return stat;
       }
 
-      OfxStatus Integer3DInstance::integrate(OfxTime /*time1*/, OfxTime /*time2*/, int&,int&,int&) {
-        return kOfxStatErrMissingHostFeature; 
+      OfxStatus Integer3DInstance::integrate(OfxTime time1, OfxTime time2, int& x,int& y,int& z) {
+        double values[3];
+        OfxStatus stat = integrateCurve(time1, time2, values);
+        if(stat == kOfxStatOK) {
+          x = (int) floor(values[0] + 0.5);
+          y = (int) floor(values[1] + 0.5);
+          z = (int) floor(values[2] + 0.5);
+        }
+        return stat;
+      }
+
+      OfxStatus Integer3DInstance::getValueAtTime(OfxTime time, double *values) {
+        int x, y, z;
+        OfxStatus stat = get(time, x, y, z);
+        values[0] = x;
+        values[1] = y;
+        values[2] = z;
+        return stat;
       }
 
       OfxStatus Integer3DInstance::getV(va_list arg)
@@ -59,6 +59,32 @@ namespace OFX
         pluginCache.registerAPICache(_apiName, _apiVersionMin, _apiVersionMax, this);
       }      
 
+      Property::Property *propertySetDefine(Property::Set &set, const std::string &name, Property::TypeEnum type, int dimension)
+      {
+        Property::Property *prop = set.fetchProperty(name, false);
+
+        if(!prop) {
+          switch (type) {
+          case Property::eInt:
+            prop = new Property::Int(name, dimension, false, 0);
+            break;
+          case Property::eString:
+            prop = new Property::String(name, dimension, false, "");
+            break;
+          case Property::eDouble:
+            prop = new Property::Double(name, dimension, false, 0);
+            break;
+          case Property::ePointer:
+            prop = new Property::Pointer(name, dimension, false, 0);
+            break;
+          default:
+            return 0;
+          }
+          set.addProperty(prop);
+        }
+        return prop;
+      }
+
       void propertySetXMLRead(const std::string &el,
                               std::map<std::string, std::string> map,
                               Property::Set &set,
@@ -68,20 +94,17 @@ namespace OFX
           std::string propType = map["type"];
           int dimension = atoi(map["dimension"].c_str());
           
-          currentProp = set.fetchProperty(propName, false);
-          
-          if(!currentProp) {
-            if (propType == "int") {
-              currentProp = new Property::Int(propName, dimension, false, 0);
-            } else if (propType == "string") {
-              currentProp = new Property::String(propName, dimension, false, "");
-            } else if (propType == "double") {
-              currentProp = new Property::Double(propName, dimension, false, 0);
-            } else if (propType == "pointer") {
-              currentProp = new Property::Pointer(propName, dimension, false, 0);
-            }
-            set.addProperty(currentProp);
+          Property::TypeEnum type = Property::eNone;
+          if (propType == "int") {
+            type = Property::eInt;
+          } else if (propType == "string") {
+            type = Property::eString;
+          } else if (propType == "double") {
+            type = Property::eDouble;
+          } else if (propType == "pointer") {
+            type = Property::ePointer;
           }
+          currentProp = propertySetDefine(set, propName, type, dimension);
           return;
         }
         
@@ -49,6 +49,7 @@
 #include "ofxhBinary.h"
 #include "ofxhPropertySuite.h"
 #include "ofxhMemory.h"
+#include "ofxhMultiThread.h"
 #include "ofxhPluginAPICache.h"
 #include "ofxhPluginCache.h"
 #include "ofxhHost.h"
@@ -104,6 +105,14 @@ static const char *getArchStr()
 #include "shlobj.h"
 #endif
 
+#if defined (UNIX)
+// to map binary caches
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 bool OFX::Host::PluginCache::_useStdOFXPluginsLocation = true;
 OFX::Host::PluginCache* OFX::Host::PluginCache::gPluginCachePtr = 0;
@@ -127,8 +136,9 @@ void PluginBinary::loadPluginInfo(PluginCache *cache) {
     // Take a reference to load the binary only once per session. It will
     // eventually be unloaded in the destructor (see below).
     // This avoid lots of useless calls to dlopen()/dlclose().
-    if (!_binary->isLoaded()) {
+    if (!_ownsBinaryRef) {
       _binary->ref();
+      _ownsBinaryRef = true;
     }
   }
 
@@ -160,6 +170,17 @@ void PluginBinary::loadPluginInfo(PluginCache *cache) {
   }
 }
 
+void PluginBinary::releaseBinary() {
+  if (_binary && _ownsBinaryRef) {
+    // the entry points are looked up again when the binary is next loaded,
+    // it may not be mapped at the same address
+    _getNumberOfPlugins = 0;
+    _getPluginFunc = 0;
+    _ownsBinaryRef = false;
+    _binary->unref();
+  }
+}
+
 PluginBinary::~PluginBinary() {
   std::vector<Plugin*>::iterator i = _plugins.begin();
   while (i != _plugins.end()) {
@@ -171,7 +192,7 @@ PluginBinary::~PluginBinary() {
   // release the last reference to the binary, which should unload it
   // if this reference was taken by loadPluginInfo().
   if (_binary) {
-    if (_binary->isLoaded()) {
+    if (_ownsBinaryRef) {
       _binary->unref();
     }
     assert(!_binary->isLoaded());
@@ -280,6 +301,8 @@ PluginCache::PluginCache()
   _ignoreCache = false;
   _dirty = false;
   _enablePluginSeek = true;
+  _parallelScan = false;
+  _lazyDescribe = false;
   
   std::string s = OFXGetEnv("OFX_PLUGIN_PATH");
   
@@ -337,130 +360,330 @@ void PluginCache::setPluginHostPath(const std::string &hostId) {
 #endif
 }
 
+namespace {
+
+  /// an entry of a directory being scanned
+  struct DirEntry {
+    std::string name;
+    bool        isdir;
+  };
+
+  /// list the entries of a directory, returns false if it could not be opened
+  bool listDirectory(const std::string &dir, std::vector<DirEntry> &entries)
+  {
+#if defined (WINDOWS)
+    WIN32_FIND_DATAW findData;
+    HANDLE findHandle;
+    std::wstring ws = OFX::utf8_to_utf16((dir + "\\*"));
+    findHandle = FindFirstFileW(ws.c_str(), &findData);
+    // an empty listing still counts as a directory we looked in
+    if (findHandle == INVALID_HANDLE_VALUE) {
+      return true;
+    }
+    while (1) {
+      DirEntry entry;
+      std::wstring wname = findData.cFileName;
+      entry.name = OFX::utf16_to_utf8(wname);
+      entry.isdir = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+      entries.push_back(entry);
+
+      int rval = FindNextFileW(findHandle, &findData);
+      if (rval == 0) {
+        break;
+      }
+    }
+    FindClose(findHandle);
+#else
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+      return false;
+    }
+    while (dirent *de = readdir(d)) {
+      DirEntry entry;
+      entry.name = de->d_name;
+      // anything may be a directory, opendir will tell
+      entry.isdir = true;
+      entries.push_back(entry);
+    }
+    closedir(d);
+#endif
+    return true;
+  }
+
+  bool isBundleName(const std::string &name)
+  {
+    return name.find(".ofx.bundle") != std::string::npos;
+  }
+
+  bool shouldRecurseInto(const DirEntry &entry, bool recurse)
+  {
+    const std::string &name = entry.name;
+    return entry.isdir && recurse && !name.empty() && name[0] != '@' && name[name.size() - 1] != '.';
+  }
+
+} // anonymous namespace
+
+std::string PluginCache::bundleBinaryPath(const std::string &dir, const std::string &name, std::string &bundlename) const
+{
+  std::string barename = name.substr(0, name.length() - strlen(".bundle"));
+  bundlename = dir + DIRSEP + name;
+  std::string binpath = dir + DIRSEP + name + DIRSEP "Contents" DIRSEP + ARCHSTR + DIRSEP + barename;
+
+#if defined(__APPLE__) && (defined(__x86_64) || defined(__x86_64__))
+  /* From the OpenFX specification:
+
+     MacOS-x86-64 - for Apple Macintosh OS X, specifically on
+     intel x86 CPUs running AMD's 64 bit extensions. 64 bit host
+     applications should check this first, and if it doesn't
+     exist or is empty, fall back to "MacOS" looking for a
+     universal binary.
+  */
+
+  std::string binpath_universal = dir + DIRSEP + name + DIRSEP "Contents" DIRSEP + "MacOS" + DIRSEP + barename;
+  if (_knownBinFiles.find(binpath_universal) != _knownBinFiles.end()) {
+    binpath = binpath_universal;
+  }
+#endif
+  return binpath;
+}
+
+PluginBinary *PluginCache::probeBinary(const std::string &binpath, const std::string &bundlename)
+{
+  PluginBinary *pb = 0;
+#if defined(__x86_64) || defined(__x86_64__)
+  pb = new PluginBinary(binpath, bundlename, this);
+#  if defined(__APPLE__)
+  if (pb->isInvalid()) {
+    // fallback to "MacOS"
+    delete pb;
+    std::string barename = bundlename.substr(bundlename.rfind(DIRSEP) + 1);
+    barename = barename.substr(0, barename.length() - strlen(".bundle"));
+    std::string binpath_universal = bundlename + DIRSEP "Contents" DIRSEP + "MacOS" + DIRSEP + barename;
+    pb = new PluginBinary(binpath_universal, bundlename, this);
+  }
+#  endif
+#else
+  pb = new PluginBinary(binpath, bundlename, this);
+#endif
+  return pb;
+}
+
+void PluginCache::describePlugin(Plugin *plug)
+{
+  const APICache::PluginAPICacheI &api = plug->getApiHandler();
+  if (_lazyDescribe) {
+    api.deferLoadFromPlugin(plug);
+  } else {
+    api.loadFromPlugin(plug);
+  }
+}
+
+void PluginCache::describeBinary(PluginBinary *pb)
+{
+  for (int j=0;j<pb->getNPlugins();j++) {
+    describePlugin(&pb->getPlugin(j));
+  }
+  if (_lazyDescribe) {
+    pb->releaseBinary();
+  }
+}
+
 void PluginCache::scanDirectory(std::set<std::string> &foundBinFiles, const std::string &dir, bool recurse)
 {
 #ifdef CACHE_DEBUG
   printf("looking in %s for plugins\n", dir.c_str());
 #endif
   
-#if defined (WINDOWS)
-  WIN32_FIND_DATAW findData;
-  HANDLE findHandle;
-#else
-  DIR *d = opendir(dir.c_str());
-  if (!d) {
+  std::vector<DirEntry> entries;
+  if (!listDirectory(dir, entries)) {
     return;
   }
-#endif
   
   _pluginDirs.push_back(dir.c_str());
   
-#if defined (UNIX)
-  while (dirent *de = readdir(d))
-#elif defined (WINDOWS)
-    {
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const DirEntry &entry = entries[i];
+    if (isBundleName(entry.name)) {
+      std::string bundlename;
+      std::string binpath = bundleBinaryPath(dir, entry.name, bundlename);
+
+      if (_knownBinFiles.find(binpath) == _knownBinFiles.end()) {
+#ifdef CACHE_DEBUG
+        printf("found non-cached binary %s\n", binpath.c_str());
+#endif
+        _dirty = true;
 
-      std::wstring ws = OFX::utf8_to_utf16((dir + "\\*"));
-      findHandle = FindFirstFileW(ws.c_str(), &findData);
+        // the binary was not in the cache
+        PluginBinary *pb = probeBinary(binpath, bundlename);
+        // the path may have fallen back to the universal binary
+        binpath = pb->getFilePath();
+        _binaries.push_back(pb);
+        _knownBinFiles.insert(binpath);
+        foundBinFiles.insert(binpath);
+
+        describeBinary(pb);
+      } else {
+#ifdef CACHE_DEBUG
+        printf("found cached binary %s\n", binpath.c_str());
+#endif
+      }
+      // insert final path (universal or not) in the list of found files
+      foundBinFiles.insert(binpath);
+    } else if (shouldRecurseInto(entry, recurse)) {
+      scanDirectory(foundBinFiles, dir + DIRSEP + entry.name, recurse);
     }
-  if (findHandle == INVALID_HANDLE_VALUE) 
-    {
-      return;
+  }
+}
+
+namespace {
+
+  /// a directory listed by a parallel scan
+  struct ScanDir {
+    std::string           path;
+    bool                  recurse;
+    bool                  opened;
+    std::vector<DirEntry> entries;
+    std::vector<size_t>   subdirs;  ///< for each entry, the index of its ScanDir if we recurse into it, else 0
+  };
+
+  /// list a range of directories, one per work item
+  struct ListDirs {
+    std::vector<ScanDir> *dirs;
+    size_t                first;
+  };
+
+  void listDirsThread(unsigned int threadIndex, unsigned int /*threadMax*/, void *arg)
+  {
+    ListDirs *work = (ListDirs *) arg;
+    ScanDir &dir = (*work->dirs)[work->first + threadIndex];
+    try {
+      dir.opened = listDirectory(dir.path, dir.entries);
+    } catch (...) {
+      dir.opened = false;
     }
+  }
 
-  while (1)
-#endif
-    {
-#if defined (UNIX)
-      std::string name = de->d_name;
-      bool isdir = true;
-#else
-      std::wstring wname = findData.cFileName;
-      std::string name = OFX::utf16_to_utf8(wname);
+  /// binaries found by a parallel scan, probed and described one per work item
+  struct ProbeBins {
+    PluginCache                                        *cache;
+    const std::vector<std::pair<std::string, std::string> > *paths;  ///< binary and bundle paths
+    std::vector<PluginBinary *>                        *binaries;
+  };
 
-      bool isdir = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-#endif
-      if (name.find(".ofx.bundle") != std::string::npos) {
-        std::string barename = name.substr(0, name.length() - strlen(".bundle"));
-        std::string bundlename = dir + DIRSEP + name;
-        std::string binpath = dir + DIRSEP + name + DIRSEP "Contents" DIRSEP + ARCHSTR + DIRSEP + barename;
-          
-        // don't insert binpath yet, do it later because of Mac OS X Universal stuff
-        //foundBinFiles.insert(binpath);
+} // anonymous namespace
 
-#if defined(__APPLE__) && (defined(__x86_64) || defined(__x86_64__))
-        /* From the OpenFX specification:
-           
-           MacOS-x86-64 - for Apple Macintosh OS X, specifically on
-           intel x86 CPUs running AMD's 64 bit extensions. 64 bit host
-           applications should check this first, and if it doesn't
-           exist or is empty, fall back to "MacOS" looking for a
-           universal binary.
-        */
-          
-        std::string binpath_universal = dir + DIRSEP + name + DIRSEP "Contents" DIRSEP + "MacOS" + DIRSEP + barename;
-        if (_knownBinFiles.find(binpath_universal) != _knownBinFiles.end()) {
-          binpath = binpath_universal;
+void PluginCache::probeBinaryThread(unsigned int threadIndex, unsigned int /*threadMax*/, void *arg)
+{
+  ProbeBins *work = (ProbeBins *) arg;
+  const std::pair<std::string, std::string> &path = (*work->paths)[threadIndex];
+  try {
+    PluginBinary *pb = work->cache->probeBinary(path.first, path.second);
+    (*work->binaries)[threadIndex] = pb;
+    // plugins in one binary share its globals, so they are described in turn
+    work->cache->describeBinary(pb);
+  } catch (...) {
+    std::cerr << "failed to load plugin binary " << path.first << std::endl;
+  }
+}
+
+void PluginCache::scanDirectoriesParallel(std::set<std::string> &foundBinFiles)
+{
+  // list the directories one level at a time, each level in parallel
+  std::vector<ScanDir> dirs;
+  for (std::list<std::string>::iterator paths= _pluginPath.begin();
+       paths != _pluginPath.end();
+       paths++) {
+    ScanDir dir;
+    dir.path = *paths;
+    dir.recurse = _nonrecursePath.find(*paths) == _nonrecursePath.end();
+    dir.opened = false;
+    dirs.push_back(dir);
+  }
+  size_t nRoots = dirs.size();
+
+  size_t levelBegin = 0;
+  while (levelBegin < dirs.size()) {
+    size_t levelEnd = dirs.size();
+    ListDirs work;
+    work.dirs = &dirs;
+    work.first = levelBegin;
+    MultiThread::multiThread(listDirsThread, (unsigned int)(levelEnd - levelBegin), &work);
+
+    for (size_t d = levelBegin; d < levelEnd; ++d) {
+      // dirs may grow, so index rather than keep a reference
+      dirs[d].subdirs.assign(dirs[d].entries.size(), 0);
+      for (size_t i = 0; i < dirs[d].entries.size(); ++i) {
+        const DirEntry &entry = dirs[d].entries[i];
+        if (!isBundleName(entry.name) && shouldRecurseInto(entry, dirs[d].recurse)) {
+          ScanDir sub;
+          sub.path = dirs[d].path + DIRSEP + entry.name;
+          sub.recurse = true;
+          sub.opened = false;
+          dirs[d].subdirs[i] = dirs.size();
+          dirs.push_back(sub);
         }
-#endif
+      }
+    }
+    levelBegin = levelEnd;
+  }
 
+  // walk the listings depth first, as scanDirectory would, to find the new
+  // binaries in the same order
+  std::vector<std::pair<std::string, std::string> > newBinaries;
+  std::vector<std::pair<size_t, size_t> > stack; // directory, next entry
+  for (size_t r = 0; r < nRoots; ++r) {
+    stack.push_back(std::make_pair(r, size_t(0)));
+    while (!stack.empty()) {
+      size_t d = stack.back().first;
+      size_t i = stack.back().second;
+      const ScanDir &dir = dirs[d];
+      if (i == 0) {
+        if (!dir.opened) {
+          stack.pop_back();
+          continue;
+        }
+        _pluginDirs.push_back(dir.path);
+      }
+      if (i == dir.entries.size()) {
+        stack.pop_back();
+        continue;
+      }
+      stack.back().second = i + 1;
+
+      const DirEntry &entry = dir.entries[i];
+      if (isBundleName(entry.name)) {
+        std::string bundlename;
+        std::string binpath = bundleBinaryPath(dir.path, entry.name, bundlename);
         if (_knownBinFiles.find(binpath) == _knownBinFiles.end()) {
-#ifdef CACHE_DEBUG
-          printf("found non-cached binary %s\n", binpath.c_str());
-#endif
           _dirty = true;
-
-          // the binary was not in the cache
-          
-          PluginBinary *pb = 0;
-#if defined(__x86_64) || defined(__x86_64__)
-          pb = new PluginBinary(binpath, bundlename, this);
-#  if defined(__APPLE__)
-          if (pb->isInvalid()) {
-            // fallback to "MacOS"
-            delete pb;
-            binpath = binpath_universal;
-            pb = new PluginBinary(binpath, bundlename, this);
-          }
-#  endif
-#else
-          pb = new PluginBinary(binpath, bundlename, this);
-#endif
-          _binaries.push_back(pb);
+          newBinaries.push_back(std::make_pair(binpath, bundlename));
           _knownBinFiles.insert(binpath);
-          foundBinFiles.insert(binpath);
-
-          for (int j=0;j<pb->getNPlugins();j++) {
-            Plugin *plug = &pb->getPlugin(j);
-            const APICache::PluginAPICacheI &api = plug->getApiHandler();
-            api.loadFromPlugin(plug);
-          }
-        } else {
-#ifdef CACHE_DEBUG
-          printf("found cached binary %s\n", binpath.c_str());
-#endif
         }
-        // insert final path (universal or not) in the list of found files
         foundBinFiles.insert(binpath);
-      } else {
-        if (isdir && (recurse && !name.empty() && name[0] != '@' && name[name.size() - 1] != '.')) {
-          scanDirectory(foundBinFiles, dir + DIRSEP + name, recurse);
-        }
-      }
-#if defined(WINDOWS)
-      int rval = FindNextFileW(findHandle, &findData);
-      
-      if (rval == 0) {
-        break;
+      } else if (dir.subdirs[i]) {
+        stack.push_back(std::make_pair(dir.subdirs[i], size_t(0)));
       }
-#endif
     }
-  
-#if defined(UNIX)
-  closedir(d);
-#else
-  FindClose(findHandle);
-#endif
+  }
+
+  // then load and describe them in parallel
+  std::vector<PluginBinary *> binaries(newBinaries.size(), (PluginBinary *) 0);
+  if (!newBinaries.empty()) {
+    ProbeBins work;
+    work.cache = this;
+    work.paths = &newBinaries;
+    work.binaries = &binaries;
+    MultiThread::multiThread(probeBinaryThread, (unsigned int)newBinaries.size(), &work);
+  }
+
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    if (binaries[i]) {
+      _binaries.push_back(binaries[i]);
+      // the path may have fallen back to the universal binary
+      _knownBinFiles.insert(binaries[i]->getFilePath());
+      foundBinFiles.insert(binaries[i]->getFilePath());
+    }
+  }
 }
 
 std::string PluginCache::seekPluginFile(const std::string &baseName) const {
@@ -485,10 +708,14 @@ void PluginCache::scanPluginFiles()
 {
   std::set<std::string> foundBinFiles;
   
-  for (std::list<std::string>::iterator paths= _pluginPath.begin();
-       paths != _pluginPath.end();
-       paths++) {
-    scanDirectory(foundBinFiles, *paths, _nonrecursePath.find(*paths) == _nonrecursePath.end());
+  if (_parallelScan) {
+    scanDirectoriesParallel(foundBinFiles);
+  } else {
+    for (std::list<std::string>::iterator paths= _pluginPath.begin();
+         paths != _pluginPath.end();
+         paths++) {
+      scanDirectory(foundBinFiles, *paths, _nonrecursePath.find(*paths) == _nonrecursePath.end());
+    }
   }
 
 #ifdef OFX_USE_STATIC_PLUGINS
@@ -504,11 +731,7 @@ void PluginCache::scanPluginFiles()
       _staticBinary = 0;
     } else {
       _dirty = true;
-      for (int j=0;j<_staticBinary->getNPlugins();j++) {
-         Plugin *plug = &_staticBinary->getPlugin(j);
-         const APICache::PluginAPICacheI &api = plug->getApiHandler();
-         api.loadFromPlugin(plug);
-      }
+      describeBinary(_staticBinary);
       _binaries.push_back(_staticBinary);
     }
   }
@@ -544,7 +767,7 @@ void PluginCache::scanPluginFiles()
         APICache::PluginAPICacheI &api = plug->getApiHandler();
         
         if (binChanged) {
-          api.loadFromPlugin(plug);
+          describePlugin(plug);
         }
         
         std::string reason;
@@ -557,6 +780,10 @@ void PluginCache::scanPluginFiles()
             " as unsupported (" << reason << ")" << std::endl;
         }
       }
+
+      if (binChanged && _lazyDescribe) {
+        pb->releaseBinary();
+      }
       
       i++;
     }
@@ -632,26 +859,11 @@ void PluginCache::elementBeginCallback(void */*userData*/, const XML_Char *name,
     time_t mtime = OFX::Host::Property::stringToInt(attmap["mtime"]);
     off_t size = OFX::Host::Property::stringToInt(attmap["size"]);
 
-    PluginBinary* pb;
 #ifdef OFX_USE_STATIC_PLUGINS
-    if (isStaticLinkedCachedBinary) {
-      // only 1 static binary allowed!
-      if (_staticBinary) {
-        _ignoreCache = true;
-        return;
-      }
-      // We need to provide the 2 function pointers for the static binary
-      pb = new PluginBinary(_hostAppBinFilePath, &OfxGetNumberOfPlugins,&OfxGetPlugin, this, &fname, &mtime, &size);
-      _staticBinary = pb;
-    } else
+    _xmlCurrentBinary = addCachedBinary(isStaticLinkedCachedBinary, fname, bname, mtime, size);
+#else
+    _xmlCurrentBinary = addCachedBinary(false, fname, bname, mtime, size);
 #endif
-    {
-      pb = new PluginBinary(fname, bname, mtime, size);
-    }
-    _xmlCurrentBinary = pb;
-    _binaries.push_back(_xmlCurrentBinary);
-    _knownBinFiles.insert(fname);
-    
     return;
   }
   
@@ -665,26 +877,17 @@ void PluginCache::elementBeginCallback(void */*userData*/, const XML_Char *name,
     std::string api = attmap["api"];
     std::string rawIdentifier = attmap["name"];
     
-    std::string identifier = rawIdentifier;
-    
-    // Who says the pluginIdentifier is case-insensitive? OFX 1.3 spec doesn't mention this.
-    // http://openfx.sourceforge.net/Documentation/1.3/ofxProgrammingReference.html#id472588
-    //for (size_t i=0;i<identifier.size();i++) {
-    //  identifier[i] = tolower(identifier[i]);
-    //}
-    
     int idx = OFX::Host::Property::stringToInt(attmap["index"]);
     int api_version = OFX::Host::Property::stringToInt(attmap["api_version"]);
     int major_version = OFX::Host::Property::stringToInt(attmap["major_version"]);
     int minor_version = OFX::Host::Property::stringToInt(attmap["minor_version"]);
+    // optional, written for plugins a lazy scan did not describe
+    bool describe_pending = attmap.find("describe_pending") != attmap.end() && OFX::Host::Property::stringToInt(attmap["describe_pending"]) != 0;
     
-    APICache::PluginAPICacheI *apiCache = findApiHandler(api, api_version);
-    if (apiCache) {
-      
-      Plugin *pe = apiCache->newPlugin(_xmlCurrentBinary, idx, api, api_version, identifier, rawIdentifier, major_version, minor_version);
-      _xmlCurrentBinary->addPlugin(pe);
+    Plugin *pe = addCachedPlugin(_xmlCurrentBinary, api, api_version, rawIdentifier, idx, major_version, minor_version, describe_pending);
+    if (pe) {
       _xmlCurrentPlugin = pe;
-      apiCache->beginXmlParsing(pe);
+      pe->getApiHandler().beginXmlParsing(pe);
     }
     
     return;
@@ -741,7 +944,326 @@ void PluginCache::elementEndCallback(void */*userData*/, const XML_Char *name) {
   }
 }
 
+PluginBinary *PluginCache::addCachedBinary(bool isStaticBinary, const std::string &fname, const std::string &bname, time_t mtime, off_t size)
+{
+  PluginBinary* pb;
+#ifdef OFX_USE_STATIC_PLUGINS
+  if (isStaticBinary) {
+    // only 1 static binary allowed!
+    if (_staticBinary) {
+      _ignoreCache = true;
+      return 0;
+    }
+    // We need to provide the 2 function pointers for the static binary
+    std::string cachedPath = fname;
+    pb = new PluginBinary(_hostAppBinFilePath, &OfxGetNumberOfPlugins,&OfxGetPlugin, this, &cachedPath, &mtime, &size);
+    _staticBinary = pb;
+  } else
+#else
+  (void)isStaticBinary;
+#endif
+  {
+    pb = new PluginBinary(fname, bname, mtime, size);
+  }
+  _binaries.push_back(pb);
+  _knownBinFiles.insert(fname);
+  return pb;
+}
+
+Plugin *PluginCache::addCachedPlugin(PluginBinary *pb, const std::string &api, int apiVersion, const std::string &rawIdentifier,
+                                     int index, int majorVersion, int minorVersion, bool describePending)
+{
+  std::string identifier = rawIdentifier;
+
+  // Who says the pluginIdentifier is case-insensitive? OFX 1.3 spec doesn't mention this.
+  // http://openfx.sourceforge.net/Documentation/1.3/ofxProgrammingReference.html#id472588
+  //for (size_t i=0;i<identifier.size();i++) {
+  //  identifier[i] = tolower(identifier[i]);
+  //}
+
+  APICache::PluginAPICacheI *apiCache = findApiHandler(api, apiVersion);
+  if (!apiCache) {
+    return 0;
+  }
+  Plugin *pe = apiCache->newPlugin(pb, index, api, apiVersion, identifier, rawIdentifier, majorVersion, minorVersion);
+  pb->addPlugin(pe);
+  if (describePending) {
+    apiCache->deferLoadFromPlugin(pe);
+  }
+  return pe;
+}
+
+namespace {
+
+  /// magic number at the start of a binary cache
+  const char kBinaryCacheMagic[8] = {'O', 'F', 'X', 'H', 'C', 'A', 'C', 'H'};
+
+  /// bump this whenever the layout of the records below changes
+  const unsigned int kBinaryCacheFormat = 2;
+
+  /// written in the header to detect caches of another endianness
+  const unsigned int kBinaryCacheByteOrder = 0x01020304;
+
+  /// A binary cache is this header followed by the binary, plugin, property and
+  /// value records, then the string table. Records are fixed size and follow each
+  /// other in order, so a binary's plugins are the nPlugins records after those of
+  /// the previous binaries, and so on for properties and values. Strings are
+  /// offsets into the string table, which holds NUL terminated strings.
+  struct BinaryCacheHeader {
+    char         magic[8];
+    unsigned int byteOrder;
+    unsigned int format;
+    unsigned int cacheVersion;
+    unsigned int nBinaries;
+    unsigned int nPlugins;
+    unsigned int nProperties;
+    unsigned int nValues;
+    unsigned int stringsSize;
+  };
+
+  struct BinaryCacheBinary {
+    long long    mtime;
+    long long    size;
+    unsigned int path;
+    unsigned int bundlePath;
+    unsigned int isStatic;
+    unsigned int nPlugins;
+  };
+
+  struct BinaryCachePlugin {
+    unsigned int rawIdentifier;
+    unsigned int api;
+    int          index;
+    int          apiVersion;
+    int          majorVersion;
+    int          minorVersion;
+    unsigned int nProperties;
+    unsigned int flags;
+  };
+
+  /// BinaryCachePlugin::flags, the plugin was not described by a lazy scan and has no properties
+  const unsigned int kBinaryCachePluginDescribePending = 1;
+
+  struct BinaryCacheProperty {
+    unsigned int name;
+    int          type;
+    int          dimension; ///< fixed dimension, 0 if variable
+    unsigned int nValues;
+  };
+
+  /// ints, doubles and string offsets
+  union BinaryCacheValue {
+    long long i;
+    double    d;
+  };
+
+  /// reads the records of a binary cache, checking they are all in the buffer
+  class BinaryCacheReader {
+  public :
+    BinaryCacheReader(const char *data, size_t size)
+      : _data(data)
+      , _size(size)
+      , _pos(0)
+      , _strings(0)
+      , _stringsSize(0)
+    {
+    }
+
+    template <class T> void read(T &record)
+    {
+      if (_size - _pos < sizeof(T)) {
+        throw std::runtime_error("Truncated binary plugin cache");
+      }
+      // the buffer need not be aligned when read from a stream
+      memcpy(&record, _data + _pos, sizeof(T));
+      _pos += sizeof(T);
+    }
+
+    void skip(size_t n, size_t recordSize)
+    {
+      if (n > (_size - _pos) / recordSize) {
+        throw std::runtime_error("Truncated binary plugin cache");
+      }
+      _pos += n * recordSize;
+    }
+
+    void setStrings(size_t offset, size_t size)
+    {
+      if (offset > _size || size != _size - offset || size == 0 || _data[_size - 1] != 0) {
+        throw std::runtime_error("Corrupt binary plugin cache string table");
+      }
+      _strings = _data + offset;
+      _stringsSize = size;
+    }
+
+    const char *string(unsigned int offset) const
+    {
+      if (offset >= _stringsSize) {
+        throw std::runtime_error("Corrupt binary plugin cache string");
+      }
+      return _strings + offset;
+    }
+
+    size_t tell() const { return _pos; }
+    void seek(size_t pos) { _pos = pos; }
+
+  private :
+    const char *_data;
+    size_t      _size;
+    size_t      _pos;
+    const char *_strings;
+    size_t      _stringsSize;
+  };
+
+  /// string table being written, each string is stored once
+  class BinaryCacheStrings {
+  public :
+    unsigned int add(const std::string &s)
+    {
+      std::map<std::string, unsigned int>::iterator it = _offsets.find(s);
+      if (it != _offsets.end()) {
+        return it->second;
+      }
+      unsigned int offset = (unsigned int)_data.size();
+      _data.append(s.c_str(), s.size() + 1);
+      _offsets.insert(std::make_pair(s, offset));
+      return offset;
+    }
+
+    const std::string &data() const { return _data; }
+
+  private :
+    std::map<std::string, unsigned int> _offsets;
+    std::string _data;
+  };
+
+  /// a read only memory mapping of a whole file
+  class MappedFile {
+  public :
+    explicit MappedFile(const std::string &fileName)
+      : _data(0)
+      , _size(0)
+      , _ok(false)
+#if defined(WINDOWS)
+      , _file(INVALID_HANDLE_VALUE)
+      , _mapping(NULL)
+#endif
+    {
+#if defined(UNIX)
+      int fd = open(fileName.c_str(), O_RDONLY);
+      if (fd < 0) {
+        return;
+      }
+      struct stat st;
+      if (fstat(fd, &st) == 0) {
+        _size = (size_t)st.st_size;
+        if (_size == 0) {
+          _ok = true;
+        } else {
+          void *p = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (p != MAP_FAILED) {
+            _data = (const char *)p;
+            _ok = true;
+          }
+        }
+      }
+      // the mapping stays valid once the file is closed
+      close(fd);
+#elif defined(WINDOWS)
+      std::wstring wname = OFX::utf8_to_utf16(fileName);
+      _file = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      if (_file == INVALID_HANDLE_VALUE) {
+        return;
+      }
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(_file, &size)) {
+        return;
+      }
+      _size = (size_t)size.QuadPart;
+      if (_size == 0) {
+        _ok = true;
+        return;
+      }
+      _mapping = CreateFileMappingW(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (_mapping) {
+        _data = (const char *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+        _ok = _data != NULL;
+      }
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(UNIX)
+      if (_data) {
+        munmap((void *)_data, _size);
+      }
+#elif defined(WINDOWS)
+      if (_data) {
+        UnmapViewOfFile(_data);
+      }
+      if (_mapping) {
+        CloseHandle(_mapping);
+      }
+      if (_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(_file);
+      }
+#endif
+    }
+
+    bool ok() const { return _ok; }
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+
+  private :
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char *_data;
+    size_t      _size;
+    bool        _ok;
+#if defined(WINDOWS)
+    HANDLE      _file;
+    HANDLE      _mapping;
+#endif
+  };
+
+} // anonymous namespace
+
 void PluginCache::readCache(std::istream &ifs) {
+  if (!ifs.good()) {
+    throw std::runtime_error("Error reading cache stream");
+  }
+  std::string data;
+  char buf[4096];
+  while (!ifs.eof()) {
+    ifs.read(buf, sizeof(buf));
+    if (ifs.bad()) {
+      throw std::runtime_error("Error reading cache stream");
+    }
+    data.append(buf, (size_t)ifs.gcount());
+  }
+  readCache(data.data(), data.size());
+}
+
+bool PluginCache::readCache(const std::string &fileName) {
+  MappedFile file(fileName);
+  if (!file.ok()) {
+    return false;
+  }
+  readCache(file.data(), file.size());
+  return true;
+}
+
+void PluginCache::readCache(const char *data, size_t size) {
+  if (size >= sizeof(kBinaryCacheMagic) && memcmp(data, kBinaryCacheMagic, sizeof(kBinaryCacheMagic)) == 0) {
+    readBinaryCache(data, size);
+  } else {
+    readXMLCache(data, size);
+  }
+}
+
+void PluginCache::readXMLCache(const char *data, size_t size) {
   XML_Parser xP = XML_ParserCreate(NULL);
   if (!xP) {
     throw std::runtime_error("Error creating XML parser");
@@ -750,16 +1272,11 @@ void PluginCache::readCache(std::istream &ifs) {
   XML_SetElementHandler(xP, elementBeginHandler, elementEndHandler);
   XML_SetCharacterDataHandler(xP, elementCharHandler);
   int done = false;
-  char buf[4096];
-  while (!done && !ifs.eof()) {
-    if (!ifs.good()) {
-      throw std::runtime_error("Error reading cache stream");
-    }
-    ifs.read(buf, sizeof(buf));
-    int n = (int)ifs.gcount();
-    done = (n != sizeof(buf));
+  while (!done) {
+    int n = size > 4096 ? 4096 : (int)size;
+    done = (size_t)n == size;
 
-    if (XML_Parse(xP, buf, n, done) == XML_STATUS_ERROR) {
+    if (XML_Parse(xP, data, n, done) == XML_STATUS_ERROR) {
       XML_Error errorCode = XML_GetErrorCode(xP);
       XML_Size errorLine = XML_GetCurrentLineNumber(xP);
       XML_Size errorCol = XML_GetCurrentColumnNumber(xP);
@@ -770,10 +1287,128 @@ void PluginCache::readCache(std::istream &ifs) {
       XML_ParserFree(xP);
       throw std::runtime_error(errorDesc.str());
     }
+    data += n;
+    size -= n;
   }
   XML_ParserFree(xP);
 }
 
+void PluginCache::readBinaryCache(const char *data, size_t size) {
+  BinaryCacheReader reader(data, size);
+  BinaryCacheHeader header;
+  reader.read(header);
+  if (header.byteOrder != kBinaryCacheByteOrder || header.format != kBinaryCacheFormat) {
+    // written by another build, ignore it as we would a mismatched version
+    _ignoreCache = true;
+    return;
+  }
+
+  // check all the records are there before making anything
+  size_t recordsBegin = reader.tell();
+  reader.skip(header.nBinaries, sizeof(BinaryCacheBinary));
+  reader.skip(header.nPlugins, sizeof(BinaryCachePlugin));
+  reader.skip(header.nProperties, sizeof(BinaryCacheProperty));
+  reader.skip(header.nValues, sizeof(BinaryCacheValue));
+  reader.setStrings(reader.tell(), header.stringsSize);
+
+  if (_cacheVersion != reader.string(header.cacheVersion)) {
+#ifdef CACHE_DEBUG
+    printf("mismatched version, ignoring cache (got '%s', wanted '%s')\n",
+           reader.string(header.cacheVersion),
+           _cacheVersion.c_str());
+#endif
+    _ignoreCache = true;
+    return;
+  }
+
+  // the records are read in order, each section starting where the previous one ends
+  size_t binaryPos = recordsBegin;
+  size_t pluginPos = binaryPos + header.nBinaries * sizeof(BinaryCacheBinary);
+  size_t propertyPos = pluginPos + header.nPlugins * sizeof(BinaryCachePlugin);
+  size_t valuePos = propertyPos + header.nProperties * sizeof(BinaryCacheProperty);
+  size_t propertyEnd = valuePos;
+  size_t valueEnd = valuePos + header.nValues * sizeof(BinaryCacheValue);
+  size_t pluginEnd = propertyPos;
+
+  for (unsigned int b = 0; b < header.nBinaries; ++b) {
+    BinaryCacheBinary binRecord;
+    reader.seek(binaryPos);
+    reader.read(binRecord);
+    binaryPos = reader.tell();
+
+    PluginBinary *pb = addCachedBinary(binRecord.isStatic != 0,
+                                       reader.string(binRecord.path),
+                                       reader.string(binRecord.bundlePath),
+                                       (time_t)binRecord.mtime,
+                                       (off_t)binRecord.size);
+    if (!pb) {
+      return;
+    }
+
+    for (unsigned int p = 0; p < binRecord.nPlugins; ++p) {
+      if (pluginPos >= pluginEnd) {
+        throw std::runtime_error("Corrupt binary plugin cache");
+      }
+      BinaryCachePlugin plugRecord;
+      reader.seek(pluginPos);
+      reader.read(plugRecord);
+      pluginPos = reader.tell();
+
+      Plugin *pe = 0;
+      if (!pb->hasBinaryChanged()) {
+        pe = addCachedPlugin(pb, reader.string(plugRecord.api), plugRecord.apiVersion, reader.string(plugRecord.rawIdentifier),
+                             plugRecord.index, plugRecord.majorVersion, plugRecord.minorVersion,
+                             (plugRecord.flags & kBinaryCachePluginDescribePending) != 0);
+      }
+      Property::Set *props = (pe && !pe->isDescribePending()) ? pe->getApiHandler().getCacheProperties(pe) : 0;
+
+      for (unsigned int i = 0; i < plugRecord.nProperties; ++i) {
+        if (propertyPos >= propertyEnd) {
+          throw std::runtime_error("Corrupt binary plugin cache");
+        }
+        BinaryCacheProperty propRecord;
+        reader.seek(propertyPos);
+        reader.read(propRecord);
+        propertyPos = reader.tell();
+
+        if (propRecord.nValues > (valueEnd - valuePos) / sizeof(BinaryCacheValue)) {
+          throw std::runtime_error("Corrupt binary plugin cache");
+        }
+        size_t firstValue = valuePos;
+        valuePos += propRecord.nValues * sizeof(BinaryCacheValue);
+
+        if (!props) {
+          continue;
+        }
+        Property::TypeEnum type = (Property::TypeEnum) propRecord.type;
+        Property::Property *prop = APICache::propertySetDefine(*props, reader.string(propRecord.name), type, propRecord.dimension);
+        if (!prop || prop->getType() != type) {
+          continue;
+        }
+
+        reader.seek(firstValue);
+        for (unsigned int v = 0; v < propRecord.nValues; ++v) {
+          BinaryCacheValue value;
+          reader.read(value);
+          switch (type) {
+          case Property::eInt:
+            static_cast<Property::Int *>(prop)->setValue((int)value.i, (int)v);
+            break;
+          case Property::eDouble:
+            static_cast<Property::Double *>(prop)->setValue(value.d, (int)v);
+            break;
+          case Property::eString:
+            static_cast<Property::String *>(prop)->setValue(reader.string((unsigned int)value.i), (int)v);
+            break;
+          default:
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
 void PluginCache::writePluginCache(std::ostream &os) const {
 #ifdef CACHE_DEBUG
   printf("writing pluginCache with version = %s\n", _cacheVersion.c_str());
@@ -806,8 +1441,14 @@ void PluginCache::writePluginCache(std::ostream &os) const {
          << XML::attribute("api", p->getPluginApi())
          << XML::attribute("api_version", p->getApiVersion())
          << XML::attribute("major_version", p->getVersionMajor())
-         << XML::attribute("minor_version", p->getVersionMinor())
-         << ">\n";
+         << XML::attribute("minor_version", p->getVersionMinor());
+      if (p->isDescribePending()) {
+        // there is nothing to save yet, the plugin is described when first used
+        os << XML::attribute("describe_pending", 1) << ">\n";
+        os << "  </plugin>\n";
+        continue;
+      }
+      os << ">\n";
       																      
       const APICache::PluginAPICacheI &api = p->getApiHandler();
       os << "    <apiproperties>\n"; 
@@ -822,6 +1463,125 @@ void PluginCache::writePluginCache(std::ostream &os) const {
 }
 
 
+bool PluginCache::writeBinaryPluginCache(std::ostream &os) const {
+#ifdef CACHE_DEBUG
+  printf("writing binary pluginCache with version = %s\n", _cacheVersion.c_str());
+#endif
+
+  BinaryCacheStrings strings;
+  std::vector<BinaryCacheBinary> binaries;
+  std::vector<BinaryCachePlugin> plugins;
+  std::vector<BinaryCacheProperty> properties;
+  std::vector<BinaryCacheValue> values;
+
+  BinaryCacheHeader header;
+  memcpy(header.magic, kBinaryCacheMagic, sizeof(header.magic));
+  header.byteOrder = kBinaryCacheByteOrder;
+  header.format = kBinaryCacheFormat;
+  header.cacheVersion = strings.add(_cacheVersion);
+
+  binaries.reserve(_binaries.size());
+  for (std::list<PluginBinary *>::const_iterator i=_binaries.begin();i!=_binaries.end();i++) {
+    PluginBinary *b = *i;
+
+    BinaryCacheBinary binRecord;
+    binRecord.mtime = (long long)b->getFileModificationTime();
+    binRecord.size = (long long)b->getFileSize();
+    binRecord.path = strings.add(b->getFilePath());
+    binRecord.bundlePath = strings.add(b->getBundlePath());
+    binRecord.isStatic = b->isStaticallyLinkedPlugin();
+    binRecord.nPlugins = (unsigned int)b->getNPlugins();
+    binaries.push_back(binRecord);
+
+    for (int j=0;j<b->getNPlugins();j++) {
+      Plugin *p = &b->getPlugin(j);
+      const APICache::PluginAPICacheI &api = p->getApiHandler();
+      const Property::Set *props = 0;
+      if (!p->isDescribePending()) {
+        props = api.getCacheProperties(p);
+        if (!props) {
+          return false;
+        }
+      }
+
+      BinaryCachePlugin plugRecord;
+      plugRecord.rawIdentifier = strings.add(p->getRawIdentifier());
+      plugRecord.api = strings.add(p->getPluginApi());
+      plugRecord.index = p->getIndex();
+      plugRecord.apiVersion = p->getApiVersion();
+      plugRecord.majorVersion = p->getVersionMajor();
+      plugRecord.minorVersion = p->getVersionMinor();
+      plugRecord.nProperties = 0;
+      plugRecord.flags = 0;
+
+      if (!props) {
+        // there is nothing to save yet, the plugin is described when first used
+        plugRecord.flags |= kBinaryCachePluginDescribePending;
+        plugins.push_back(plugRecord);
+        continue;
+      }
+
+      for (Property::PropertyMap::const_iterator it = props->getProperties().begin(); it != props->getProperties().end(); ++it) {
+        Property::Property *prop = it->second;
+        // pointers mean nothing in another process
+        if (prop->getType() == Property::ePointer) {
+          continue;
+        }
+
+        BinaryCacheProperty propRecord;
+        propRecord.name = strings.add(prop->getName());
+        propRecord.type = prop->getType();
+        propRecord.dimension = prop->getFixedDimension();
+        propRecord.nValues = (unsigned int)prop->getDimension();
+        properties.push_back(propRecord);
+        ++plugRecord.nProperties;
+
+        for (int v = 0; v < prop->getDimension(); ++v) {
+          BinaryCacheValue value;
+          value.i = 0;
+          switch (prop->getType()) {
+          case Property::eInt:
+            value.i = static_cast<Property::Int *>(prop)->getValueRaw(v);
+            break;
+          case Property::eDouble:
+            value.d = static_cast<Property::Double *>(prop)->getValueRaw(v);
+            break;
+          case Property::eString:
+            value.i = strings.add(static_cast<Property::String *>(prop)->getValueRaw(v));
+            break;
+          default:
+            break;
+          }
+          values.push_back(value);
+        }
+      }
+      plugins.push_back(plugRecord);
+    }
+  }
+
+  header.nBinaries = (unsigned int)binaries.size();
+  header.nPlugins = (unsigned int)plugins.size();
+  header.nProperties = (unsigned int)properties.size();
+  header.nValues = (unsigned int)values.size();
+  header.stringsSize = (unsigned int)strings.data().size();
+
+  os.write((const char *)&header, sizeof(header));
+  if (!binaries.empty()) {
+    os.write((const char *)&binaries[0], binaries.size() * sizeof(BinaryCacheBinary));
+  }
+  if (!plugins.empty()) {
+    os.write((const char *)&plugins[0], plugins.size() * sizeof(BinaryCachePlugin));
+  }
+  if (!properties.empty()) {
+    os.write((const char *)&properties[0], properties.size() * sizeof(BinaryCacheProperty));
+  }
+  if (!values.empty()) {
+    os.write((const char *)&values[0], values.size() * sizeof(BinaryCacheValue));
+  }
+  os.write(strings.data().data(), strings.data().size());
+  return true;
+}
+
 APICache::PluginAPICacheI *PluginCache::findApiHandler(const std::string &api, int version) {
   std::list<PluginCacheSupportedApi>::iterator i = _apiHandlers.begin();
   while (i != _apiHandlers.end()) {
@@ -30,12 +30,14 @@
 // ofx
 #include "ofxCore.h"
 #include "ofxImageEffect.h"
+#include "ofxPropertyBatch.h"
 
 // ofx host
 #include "ofxhBinary.h"
 #include "ofxhPropertySuite.h"
 #include "ofxhUtilities.h"
 
+#include <exception>
 #include <iostream>
 #include <string.h>
 
@@ -408,26 +410,125 @@ namespace OFX {
         }
       }
 
-      Property *Set::fetchProperty(const std::string&name, bool followChain) const
+      PropertyIndex::PropertyIndex()
+        : _count(0)
       {
-        PropertyMap::const_iterator i = _props.find(name);
-        if (i == _props.end()) {
-          if(followChain && _chainedSet) {
-            return _chainedSet->fetchProperty(name, true);
+      }
+
+      /// FNV-1a
+      unsigned int PropertyIndex::hash(const char *name)
+      {
+        unsigned int h = 2166136261u;
+        while(*name) {
+          h ^= (unsigned char) *name++;
+          h *= 16777619u;
+        }
+        return h;
+      }
+
+      void PropertyIndex::insert(Property *prop)
+      {
+        // keep the load under a half, so probe sequences stay short
+        if(2 * (_count + 1) > _entries.size())
+          grow();
+
+        const char *name = prop->getName().c_str();
+        unsigned int h = hash(name);
+        size_t mask = _entries.size() - 1;
+        for(size_t i = h & mask; ; i = (i + 1) & mask) {
+          Entry &e = _entries[i];
+          if(!e.prop) {
+            e.hash = h;
+            e.name = name;
+            e.prop = prop;
+            ++_count;
+            return;
+          }
+          if(e.hash == h && strcmp(e.name, name) == 0) {
+            // replacing, so point at the name held by the new property
+            e.name = name;
+            e.prop = prop;
+            return;
           }
+        }
+      }
+
+      Property *PropertyIndex::find(const char *name) const
+      {
+        if(_count == 0)
           return NULL;
+
+        unsigned int h = hash(name);
+        size_t mask = _entries.size() - 1;
+        for(size_t i = h & mask; ; i = (i + 1) & mask) {
+          const Entry &e = _entries[i];
+          if(!e.prop)
+            return NULL;
+          if(e.hash == h && (e.name == name || strcmp(e.name, name) == 0))
+            return e.prop;
+        }
+      }
+
+      void PropertyIndex::clear()
+      {
+        _entries.clear();
+        _count = 0;
+      }
+
+      void PropertyIndex::grow()
+      {
+        std::vector<Entry> old;
+        old.swap(_entries);
+
+        Entry empty = { 0, NULL, NULL };
+        _entries.resize(old.empty() ? 16 : 2 * old.size(), empty);
+
+        size_t mask = _entries.size() - 1;
+        for(size_t j = 0; j < old.size(); ++j) {
+          if(!old[j].prop)
+            continue;
+          size_t i = old[j].hash & mask;
+          while(_entries[i].prop)
+            i = (i + 1) & mask;
+          _entries[i] = old[j];
         }
-        return i->second;
       }
 
-      template<class T> bool Set::fetchTypedProperty(const std::string&name, T *&prop, bool followChain) const
+      Property *Set::fetchProperty(const char *name, bool followChain) const
+      {
+        const Set *set = this;
+        do {
+          Property *prop = set->_index.find(name);
+          if(prop)
+            return prop;
+          set = set->_chainedSet;
+        } while(followChain && set);
+        return NULL;
+      }
+
+      namespace {
+        /// Downcast a property to the type asked for in fetchTypedProperty. Property
+        /// templates carry a type code, which is cheaper to check than a dynamic_cast.
+        template<class T> struct PropertyCast {
+          static T *cast(Property *prop) { return dynamic_cast<T *>(prop); }
+        };
+
+        template<class V> struct PropertyCast<PropertyTemplate<V> > {
+          static PropertyTemplate<V> *cast(Property *prop)
+          {
+            return prop->getType() == V::typeCode ? static_cast<PropertyTemplate<V> *>(prop) : 0;
+          }
+        };
+      }
+
+      template<class T> bool Set::fetchTypedProperty(const char *name, T *&prop, bool followChain) const
       {
         Property *myprop = fetchProperty(name, followChain);
 
         if(!myprop)
           return false;
 
-        prop = dynamic_cast<T *>(myprop);
+        prop = PropertyCast<T>::cast(myprop);
         if (prop == 0) {
           return false;
         }
@@ -469,29 +570,32 @@ namespace OFX {
       /// add one new property
       void Set::createProperty(const PropSpec &spec)
       {
-        if (_props.find(spec.name) != _props.end()) {
+        if (_index.find(spec.name)) {
 #         ifdef OFX_DEBUG_PROPERTIES
           std::cout << "OFX: Tried to add a duplicate property to a Property::Set: " << spec.name << std::endl;
 #         endif
           return;
         }
 
+        Property *prop = NULL;
         switch (spec.type) {
         case eInt: 
-          _props[spec.name] = new Int(spec.name, spec.dimension, spec.readonly, spec.defaultValue?atoi(spec.defaultValue):0);
+          prop = new Int(spec.name, spec.dimension, spec.readonly, spec.defaultValue?atoi(spec.defaultValue):0);
           break;
         case eDouble: 
-          _props[spec.name] = new Double(spec.name, spec.dimension, spec.readonly, spec.defaultValue?atof(spec.defaultValue):0);
+          prop = new Double(spec.name, spec.dimension, spec.readonly, spec.defaultValue?atof(spec.defaultValue):0);
           break;
         case eString: 
-          _props[spec.name] = new String(spec.name, spec.dimension, spec.readonly, spec.defaultValue?spec.defaultValue:"");
+          prop = new String(spec.name, spec.dimension, spec.readonly, spec.defaultValue?spec.defaultValue:"");
           break;
         case ePointer: 
-          _props[spec.name] = new Pointer(spec.name, spec.dimension, spec.readonly, (void*)spec.defaultValue);
+          prop = new Pointer(spec.name, spec.dimension, spec.readonly, (void*)spec.defaultValue);
           break;
         default: // XXX  error - unrecognised type
-          break;
+          return;
         }
+        _props[spec.name] = prop;
+        _index.insert(prop);
       }
 
       void Set::addProperties(const PropSpec spec[]) 
@@ -506,6 +610,8 @@ namespace OFX {
       void Set::addProperty(Property *prop)
       {
         PropertyMap::iterator t = _props.find(prop->getName());
+        // the index refers to the name of the old property, so update it before deleting that
+        _index.insert(prop);
         if(t != _props.end())
            delete t->second;
         _props[prop->getName()] = prop;
@@ -541,6 +647,7 @@ namespace OFX {
               break;
             }
             _props[i->first] = copyProp;
+            _index.insert(copyProp);
           }
         
         if (failed) {
@@ -550,6 +657,7 @@ namespace OFX {
             delete j->second;
           }
           _props.clear();
+          _index.clear();
         }
       }
 
@@ -563,7 +671,7 @@ namespace OFX {
       }
 
       /// set a particular property
-      template<class T> void Set::setProperty(const std::string &property, int index, const typename T::Type &value) 
+      template<class T> void Set::setProperty(const char *property, int index, const typename T::Type &value) 
       {
         try {
           PropertyTemplate<T> *prop = 0;
@@ -575,7 +683,7 @@ namespace OFX {
       }
       
       /// set a particular property
-      template<class T> void Set::setPropertyN(const std::string &property, int count, const typename T::APIType *value) 
+      template<class T> void Set::setPropertyN(const char *property, int count, const typename T::APIType *value) 
       {
         try {
           PropertyTemplate<T> *prop = 0;
@@ -587,7 +695,7 @@ namespace OFX {
       }
       
       /// get a particular property
-      template<class T> typename T::ReturnType Set::getProperty(const std::string &property, int index)  const
+      template<class T> typename T::ReturnType Set::getProperty(const char *property, int index)  const
       {
         try {
           PropertyTemplate<T> *prop;
@@ -600,7 +708,7 @@ namespace OFX {
       }
 
       /// get a particular property
-      template<class T> void Set::getPropertyN(const std::string &property, int count,  typename T::APIType *value)  const
+      template<class T> void Set::getPropertyN(const char *property, int count,  typename T::APIType *value)  const
       {
         try {
           PropertyTemplate<T> *prop;
@@ -612,7 +720,7 @@ namespace OFX {
       }
       
       /// get a particular property
-      template<class T> typename T::ReturnType Set::getPropertyRaw(const std::string &property, int index)  const
+      template<class T> typename T::ReturnType Set::getPropertyRaw(const char *property, int index)  const
       {
         try {
           PropertyTemplate<T> *prop;
@@ -625,7 +733,7 @@ namespace OFX {
       }
       
       /// get a particular property
-      template<class T> void Set::getPropertyRawN(const std::string &property, int count,  typename T::APIType *value)  const
+      template<class T> void Set::getPropertyRawN(const char *property, int count,  typename T::APIType *value)  const
       {
         try {
           PropertyTemplate<T> *prop;
@@ -637,13 +745,13 @@ namespace OFX {
       }
       
       /// get a particular int property
-      int Set::getIntPropertyRaw(const std::string &property, int index) const
+      int Set::getIntPropertyRaw(const char *property, int index) const
       {
         return getPropertyRaw<OFX::Host::Property::IntValue>(property, index);
       }
         
       /// get a particular double property
-      double Set::getDoublePropertyRaw(const std::string &property, int index)  const
+      double Set::getDoublePropertyRaw(const char *property, int index)  const
       {
         double v = getPropertyRaw<OFX::Host::Property::DoubleValue>(property, index);
         if ( OFX::IsNaN(v) ) {
@@ -655,13 +763,13 @@ namespace OFX {
       }
 
       /// get a particular double property
-      void *Set::getPointerPropertyRaw(const std::string &property, int index)  const
+      void *Set::getPointerPropertyRaw(const char *property, int index)  const
       {
         return getPropertyRaw<OFX::Host::Property::PointerValue>(property, index);
       }
         
       /// get a particular double property
-      const std::string &Set::getStringPropertyRaw(const std::string &property, int index)  const
+      const std::string &Set::getStringPropertyRaw(const char *property, int index)  const
       {
         String *prop;
         if(fetchTypedProperty(property, prop, true)) {
@@ -671,19 +779,19 @@ namespace OFX {
       }
 
       /// get a particular int property
-      int Set::getIntProperty(const std::string &property, int index)  const
+      int Set::getIntProperty(const char *property, int index)  const
       {
         return getProperty<OFX::Host::Property::IntValue>(property, index);
       }
         
       /// get the value of a particular int property
-      void Set::getIntPropertyN(const std::string &property,  int *v, int N) const
+      void Set::getIntPropertyN(const char *property,  int *v, int N) const
       {
         return getPropertyN<OFX::Host::Property::IntValue>(property, N, v);
       }
 
       /// get a particular double property
-      double Set::getDoubleProperty(const std::string &property, int index)  const
+      double Set::getDoubleProperty(const char *property, int index)  const
       {
         double v = getProperty<OFX::Host::Property::DoubleValue>(property, index);
         if ( OFX::IsNaN(v) ) {
@@ -694,7 +802,7 @@ namespace OFX {
       }
 
       /// get the value of a particular double property
-      void Set::getDoublePropertyN(const std::string &property,  double *v, int N) const
+      void Set::getDoublePropertyN(const char *property,  double *v, int N) const
       {
         getPropertyN<OFX::Host::Property::DoubleValue>(property, N, v);
         for (int i = 0; i < N; ++i) {
@@ -706,37 +814,37 @@ namespace OFX {
       }
 
       /// get a particular double property
-      void *Set::getPointerProperty(const std::string &property, int index)  const
+      void *Set::getPointerProperty(const char *property, int index)  const
       {
         return getProperty<OFX::Host::Property::PointerValue>(property, index);
       }
         
       /// get a particular double property
-      const std::string &Set::getStringProperty(const std::string &property, int index)  const
+      const std::string &Set::getStringProperty(const char *property, int index)  const
       {
         return getProperty<OFX::Host::Property::StringValue>(property, index);
       }
       
       /// set a particular string property
-      void Set::setStringProperty(const std::string &property, const std::string &value, int index)
+      void Set::setStringProperty(const char *property, const std::string &value, int index)
       {
         setProperty<OFX::Host::Property::StringValue>(property, index, value);
       }
       
       /// get a particular int property
-      void Set::setIntProperty(const std::string &property, int v, int index)
+      void Set::setIntProperty(const char *property, int v, int index)
       {
         setProperty<OFX::Host::Property::IntValue>(property, index, v);
       }
       
       /// set a particular double property
-      void Set::setIntPropertyN(const std::string &property, const int *v, int N)
+      void Set::setIntPropertyN(const char *property, const int *v, int N)
       {
         setPropertyN<OFX::Host::Property::IntValue>(property, N, v);
       }
 
       /// set a particular double property
-      void Set::setDoubleProperty(const std::string &property, double v, int index)
+      void Set::setDoubleProperty(const char *property, double v, int index)
       {
         if ( OFX::IsNaN(v) ) {
           // trying to set a NaN value
@@ -746,7 +854,7 @@ namespace OFX {
       }
       
       /// set a particular double property
-      void Set::setDoublePropertyN(const std::string &property, const double *v, int N)
+      void Set::setDoublePropertyN(const char *property, const double *v, int N)
       {
         for (int i = 0; i < N; ++i) {
           if ( OFX::IsNaN(v[i]) ) {
@@ -758,13 +866,13 @@ namespace OFX {
       }
 
       /// set a particular pointer property
-      void Set::setPointerProperty(const std::string &property,  void *v, int index)
+      void Set::setPointerProperty(const char *property,  void *v, int index)
       {
         setProperty<OFX::Host::Property::PointerValue>(property, index, v);
       }
         
       /// get the dimension of a particular property
-      int Set::getDimension(const std::string &property) const
+      int Set::getDimension(const char *property) const
       {
         Property *prop = 0;
         if(fetchTypedProperty(property, prop, true)) {
@@ -773,6 +881,82 @@ namespace OFX {
         return 0;
       }
 
+      ReusableSet::ReusableSet()
+        : _set(NULL)
+        , _leased(false)
+      {
+      }
+
+      ReusableSet::~ReusableSet()
+      {
+        delete _set;
+      }
+
+      ReusableSet::Lease::Lease(ReusableSet &owner, const PropSpec *spec)
+        : _owner(owner)
+        , _set(NULL)
+        , _extra(NULL)
+        , _fresh(false)
+        , _temporary(false)
+      {
+#if __cplusplus >= 201103L
+        bool leased = owner._leased.exchange(true, std::memory_order_acquire);
+#else
+        bool leased = owner._leased;
+        owner._leased = true;
+#endif
+        if (leased) {
+          _set = new Set(spec);
+          _extra = &_temporaryExtra;
+          _fresh = true;
+          _temporary = true;
+        }
+        else if (!owner._set) {
+          try {
+            owner._set = new Set(spec);
+          } catch (...) {
+            owner._leased = false;
+            throw;
+          }
+          _set = owner._set;
+          _extra = &owner._extra;
+          _fresh = true;
+        }
+        else {
+          _set = owner._set;
+          _extra = &owner._extra;
+          for (PropertyMap::const_iterator i = _set->getProperties().begin(); i != _set->getProperties().end(); ++i) {
+            i->second->reset();
+          }
+        }
+      }
+
+      ReusableSet::Lease::~Lease()
+      {
+        if (_temporary) {
+          delete _set;
+        }
+        else {
+          // a fresh set left by an exception may be missing some of its extra
+          // properties, so make it again next time
+#if __cplusplus >= 201703L
+          bool unwinding = std::uncaught_exceptions() > 0;
+#else
+          bool unwinding = std::uncaught_exception();
+#endif
+          if (_fresh && unwinding) {
+            delete _owner._set;
+            _owner._set = NULL;
+            _owner._extra.clear();
+          }
+#if __cplusplus >= 201103L
+          _owner._leased.store(false, std::memory_order_release);
+#else
+          _owner._leased = false;
+#endif
+        }
+      }
+
       /// is the given string one of the values of a multi-dimensional string prop
       /// this returns a non negative index if it is found, otherwise, -1
       int Set::findStringPropValueIndex(const std::string &propName,
@@ -1073,6 +1257,98 @@ namespace OFX {
         return NULL;
       }
 
+      /// handle one request of the batch suite
+      template<class T> static OfxStatus propBatchRequest(Set *thisSet,
+                                                          const OfxPropertyBatchRequest &request,
+                                                          bool get)
+      {
+        PropertyTemplate<T> *prop = 0;
+        // as for propGetN and propSetN, only gets follow the chained set
+        if(!thisSet->fetchTypedProperty(request.name, prop, get)) {
+          return kOfxStatErrUnknown;
+        }
+        typename T::APIType *values = static_cast<typename T::APIType *>(request.values);
+        if(get) {
+          prop->getValueN(values, request.count);
+        }
+        else {
+          prop->setValueN(values, request.count);
+        }
+        return kOfxStatOK;
+      }
+
+      /// get or set all the requests of a batch
+      static OfxStatus propBatch(OfxPropertySetHandle properties,
+                                 OfxPropertyBatchRequest *requests,
+                                 int nRequests,
+                                 bool get)
+      {
+        Set *thisSet = reinterpret_cast<Set*>(properties);
+        if(!thisSet || !thisSet->verifyMagic()) {
+          return kOfxStatErrBadHandle;
+        }
+
+        OfxStatus stat = kOfxStatOK;
+        for(int i = 0; i < nRequests; ++i) {
+          OfxPropertyBatchRequest &request = requests[i];
+          try {
+            switch(request.type) {
+            case kOfxPropertyBatchTypeInt:
+              request.status = propBatchRequest<IntValue>(thisSet, request, get);
+              break;
+            case kOfxPropertyBatchTypeDouble:
+              request.status = propBatchRequest<DoubleValue>(thisSet, request, get);
+              break;
+            case kOfxPropertyBatchTypeString:
+              request.status = propBatchRequest<StringValue>(thisSet, request, get);
+              break;
+            case kOfxPropertyBatchTypePointer:
+              request.status = propBatchRequest<PointerValue>(thisSet, request, get);
+              break;
+            default:
+              request.status = kOfxStatErrValue;
+              break;
+            }
+          } catch (const Exception& e) {
+            request.status = e.getStatus();
+          } catch (...) {
+            request.status = kOfxStatErrUnknown;
+          }
+#         ifdef OFX_DEBUG_PROPERTIES
+          std::cout << "OFX: " << (get ? "propGetBatch - " : "propSetBatch - ") << properties << ' '
+                    << request.name << ' ' << StatStr(request.status) << std::endl;
+#         endif
+          if(request.status != kOfxStatOK && stat == kOfxStatOK) {
+            stat = request.status;
+          }
+        }
+        return stat;
+      }
+
+      static OfxStatus propGetBatch(OfxPropertySetHandle properties, OfxPropertyBatchRequest *requests, int nRequests)
+      {
+        return propBatch(properties, requests, nRequests, true);
+      }
+
+      static OfxStatus propSetBatch(OfxPropertySetHandle properties, OfxPropertyBatchRequest *requests, int nRequests)
+      {
+        return propBatch(properties, requests, nRequests, false);
+      }
+
+      /// the suite that gets and sets several properties in one call
+      struct OfxPropertyBatchSuiteV1 gBatchSuite = {
+        propGetBatch,
+        propSetBatch
+      };
+
+      /// return the OFX function suite that gets and sets several properties at once
+      const void *GetBatchSuite(int version)
+      {
+        if(version == 1)
+          return (void *)(&gBatchSuite);
+        return NULL;
+      }
+
     }
   }
 }
@@ -0,0 +1,369 @@
+
+/*
+Software License :
+
+Copyright (c) 2007-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <math.h>
+#include <algorithm>
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
+// ofx
+#include "ofxCore.h"
+#include "ofxImageEffect.h"
+
+// ofx host
+#include "ofxhBinary.h"
+#include "ofxhPropertySuite.h"
+#include "ofxhClip.h"
+#include "ofxhParam.h"
+#include "ofxhMemory.h"
+#include "ofxhImageEffect.h"
+#include "ofxhMultiThread.h"
+#include "ofxhUtilities.h"
+#include "ofxhTileScheduler.h"
+
+namespace OFX {
+
+  namespace Host {
+
+    namespace ImageEffect {
+
+      namespace {
+
+        /// the tiles of a render being shared between the threads of the pool
+        struct TileBatch {
+          TileScheduler *scheduler;
+#if __cplusplus >= 201103L
+          std::atomic<size_t> next;   ///< index of the next tile to render
+          std::atomic<int>    status; ///< kOfxStatOK, or that of the first tile that failed
+#else
+          // multiThread() runs every tile on the calling thread before C++11, so one thread
+          // claims them all
+          size_t              next;
+          int                 status;
+#endif
+        };
+
+      }
+
+      TileScheduler::TileScheduler(Instance &instance)
+        : _instance(instance)
+        , _tileBytes(0)
+        , _tileWidth(0)
+        , _tileHeight(0)
+        , _maxThreads(0)
+      {
+      }
+
+      TileScheduler::~TileScheduler()
+      {
+      }
+
+      void TileScheduler::setTileBytes(size_t nBytes)
+      {
+        _tileBytes = nBytes;
+      }
+
+      size_t TileScheduler::getTileBytes() const
+      {
+        // about half a typical per core L2 cache
+        return _tileBytes ? _tileBytes : 256 * 1024;
+      }
+
+      void TileScheduler::setTileSize(int width, int height)
+      {
+        _tileWidth = width;
+        _tileHeight = height;
+      }
+
+      void TileScheduler::setMaxThreads(unsigned int nThreads)
+      {
+        _maxThreads = nThreads;
+      }
+
+      bool TileScheduler::rendersTiles() const
+      {
+        if(!_instance.supportsTiles())
+          return false;
+        for(int i = 0; i < _instance.getNClips(); ++i) {
+          if(!_instance.getNthClip(i)->supportsTiles())
+            return false;
+        }
+        return true;
+      }
+
+      unsigned int TileScheduler::getThreadCount(size_t nTiles) const
+      {
+        if(nTiles < 2 ||
+           _instance.getRenderThreadSafety() != kOfxImageEffectRenderFullySafe ||
+           _instance.requiresSequentialRender())
+          return 1;
+
+        unsigned int nThreads = _maxThreads;
+        if(nThreads == 0) {
+#ifdef OFX_SUPPORTS_MULTITHREAD
+          if(gImageEffectHost->multiThreadNumCPUS(&nThreads) != kOfxStatOK)
+            nThreads = 1;
+#else
+          nThreads = MultiThread::getMaxThreads();
+#endif
+        }
+        if(nThreads > nTiles)
+          nThreads = (unsigned int)nTiles;
+        return nThreads > 0 ? nThreads : 1;
+      }
+
+      size_t TileScheduler::getOutputPixelBytes() const
+      {
+        ClipInstance *output = _instance.getClip(kOfxImageEffectOutputClipName);
+        if(!output)
+          return 16;
+
+        const std::string &depth = output->getPixelDepth();
+        size_t componentBytes = 4;
+        if(depth == kOfxBitDepthByte)
+          componentBytes = 1;
+        else if(depth == kOfxBitDepthShort || depth == kOfxBitDepthHalf)
+          componentBytes = 2;
+
+        const std::string &components = output->getComponents();
+        size_t nComponents = 4;
+        if(components == kOfxImageComponentAlpha)
+          nComponents = 1;
+        else if(components == kOfxImageComponentRGB)
+          nComponents = 3;
+
+        return componentBytes * nComponents;
+      }
+
+      void TileScheduler::makeTiles(const OfxRectI &renderWindow, std::vector<RenderTile> &tiles) const
+      {
+        tiles.clear();
+        int width = renderWindow.x2 - renderWindow.x1;
+        int height = renderWindow.y2 - renderWindow.y1;
+        if(width <= 0 || height <= 0)
+          return;
+
+        RenderTile tile;
+        if(!rendersTiles()) {
+          tile.renderWindow = renderWindow;
+          tiles.push_back(tile);
+        }
+        else if(_tileWidth > 0 && _tileHeight > 0) {
+          for(int y = renderWindow.y1; y < renderWindow.y2; y += _tileHeight) {
+            for(int x = renderWindow.x1; x < renderWindow.x2; x += _tileWidth) {
+              tile.renderWindow.x1 = x;
+              tile.renderWindow.y1 = y;
+              tile.renderWindow.x2 = std::min(x + _tileWidth, renderWindow.x2);
+              tile.renderWindow.y2 = std::min(y + _tileHeight, renderWindow.y2);
+              tiles.push_back(tile);
+            }
+          }
+        }
+        else {
+          // bands of whole rows, as rows are contiguous in memory
+          size_t rowBytes = size_t(width) * getOutputPixelBytes();
+          size_t rows = std::max(getTileBytes() / rowBytes, size_t(1));
+
+          // but enough of them to keep all the threads busy
+          unsigned int nThreads = getThreadCount(height);
+          rows = std::min(rows, (size_t(height) + nThreads - 1) / nThreads);
+
+          tile.renderWindow.x1 = renderWindow.x1;
+          tile.renderWindow.x2 = renderWindow.x2;
+          for(int y = renderWindow.y1; y < renderWindow.y2; y += int(rows)) {
+            tile.renderWindow.y1 = y;
+            tile.renderWindow.y2 = std::min(y + int(rows), renderWindow.y2);
+            tiles.push_back(tile);
+          }
+        }
+      }
+
+      OfxStatus TileScheduler::render(OfxTime      time,
+                                      const std::string &field,
+                                      const OfxRectI &renderWindow,
+                                      OfxPointD   renderScale,
+                                      bool     sequentialRender,
+                                      bool     interactiveRender,
+#                                   ifdef OFX_SUPPORTS_OPENGLRENDER
+                                      bool     openGLRender,
+#                                    ifdef OFX_EXTENSIONS_NATRON
+                                      void*    contextData,
+#                                    endif
+#                                   endif
+                                      bool     draftRender
+#                                   if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+                                      ,
+                                      int view
+#                                   endif
+#                                   ifdef OFX_EXTENSIONS_VEGAS
+                                      ,
+                                      int nViews
+#                                   endif
+#                                   ifdef OFX_EXTENSIONS_NUKE
+                                      ,
+                                      const std::list<std::string>& planes
+#                                   endif
+                                      )
+      {
+        if ( OFX::IsNaN(time) ) {
+          return kOfxStatFailed;
+        }
+
+        _args.time = time;
+        _args.field = &field;
+        _args.renderScale = renderScale;
+        _args.sequentialRender = sequentialRender;
+        _args.interactiveRender = interactiveRender;
+#     ifdef OFX_SUPPORTS_OPENGLRENDER
+        _args.openGLRender = openGLRender;
+#      ifdef OFX_EXTENSIONS_NATRON
+        _args.contextData = contextData;
+#      endif
+#     endif
+        _args.draftRender = draftRender;
+#     if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+        _args.view = view;
+#     endif
+#     ifdef OFX_EXTENSIONS_VEGAS
+        _args.nViews = nViews;
+#     endif
+#     ifdef OFX_EXTENSIONS_NUKE
+        _args.planes = &planes;
+#     endif
+
+        makeTiles(renderWindow, _tiles);
+#     ifdef OFX_SUPPORTS_OPENGLRENDER
+        // the GL context is the calling thread's
+        if(openGLRender && _tiles.size() > 1) {
+          _tiles.resize(1);
+          _tiles[0].renderWindow = renderWindow;
+        }
+#     endif
+        if(_tiles.empty())
+          return kOfxStatOK;
+
+        // regions of interest of the tiles, in canonical coordinates
+        ClipInstance *output = _instance.getClip(kOfxImageEffectOutputClipName);
+        double par = output ? output->getAspectRatio() : 1.;
+        for(size_t i = 0; i < _tiles.size(); ++i) {
+          const OfxRectI &window = _tiles[i].renderWindow;
+          OfxRectD roi;
+          roi.x1 = window.x1 * par / renderScale.x;
+          roi.y1 = window.y1 / renderScale.y;
+          roi.x2 = window.x2 * par / renderScale.x;
+          roi.y2 = window.y2 / renderScale.y;
+          OfxStatus st = _instance.getRegionOfInterestAction(time, renderScale,
+#                                                          ifdef OFX_EXTENSIONS_NUKE
+                                                             view,
+#                                                          endif
+                                                             roi, _tiles[i].rois);
+          if(st != kOfxStatOK && st != kOfxStatReplyDefault)
+            return st;
+        }
+
+        TileBatch batch;
+        batch.scheduler = this;
+        batch.next = 0;
+        batch.status = kOfxStatOK;
+        unsigned int nThreads = getThreadCount(_tiles.size());
+        if(nThreads > 1) {
+#ifdef OFX_SUPPORTS_MULTITHREAD
+          OfxStatus st = gImageEffectHost->multiThread(renderTiles, nThreads, &batch);
+#else
+          OfxStatus st = MultiThread::multiThread(renderTiles, nThreads, &batch);
+#endif
+          if(st != kOfxStatOK)
+            return st;
+        }
+        else {
+          renderTiles(0, 1, &batch);
+        }
+        return batch.status;
+      }
+
+      void TileScheduler::renderTiles(unsigned int /*threadIndex*/, unsigned int /*threadMax*/, void *arg)
+      {
+        TileBatch &batch = *static_cast<TileBatch *>(arg);
+        std::vector<RenderTile> &tiles = batch.scheduler->_tiles;
+        for(size_t i = batch.next++; i < tiles.size(); i = batch.next++) {
+          OfxStatus st = batch.scheduler->renderTile(tiles[i]);
+          if(st != kOfxStatOK) {
+#if __cplusplus >= 201103L
+            int ok = kOfxStatOK;
+            batch.status.compare_exchange_strong(ok, st);
+#else
+            if(batch.status == kOfxStatOK)
+              batch.status = st;
+#endif
+            // skip the tiles not started yet
+            batch.next = tiles.size();
+            return;
+          }
+        }
+      }
+
+      OfxStatus TileScheduler::renderTile(const RenderTile &tile)
+      {
+        return _instance.renderAction(_args.time,
+                                      *_args.field,
+                                      tile.renderWindow,
+                                      _args.renderScale,
+                                      _args.sequentialRender,
+                                      _args.interactiveRender,
+#                                   ifdef OFX_SUPPORTS_OPENGLRENDER
+                                      _args.openGLRender,
+#                                    ifdef OFX_EXTENSIONS_NATRON
+                                      _args.contextData,
+#                                    endif
+#                                   endif
+                                      _args.draftRender
+#                                   if defined(OFX_EXTENSIONS_VEGAS) || defined(OFX_EXTENSIONS_NUKE)
+                                      ,
+                                      _args.view
+#                                   endif
+#                                   ifdef OFX_EXTENSIONS_VEGAS
+                                      ,
+                                      _args.nViews
+#                                   endif
+#                                   ifdef OFX_EXTENSIONS_NUKE
+                                      ,
+                                      *_args.planes
+#                                   endif
+                                      );
+      }
+
+    } // ImageEffect
+
+  } // Host
+
+} // OFX
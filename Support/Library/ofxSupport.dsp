@@ -115,6 +115,10 @@ SOURCE=.\ofxsProperty.cpp
 
 SOURCE=.\ofxsPropertyValidation.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=.\ofxsTrace.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
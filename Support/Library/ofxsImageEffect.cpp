@@ -39,12 +39,17 @@ England
 #include "ofxsSupportPrivate.h"
 #include <algorithm> // for find, min, max
 #include <cstring> // for strlen
+#include <cstdlib> // for abs
 #include <sstream> // stringstream
 #include <set>
 #ifdef DEBUG
 #include <iostream>
 #endif
 #include <stdexcept>
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <mutex>
+#endif
 #ifdef OFX_EXTENSIONS_NUKE
 #include "nuke/fnOfxExtensions.h"
 #endif
@@ -211,7 +216,12 @@ namespace OFX {
     OFX::PluginFactory* _factory;
     OfxPlugin* _plug;
   };
+#if __cplusplus >= 201402L
+  // a transparent comparator, so that looking up the plugin named in each action does not build a string
+  typedef std::map<std::string, OfxPlugInfo, std::less<> > OfxPlugInfoMap;
+#else
   typedef std::map<std::string, OfxPlugInfo> OfxPlugInfoMap;
+#endif
   OfxPlugInfoMap plugInfoMap;
 
   typedef std::vector<OfxPlugin*> OfxPluginArray;
@@ -268,6 +278,7 @@ namespace OFX {
     OfxHost               *gHost = 0;
     OfxImageEffectSuiteV1 *gEffectSuite = 0;
     OfxPropertySuiteV1    *gPropSuite = 0;
+    OfxPropertyBatchSuiteV1 *gPropBatchSuite = 0;
     OfxInteractSuiteV1    *gInteractSuite = 0;
     OfxParameterSuiteV1   *gParamSuite = 0;
     OfxMemorySuiteV1      *gMemorySuite = 0;
@@ -302,6 +313,22 @@ namespace OFX {
     // @brief the set of descriptors, one per context used by kOfxActionDescribeInContext,
     //'eContextNone' is the one used by the kOfxActionDescribe
     EffectDescriptorMap gEffectDescriptors;
+
+    ImageEffectDescriptor *getEffectDescriptor(const char *plugname, unsigned int majorVersion, unsigned int minorVersion, ContextEnum context)
+    {
+#if __cplusplus >= 201402L
+      VersionIDRef ref = { plugname, majorVersion, minorVersion };
+      EffectDescriptorMap::iterator it = gEffectDescriptors.find(ref);
+      if (it != gEffectDescriptors.end()) {
+        return it->second[context];
+      }
+#endif
+      VersionIDKey key;
+      key.id = plugname;
+      key.majorVersion = majorVersion;
+      key.minorVersion = minorVersion;
+      return gEffectDescriptors[key][context];
+    }
   };
 
   /** @brief map a std::string to a context */
@@ -916,7 +943,11 @@ namespace OFX {
   {
     // fetch the property set handle of the effect
     OfxPropertySetHandle props;
-    OfxStatus stat = OFX::Private::gEffectSuite->getPropertySet(handle, &props);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("getPropertySet");
+      stat = OFX::Private::gEffectSuite->getPropertySet(handle, &props);
+    }
     throwSuiteStatusException(stat);
     _effectProps.propSetHandle(props);
 
@@ -924,7 +955,10 @@ namespace OFX {
 
     // fetch the param set handle and set it in our ParamSetDescriptor base
     OfxParamSetHandle paramSetHandle;
-    stat = OFX::Private::gEffectSuite->getParamSet(handle, &paramSetHandle);
+    {
+      OFXS_TRACE_SUITE_CALL("getParamSet");
+      stat = OFX::Private::gEffectSuite->getParamSet(handle, &paramSetHandle);
+    }
     throwSuiteStatusException(stat);
     setParamSetHandle(paramSetHandle);
   }
@@ -1488,7 +1522,11 @@ namespace OFX {
 
     // no, so make it
     OfxPropertySetHandle propSet;
-    OfxStatus stat = OFX::Private::gEffectSuite->clipDefine(_effectHandle, name.c_str(), &propSet);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("clipDefine");
+      stat = OFX::Private::gEffectSuite->clipDefine(_effectHandle, name.c_str(), &propSet);
+    }
     throwSuiteStatusException(stat);
 
     ClipDescriptor *clip = new ClipDescriptor(name, propSet);
@@ -1585,11 +1623,32 @@ namespace OFX {
     OFX::Validation::validateImageBaseProperties(props);
 
     // and fetch all the properties
-    _rowBytes         = _imageProps.propGetInt(kOfxImagePropRowBytes);
-    _pixelAspectRatio = _imageProps.propGetDouble(kOfxImagePropPixelAspectRatio);;
-      
-    std::string str  = _imageProps.propGetString(kOfxImageEffectPropComponents);
-    _pixelComponents = mapStrToPixelComponentEnum(str);
+    std::string componentsStr, depthStr, premultStr, fieldStr;
+    _renderScale.x = _renderScale.y = 1.;
+    if(!fetchPropertiesBatched(componentsStr, depthStr, premultStr, fieldStr)) {
+      _rowBytes         = _imageProps.propGetInt(kOfxImagePropRowBytes);
+      _pixelAspectRatio = _imageProps.propGetDouble(kOfxImagePropPixelAspectRatio);;
+      componentsStr     = _imageProps.propGetString(kOfxImageEffectPropComponents);
+      depthStr          = _imageProps.propGetString(kOfxImageEffectPropPixelDepth);
+      premultStr        = _imageProps.propGetString(kOfxImageEffectPropPreMultiplication);
+
+      _regionOfDefinition.x1 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 0);
+      _regionOfDefinition.y1 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 1);
+      _regionOfDefinition.x2 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 2);
+      _regionOfDefinition.y2 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 3);
+
+      _bounds.x1 = _imageProps.propGetInt(kOfxImagePropBounds, 0);
+      _bounds.y1 = _imageProps.propGetInt(kOfxImagePropBounds, 1);
+      _bounds.x2 = _imageProps.propGetInt(kOfxImagePropBounds, 2);
+      _bounds.y2 = _imageProps.propGetInt(kOfxImagePropBounds, 3);
+
+      fieldStr  = _imageProps.propGetString(kOfxImagePropField);
+      _uniqueID = _imageProps.propGetString(kOfxImagePropUniqueIdentifier);
+
+      _imageProps.propGetDoubleN(kOfxImageEffectPropRenderScale, &_renderScale.x, 2, false);
+    }
+
+    _pixelComponents = mapStrToPixelComponentEnum(componentsStr);
 
     switch (_pixelComponents) {
       case ePixelComponentAlpha:
@@ -1620,7 +1679,7 @@ namespace OFX {
 
         std::string planeName, planeLabel, channelsLabel;
         std::vector<std::string> channels;
-        extractCustomPlane(str, &planeName, &planeLabel, &channelsLabel, &channels);
+        extractCustomPlane(componentsStr, &planeName, &planeLabel, &channelsLabel, &channels);
         _pixelComponentCount = (int)channels.size();
 #else
         _pixelComponentCount = 0;
@@ -1631,8 +1690,7 @@ namespace OFX {
         break;
     }
 
-    str = _imageProps.propGetString(kOfxImageEffectPropPixelDepth);
-    _pixelDepth = mapStrToBitDepthEnum(str);
+    _pixelDepth = mapStrToBitDepthEnum(depthStr);
 
     // compute bytes per pixel
     _pixelBytes = _pixelComponentCount;
@@ -1652,42 +1710,25 @@ namespace OFX {
     case eBitDepthCustom : _pixelBytes *= 0; break;
     }
 
-    str = _imageProps.propGetString(kOfxImageEffectPropPreMultiplication);
-    _preMultiplication =  mapStrToPreMultiplicationEnum(str);
-
-    _regionOfDefinition.x1 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 0);
-    _regionOfDefinition.y1 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 1);
-    _regionOfDefinition.x2 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 2);
-    _regionOfDefinition.y2 = _imageProps.propGetInt(kOfxImagePropRegionOfDefinition, 3);
-
-    _bounds.x1 = _imageProps.propGetInt(kOfxImagePropBounds, 0);
-    _bounds.y1 = _imageProps.propGetInt(kOfxImagePropBounds, 1);
-    _bounds.x2 = _imageProps.propGetInt(kOfxImagePropBounds, 2);
-    _bounds.y2 = _imageProps.propGetInt(kOfxImagePropBounds, 3);
+    _preMultiplication =  mapStrToPreMultiplicationEnum(premultStr);
 
-    str = _imageProps.propGetString(kOfxImagePropField);
-    if(str == kOfxImageFieldNone) {
+    if(fieldStr == kOfxImageFieldNone) {
       _field = eFieldNone;
     }
-    else if(str == kOfxImageFieldBoth) {
+    else if(fieldStr == kOfxImageFieldBoth) {
       _field = eFieldBoth;
     }
-    else if(str == kOfxImageFieldLower) {
+    else if(fieldStr == kOfxImageFieldLower) {
       _field = eFieldLower;
     }
-    else if(str == kOfxImageFieldUpper) {
+    else if(fieldStr == kOfxImageFieldUpper) {
       _field = eFieldLower;
     }
     else {
-      OFX::Log::error(true, "Unknown field state '%s' reported on an image", str.c_str());
+      OFX::Log::error(true, "Unknown field state '%s' reported on an image", fieldStr.c_str());
       _field = eFieldNone;
     }
 
-    _uniqueID = _imageProps.propGetString(kOfxImagePropUniqueIdentifier);
-
-    _renderScale.x = _renderScale.y = 1.;
-    _imageProps.propGetDoubleN(kOfxImageEffectPropRenderScale, &_renderScale.x, 2, false);
-
 #if defined(OFX_EXTENSIONS_NATRON) || defined(OFX_EXTENSIONS_NUKE)
     bool gotDistortion = false;
 #endif
@@ -1739,6 +1780,51 @@ namespace OFX {
   {
   }
 
+  /** @brief fetch the properties read by the constructor in a single suite call
+
+  Returns false if the host has no property batch suite, or if any of the required
+  properties could not be fetched, in which case the constructor fetches them one
+  by one to report the error as usual.
+  */
+  bool ImageBase::fetchPropertiesBatched(std::string &components, std::string &depth, std::string &premult, std::string &field)
+  {
+    if(!OFX::Private::gPropBatchSuite)
+      return false;
+
+    const char *componentsStr = 0, *depthStr = 0, *premultStr = 0, *fieldStr = 0, *uniqueIDStr = 0;
+    OfxPropertyBatchRequest requests[] = {
+      { kOfxImagePropRowBytes,                kOfxPropertyBatchTypeInt,    1, &_rowBytes,              kOfxStatOK },
+      { kOfxImagePropPixelAspectRatio,        kOfxPropertyBatchTypeDouble, 1, &_pixelAspectRatio,      kOfxStatOK },
+      { kOfxImageEffectPropComponents,        kOfxPropertyBatchTypeString, 1, &componentsStr,          kOfxStatOK },
+      { kOfxImageEffectPropPixelDepth,        kOfxPropertyBatchTypeString, 1, &depthStr,               kOfxStatOK },
+      { kOfxImageEffectPropPreMultiplication, kOfxPropertyBatchTypeString, 1, &premultStr,             kOfxStatOK },
+      { kOfxImagePropRegionOfDefinition,      kOfxPropertyBatchTypeInt,    4, &_regionOfDefinition.x1, kOfxStatOK },
+      { kOfxImagePropBounds,                  kOfxPropertyBatchTypeInt,    4, &_bounds.x1,             kOfxStatOK },
+      { kOfxImagePropField,                   kOfxPropertyBatchTypeString, 1, &fieldStr,               kOfxStatOK },
+      { kOfxImagePropUniqueIdentifier,        kOfxPropertyBatchTypeString, 1, &uniqueIDStr,            kOfxStatOK },
+      // optional, must stay last
+      { kOfxImageEffectPropRenderScale,       kOfxPropertyBatchTypeDouble, 2, &_renderScale.x,         kOfxStatOK },
+    };
+    const int nRequests = sizeof(requests) / sizeof(requests[0]);
+
+    OFXS_TRACE_SUITE_CALL("propGetBatch");
+    OfxStatus stat = OFX::Private::gPropBatchSuite->propGetBatch(_imageProps.propSetHandle(), requests, nRequests);
+    if(stat != kOfxStatOK) {
+      for(int i = 0; i < nRequests - 1; ++i) {
+        if(requests[i].status != kOfxStatOK)
+          return false;
+      }
+      _renderScale.x = _renderScale.y = 1.;
+    }
+
+    components = componentsStr;
+    depth      = depthStr;
+    premult    = premultStr;
+    field      = fieldStr;
+    _uniqueID  = uniqueIDStr;
+    return true;
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   // wraps up an image  
   Image::Image(OfxPropertySetHandle props)
@@ -1754,6 +1840,7 @@ namespace OFX {
   Image::~Image()
   {
     // error are ignored: don't throw in a destructor
+    OFXS_TRACE_SUITE_CALL("clipReleaseImage");
     OFX::Private::gEffectSuite->clipReleaseImage(_imageProps.propSetHandle());
   }
 
@@ -2139,6 +2226,7 @@ namespace OFX {
     }
 #  endif
     OfxRectD bounds;
+    OFXS_TRACE_SUITE_CALL("clipGetRegionOfDefinition");
     OfxStatus stat = OFX::Private::gEffectSuite->clipGetRegionOfDefinition(_clipHandle, t, &bounds);
     if(stat == kOfxStatFailed) {
       bounds.x1 = bounds.x2 = bounds.y1 = bounds.y2 = 0;
@@ -2155,6 +2243,15 @@ namespace OFX {
   }
 #endif
 
+#ifdef OFXS_TRACE
+  /** @brief the bytes in a fetched image, for the trace */
+  static uint64_t traceImageBytes(const Image *image)
+  {
+    const OfxRectI &bounds = image->getBounds();
+    return (uint64_t) std::abs(image->getRowBytes()) * (uint64_t) std::max(bounds.y2 - bounds.y1, 0);
+  }
+#endif
+
   /** @brief fetch an image */
   Image *Clip::fetchImage(double t)
   {
@@ -2163,6 +2260,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_IMAGE_FETCH("clipGetImage");
     OfxPropertySetHandle imageHandle;
     OfxStatus stat = OFX::Private::gEffectSuite->clipGetImage(_clipHandle, t, NULL, &imageHandle);
     if(stat == kOfxStatFailed) {
@@ -2171,7 +2269,9 @@ namespace OFX {
     else
       throwSuiteStatusException(stat);
 
-    return new Image(imageHandle);
+    Image *image = new Image(imageHandle);
+    OFXS_TRACE_SET_BYTES(traceImageBytes(image));
+    return image;
   }
 
   /** @brief fetch an image, with a specific region in cannonical coordinates */
@@ -2182,6 +2282,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_IMAGE_FETCH("clipGetImage");
     OfxPropertySetHandle imageHandle;
     OfxStatus stat = OFX::Private::gEffectSuite->clipGetImage(_clipHandle, t, &bounds, &imageHandle);
     if(stat == kOfxStatFailed) {
@@ -2190,7 +2291,9 @@ namespace OFX {
     else
       throwSuiteStatusException(stat);
 
-    return new Image(imageHandle);
+    Image *image = new Image(imageHandle);
+    OFXS_TRACE_SET_BYTES(traceImageBytes(image));
+    return image;
   }
     
 #ifdef OFX_EXTENSIONS_NUKE
@@ -2223,6 +2326,7 @@ namespace OFX {
     if (!OFX::Private::gImageEffectPlaneSuiteV2 || !OFX::Private::gImageEffectPlaneSuiteV2->clipGetImagePlane) {
       throwHostMissingSuiteException(kFnOfxImageEffectPlaneSuite"V2");
     }
+    OFXS_TRACE_IMAGE_FETCH("clipGetImagePlane");
     OfxPropertySetHandle imageHandle;
     OfxStatus stat = OFX::Private::gImageEffectPlaneSuiteV2->clipGetImagePlane(_clipHandle, t, view, plane, NULL, &imageHandle);
     if(stat == kOfxStatFailed) {
@@ -2231,7 +2335,9 @@ namespace OFX {
     else
       throwSuiteStatusException(stat);
       
-    return new Image(imageHandle);
+    Image *image = new Image(imageHandle);
+    OFXS_TRACE_SET_BYTES(traceImageBytes(image));
+    return image;
   }
     
   Image* Clip::fetchImagePlane(double t, const char* plane)
@@ -2248,6 +2354,7 @@ namespace OFX {
       throwHostMissingSuiteException(kFnOfxImageEffectPlaneSuite"V1");
       return NULL;
     }
+    OFXS_TRACE_IMAGE_FETCH("clipGetImagePlane");
     OfxPropertySetHandle imageHandle;
     OfxStatus stat = OFX::Private::gImageEffectPlaneSuiteV1->clipGetImagePlane(_clipHandle, t, plane, NULL, &imageHandle);
     if(stat == kOfxStatFailed) {
@@ -2256,7 +2363,9 @@ namespace OFX {
     else
       throwSuiteStatusException(stat);
       
-    return new Image(imageHandle);
+    Image *image = new Image(imageHandle);
+    OFXS_TRACE_SET_BYTES(traceImageBytes(image));
+    return image;
   }
     
   Image* Clip::fetchImagePlane(double t, int view, const char* plane, const OfxRectD& bounds)
@@ -2269,6 +2378,7 @@ namespace OFX {
     if (!OFX::Private::gImageEffectPlaneSuiteV2 || !OFX::Private::gImageEffectPlaneSuiteV2->clipGetImagePlane) {
       throwHostMissingSuiteException(kFnOfxImageEffectPlaneSuite"V2");
     }
+    OFXS_TRACE_IMAGE_FETCH("clipGetImagePlane");
     OfxPropertySetHandle imageHandle;
 
     OfxStatus stat = OFX::Private::gImageEffectPlaneSuiteV2->clipGetImagePlane(_clipHandle, t, view, plane, &bounds, &imageHandle);
@@ -2278,7 +2388,9 @@ namespace OFX {
     else
       throwSuiteStatusException(stat);
 
-    return new Image(imageHandle);
+    Image *image = new Image(imageHandle);
+    OFXS_TRACE_SET_BYTES(traceImageBytes(image));
+    return image;
   }
     
   Image* Clip::fetchImagePlane(double t, const char* plane, const OfxRectD& bounds)
@@ -2295,6 +2407,7 @@ namespace OFX {
       throwHostMissingSuiteException(kFnOfxImageEffectPlaneSuite"V1");
       return NULL;
     }
+    OFXS_TRACE_IMAGE_FETCH("clipGetImagePlane");
     OfxPropertySetHandle imageHandle;
 
     OfxStatus stat = OFX::Private::gImageEffectPlaneSuiteV1->clipGetImagePlane(_clipHandle, t, plane, &bounds, &imageHandle);
@@ -2304,7 +2417,9 @@ namespace OFX {
     else
       throwSuiteStatusException(stat);
 
-    return new Image(imageHandle);
+    Image *image = new Image(imageHandle);
+    OFXS_TRACE_SET_BYTES(traceImageBytes(image));
+    return image;
   }
     
   void Clip::getPlanesPresent(std::vector<std::string>* components) const
@@ -2485,7 +2600,11 @@ namespace OFX {
 
     // the param set daddy-oh
     OfxParamSetHandle paramSet;
-    OfxStatus stat = OFX::Private::gEffectSuite->getParamSet(handle, &paramSet);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("getParamSet");
+      stat = OFX::Private::gEffectSuite->getParamSet(handle, &paramSet);
+    }
     throwSuiteStatusException(stat);
     setParamSetHandle(paramSet);      
 
@@ -2494,11 +2613,16 @@ namespace OFX {
     _hostIsFusion = (hostDescription.hostName == "com.eyeonline.Fusion") || (hostDescription.hostName == "com.blackmagicdesign.Fusion"); // Fusion gives inverse RS props in inargs and on the images
     _hostIsVegas = (hostDescription.hostName.rfind("com.sonycreativesoftware.vegas", 0) == 0); // Vegas, and probably VegasMovieStudio, always use renderScale, and do not set it in the image props, see https://github.com/NatronGitHub/openfx-misc/issues/66#issuecomment-562783481
     _ignoreBadRenderScale = _hostIsResolve || _hostIsFusion || _hostIsVegas;
+
+    // only now that we are fully constructed, let the actions find us without going through the host
+    OFX::Private::registerImageEffectPointer(handle, this);
   }
 
   /** @brief dtor */
   ImageEffect::~ImageEffect()
   {
+    OFX::Private::unregisterImageEffectPointer(_effectHandle);
+
     // clobber the instance data property on the effect handle
     try {
       _effectProps.propSetPointer(kOfxPropInstanceData, 0, false);
@@ -2741,7 +2865,11 @@ namespace OFX {
     // fetch the property set handle of the effect
     OfxImageClipHandle clipHandle = 0;
     OfxPropertySetHandle propHandle = 0;
-    OfxStatus stat = OFX::Private::gEffectSuite->clipGetHandle(_effectHandle, name.c_str(), &clipHandle, &propHandle);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("clipGetHandle");
+      stat = OFX::Private::gEffectSuite->clipGetHandle(_effectHandle, name.c_str(), &clipHandle, &propHandle);
+    }
     throwSuiteStatusException(stat);
 
     // and make one
@@ -2799,6 +2927,7 @@ namespace OFX {
   /** @brief does the host want us to abort rendering? */
   bool ImageEffect::abort(void) const
   {
+    OFXS_TRACE_SUITE_CALL("abort");
     return OFX::Private::gEffectSuite->abort(_effectHandle) != 0;
   }
 
@@ -3703,6 +3832,7 @@ namespace OFX {
       effectHandle = associatedEffect->_effectHandle;
     }
 
+    OFXS_TRACE_BYTES("imageMemoryAlloc", nBytes);
     OfxStatus stat = OFX::Private::gEffectSuite->imageMemoryAlloc(effectHandle, nBytes, &_handle);
     if(stat == kOfxStatErrMemory)
       throw std::bad_alloc();
@@ -3712,6 +3842,7 @@ namespace OFX {
   /** @brief dtor */
   ImageMemory::~ImageMemory()
   {
+    OFXS_TRACE_SUITE_CALL("imageMemoryFree");
     OfxStatus stat = OFX::Private::gEffectSuite->imageMemoryFree(_handle);
     // ignore status code for exception purposes
     (void)stat;
@@ -3721,6 +3852,7 @@ namespace OFX {
   void *ImageMemory::lock(void)
   {
     void *ptr;
+    OFXS_TRACE_SUITE_CALL("imageMemoryLock");
     OfxStatus stat = OFX::Private::gEffectSuite->imageMemoryLock(_handle, &ptr);
     if(stat == kOfxStatErrMemory)
       throw std::bad_alloc();
@@ -3731,6 +3863,7 @@ namespace OFX {
   /** @brief unlock the memory */
   void ImageMemory::unlock(void)
   {
+    OFXS_TRACE_SUITE_CALL("imageMemoryUnlock");
     OfxStatus stat = OFX::Private::gEffectSuite->imageMemoryUnlock(_handle);
     (void)stat;
   }
@@ -3932,6 +4065,7 @@ namespace OFX {
     {
       // get the property handle
       OfxPropertySetHandle propHandle;
+      OFXS_TRACE_SUITE_CALL("getPropertySet");
       OfxStatus stat = OFX::Private::gEffectSuite->getPropertySet(handle, &propHandle);
       throwSuiteStatusException(stat);
       return OFX::PropertySet(propHandle);
@@ -3954,6 +4088,7 @@ namespace OFX {
       if(gLoadCount == 1) {
         gEffectSuite    = (OfxImageEffectSuiteV1 *) fetchSuite(kOfxImageEffectSuite, 1);
         gPropSuite      = (OfxPropertySuiteV1 *)    fetchSuite(kOfxPropertySuite, 1);
+        gPropBatchSuite = (OfxPropertyBatchSuiteV1 *) fetchSuite(kOfxPropertyBatchSuite, 1, true);
         gParamSuite     = (OfxParameterSuiteV1 *)   fetchSuite(kOfxParameterSuite, 1);
         gMemorySuite    = (OfxMemorySuiteV1 *)      fetchSuite(kOfxMemorySuite, 1);
         gThreadSuite    = (OfxMultiThreadSuiteV1 *) fetchSuite(kOfxMultiThreadSuite, 1);
@@ -4023,6 +4158,7 @@ namespace OFX {
         // force these to null
         gEffectSuite = 0;
         gPropSuite = 0;
+        gPropBatchSuite = 0;
         gParamSuite = 0;
         gMemorySuite = 0;
         gThreadSuite = 0;
@@ -4076,14 +4212,152 @@ namespace OFX {
     }
 
 
+#if __cplusplus >= 201103L
+    /** @brief a side table from effect handles to our instances.
+
+    Every action starts by finding the instance for its handle, which through the host is two suite
+    calls and a property lookup. This table answers instead, without a lock on the read side.
+
+    It is open addressed and linearly probed. Creating and destroying instances is rare, so writers
+    serialise on a mutex. A slot's key is only ever swapped for another key or a tombstone, never
+    back to empty, so a reader can stop probing at the first empty slot. Writers store the instance
+    before the key and clear it before the key, and a reader checks the key again after reading the
+    instance, so it never returns an instance that belongs to another handle. Whenever the table
+    cannot answer, because it is full or a slot is being rewritten, we ask the host as before.
+    */
+    class ImageEffectTable {
+    public :
+      ImageEffectTable()
+      {
+        for(int i = 0; i < kNSlots; ++i) {
+          _slots[i].handle.store(NULL, std::memory_order_relaxed);
+          _slots[i].instance.store(NULL, std::memory_order_relaxed);
+        }
+      }
+
+      void insert(OfxImageEffectHandle handle, ImageEffect *instance)
+      {
+        std::lock_guard<std::mutex> guard(_writeMutex);
+        Slot *free = NULL;
+        for(unsigned i = hash(handle), n = 0; n < kNSlots; i = (i + 1) & (kNSlots - 1), ++n) {
+          OfxImageEffectHandle key = _slots[i].handle.load(std::memory_order_relaxed);
+          if(key == handle) {
+            // the host is reusing the handle of an instance we were not told about the death of
+            _slots[i].instance.store(instance, std::memory_order_release);
+            return;
+          }
+          if(key == tombstone() && !free)
+            free = &_slots[i];
+          if(!key) {
+            if(!free)
+              free = &_slots[i];
+            break;
+          }
+        }
+        if(!free)
+          return; // full, retrieveImageEffectPointer will fall back on the host
+        free->instance.store(instance, std::memory_order_relaxed);
+        free->handle.store(handle, std::memory_order_release);
+      }
+
+      void erase(OfxImageEffectHandle handle)
+      {
+        std::lock_guard<std::mutex> guard(_writeMutex);
+        if(Slot *slot = find(handle)) {
+          slot->instance.store(NULL, std::memory_order_relaxed);
+          slot->handle.store(tombstone(), std::memory_order_release);
+        }
+      }
+
+      /** @brief the instance for the handle, or NULL if the table does not know it */
+      ImageEffect *lookup(OfxImageEffectHandle handle) const
+      {
+        const Slot *slot = find(handle);
+        if(!slot)
+          return NULL;
+        ImageEffect *instance = slot->instance.load(std::memory_order_acquire);
+        if(slot->handle.load(std::memory_order_acquire) != handle)
+          return NULL;
+        return instance;
+      }
+
+    private :
+      enum { kNSlots = 1024 }; // a power of two, well over the number of instances a host keeps alive
+
+      struct Slot {
+        std::atomic<OfxImageEffectHandle> handle;
+        std::atomic<ImageEffect *>        instance;
+      };
+
+      static OfxImageEffectHandle tombstone()
+      {
+        static char marker;
+        return (OfxImageEffectHandle) &marker;
+      }
+
+      static unsigned hash(OfxImageEffectHandle handle)
+      {
+        size_t v = (size_t) handle;
+        return (unsigned) ((v >> 4) ^ (v >> 14)) & (kNSlots - 1);
+      }
+
+      const Slot *find(OfxImageEffectHandle handle) const
+      {
+        for(unsigned i = hash(handle), n = 0; n < kNSlots; i = (i + 1) & (kNSlots - 1), ++n) {
+          OfxImageEffectHandle key = _slots[i].handle.load(std::memory_order_acquire);
+          if(key == handle)
+            return &_slots[i];
+          if(!key)
+            return NULL;
+        }
+        return NULL;
+      }
+
+      Slot *find(OfxImageEffectHandle handle)
+      {
+        return const_cast<Slot *>(static_cast<const ImageEffectTable *>(this)->find(handle));
+      }
+
+      Slot       _slots[kNSlots];
+      std::mutex _writeMutex;
+    };
+
+    static ImageEffectTable gImageEffectTable;
+
+    void registerImageEffectPointer(OfxImageEffectHandle handle, ImageEffect *instance)
+    {
+      if(handle)
+        gImageEffectTable.insert(handle, instance);
+    }
+
+    void unregisterImageEffectPointer(OfxImageEffectHandle handle)
+    {
+      if(handle)
+        gImageEffectTable.erase(handle);
+    }
+#else
+    // without atomics we always ask the host
+    void registerImageEffectPointer(OfxImageEffectHandle, ImageEffect *) {}
+    void unregisterImageEffectPointer(OfxImageEffectHandle) {}
+#endif
+
     /** @brief fetches our pointer out of the props on the handle */
     ImageEffect *retrieveImageEffectPointer(OfxImageEffectHandle handle) 
     {
+#if __cplusplus >= 201103L
+      if(ImageEffect *cached = gImageEffectTable.lookup(handle))
+        return cached;
+#endif
+
       ImageEffect *instance;
 
       // get the prop set on the handle
       OfxPropertySetHandle propHandle;
-      OfxStatus stat = OFX::Private::gEffectSuite->getPropertySet(handle, &propHandle);
+      OfxStatus stat;
+      {
+        OFXS_TRACE_SUITE_CALL("getPropertySet");
+        stat = OFX::Private::gEffectSuite->getPropertySet(handle, &propHandle);
+      }
       throwSuiteStatusException(stat);
 
       // make our wrapper object
@@ -4102,30 +4376,152 @@ namespace OFX {
       return instance;
     }
 
+    /** @brief the actions we dispatch on and their names */
+    static const struct {
+      ActionEnum  action;
+      const char *name;
+    } gActionNames[] = {
+      { eActionLoad,                  kOfxActionLoad },
+      { eActionUnload,                kOfxActionUnload },
+      { eActionDescribe,              kOfxActionDescribe },
+      { eActionDescribeInContext,     kOfxImageEffectActionDescribeInContext },
+      { eActionCreateInstance,        kOfxActionCreateInstance },
+      { eActionDestroyInstance,       kOfxActionDestroyInstance },
+      { eActionRender,                kOfxImageEffectActionRender },
+      { eActionBeginSequenceRender,   kOfxImageEffectActionBeginSequenceRender },
+      { eActionEndSequenceRender,     kOfxImageEffectActionEndSequenceRender },
+      { eActionIsIdentity,            kOfxImageEffectActionIsIdentity },
+      { eActionGetRegionOfDefinition, kOfxImageEffectActionGetRegionOfDefinition },
+      { eActionGetRegionsOfInterest,  kOfxImageEffectActionGetRegionsOfInterest },
+      { eActionGetFramesNeeded,       kOfxImageEffectActionGetFramesNeeded },
+      { eActionGetClipPreferences,    kOfxImageEffectActionGetClipPreferences },
+      { eActionPurgeCaches,           kOfxActionPurgeCaches },
+      { eActionSyncPrivateData,       kOfxActionSyncPrivateData },
+      { eActionGetTimeDomain,         kOfxImageEffectActionGetTimeDomain },
+      { eActionBeginInstanceChanged,  kOfxActionBeginInstanceChanged },
+      { eActionInstanceChanged,       kOfxActionInstanceChanged },
+      { eActionEndInstanceChanged,    kOfxActionEndInstanceChanged },
+      { eActionBeginInstanceEdit,     kOfxActionBeginInstanceEdit },
+      { eActionEndInstanceEdit,       kOfxActionEndInstanceEdit },
+#ifdef OFX_SUPPORTS_OPENGLRENDER
+      { eActionOpenGLContextAttached, kOfxActionOpenGLContextAttached },
+      { eActionOpenGLContextDetached, kOfxActionOpenGLContextDetached },
+#endif
+#ifdef OFX_SUPPORTS_DIALOG
+      { eActionDialog,                kOfxActionDialog },
+#endif
+#ifdef OFX_EXTENSIONS_VEGAS
+      { eActionVegasKeyframeUplift,   kOfxImageEffectActionVegasKeyframeUplift },
+      { eActionInvokeHelp,            kOfxImageEffectActionInvokeHelp },
+      { eActionInvokeAbout,           kOfxImageEffectActionInvokeAbout },
+#endif
+#ifdef OFX_EXTENSIONS_NUKE
+      { eActionGetClipComponents,     kFnOfxImageEffectActionGetClipComponents },
+      { eActionGetFrameViewsNeeded,   kFnOfxImageEffectActionGetFrameViewsNeeded },
+      { eActionGetTransform,          kFnOfxImageEffectActionGetTransform },
+#endif
+#ifdef OFX_EXTENSIONS_NATRON
+      { eActionGetInverseDistortion,  kOfxImageEffectActionGetInverseDistortion },
+#endif
+    };
+
+    /** @brief an open addressed hash table of the action names.
+
+    It is a static object rather than a function static, so it is built when the binary
+    is loaded and never raced over by render threads.
+    */
+    class ActionTable {
+    public :
+      ActionTable()
+      {
+        for(int i = 0; i < kNSlots; ++i) {
+          _slots[i].name = 0;
+          _slots[i].action = eActionUnknown;
+        }
+        for(size_t i = 0; i < sizeof(gActionNames) / sizeof(gActionNames[0]); ++i) {
+          unsigned j = hash(gActionNames[i].name);
+          while(_slots[j].name)
+            j = (j + 1) & (kNSlots - 1);
+          _slots[j].name = gActionNames[i].name;
+          _slots[j].action = gActionNames[i].action;
+        }
+      }
+
+      ActionEnum find(const char *name) const
+      {
+        if(!name)
+          return eActionUnknown;
+        for(unsigned j = hash(name); _slots[j].name; j = (j + 1) & (kNSlots - 1)) {
+          // the host usually hands back our own constants, or its copy of them
+          if(_slots[j].name == name || strcmp(_slots[j].name, name) == 0)
+            return _slots[j].action;
+        }
+        return eActionUnknown;
+      }
+
+    private :
+      enum { kNSlots = 128 }; // a power of two, well over twice the number of actions
+
+      struct Slot {
+        const char *name;
+        ActionEnum  action;
+      };
+
+      /** @brief FNV-1a */
+      static unsigned hash(const char *name)
+      {
+        unsigned h = 2166136261u;
+        for(; *name; ++name)
+          h = (h ^ (unsigned char) *name) * 16777619u;
+        return h & (kNSlots - 1);
+      }
+
+      Slot _slots[kNSlots];
+    };
+
+    static const ActionTable gActionTable;
+
+    /** @brief map an action name to an enum */
+    ActionEnum mapToActionEnum(const char *action)
+    {
+      return gActionTable.find(action);
+    }
+
+#ifdef OFXS_TRACE
+    /** @brief our own copy of an action's name, the trace only keeps the pointer, so it can't be the host's */
+    static const char *mapActionEnumToName(ActionEnum action)
+    {
+      for(size_t i = 0; i < sizeof(gActionNames) / sizeof(gActionNames[0]); ++i)
+        if(gActionNames[i].action == action)
+          return gActionNames[i].name;
+      return "unknown action";
+    }
+#endif
+
     /** @brief Checks the handles passed into the plugin's main entry point */
     static
     void
-      checkMainHandles(const std::string &action,  const void *handle, 
+      checkMainHandles(ActionEnum actionEnum, const char *action,  const void *handle, 
       OfxPropertySetHandle inArgsHandle,  OfxPropertySetHandle outArgsHandle,
       bool handleCanBeNull, bool inArgsCanBeNull, bool outArgsCanBeNull)
     {
       if(handleCanBeNull)
-        OFX::Log::warning(handle != 0, "Handle passed to '%s' is not null.", action.c_str());
+        OFX::Log::warning(handle != 0, "Handle passed to '%s' is not null.", action);
       else
-        OFX::Log::error(handle == 0, "'Handle passed to '%s' is null.", action.c_str());
+        OFX::Log::error(handle == 0, "'Handle passed to '%s' is null.", action);
 
       if(inArgsCanBeNull)
-        OFX::Log::warning(inArgsHandle != 0, "'inArgs' Handle passed to '%s' is not null.", action.c_str());
+        OFX::Log::warning(inArgsHandle != 0, "'inArgs' Handle passed to '%s' is not null.", action);
       else
-        OFX::Log::error(inArgsHandle == 0, "'inArgs' handle passed to '%s' is null.", action.c_str());
+        OFX::Log::error(inArgsHandle == 0, "'inArgs' handle passed to '%s' is null.", action);
 
       if(outArgsCanBeNull)
-        OFX::Log::warning(outArgsHandle != 0, "'outArgs' Handle passed to '%s' is not null.", action.c_str());
+        OFX::Log::warning(outArgsHandle != 0, "'outArgs' Handle passed to '%s' is not null.", action);
       else
-        OFX::Log::error(outArgsHandle == 0, "'outArgs' handle passed to '%s' is null.", action.c_str());
+        OFX::Log::error(outArgsHandle == 0, "'outArgs' handle passed to '%s' is null.", action);
 
       // validate the property sets on the arguments
-      OFX::Validation::validateActionArgumentsProperties(action, inArgsHandle, outArgsHandle);
+      OFX::Validation::validateActionArgumentsProperties(actionEnum, inArgsHandle, outArgsHandle);
 
       // throw exceptions if null when not meant to be null
       if(!handleCanBeNull && !handle)         throwSuiteStatusException(kOfxStatErrBadHandle);
@@ -4478,11 +4874,7 @@ namespace OFX {
 #endif
 
       // make a roi setter object
-      OFX::Private::VersionIDKey key;
-      key.id = plugname;
-      key.majorVersion = majorVersion;
-      key.minorVersion = minorVersion;
-      ActualROISetter setRoIs(outArgs, gEffectDescriptors[key][effectInstance->getContext()]->getClipROIPropNames());
+      ActualROISetter setRoIs(outArgs, getEffectDescriptor(plugname, majorVersion, minorVersion, effectInstance->getContext())->getClipROIPropNames());
 
       // and call the plugin client code
       effectInstance->getRegionsOfInterest(args, setRoIs);
@@ -4564,11 +4956,7 @@ namespace OFX {
       args.time = inArgs.propGetDouble(kOfxPropTime);
 
       // make a roi setter object
-      OFX::Private::VersionIDKey key;
-      key.id = plugname;
-      key.majorVersion = majorVersion;
-      key.minorVersion = minorVersion;
-      ActualSetter setFrames(outArgs, gEffectDescriptors[key][effectInstance->getContext()]->getClipFrameRangePropNames());
+      ActualSetter setFrames(outArgs, getEffectDescriptor(plugname, majorVersion, minorVersion, effectInstance->getContext())->getClipFrameRangePropNames());
 
       // and call the plugin client code
       effectInstance->getFramesNeeded(args, setFrames);
@@ -4659,11 +5047,7 @@ namespace OFX {
       ImageEffect *effectInstance = retrieveImageEffectPointer(handle);
 
       // set up our clip preferences setter
-      OFX::Private::VersionIDKey key;
-      key.id = plugname;
-      key.majorVersion = majorVersion;
-      key.minorVersion = minorVersion;
-      ImageEffectDescriptor* desc = gEffectDescriptors[key][effectInstance->getContext()];
+      ImageEffectDescriptor* desc = getEffectDescriptor(plugname, majorVersion, minorVersion, effectInstance->getContext());
       ClipPreferencesSetter prefs(outArgs, desc->getClipDepthPropNames(), desc->getClipComponentPropNames(), desc->getClipPARPropNames());
 
       // and call the plug-in client code
@@ -4710,6 +5094,9 @@ namespace OFX {
       std::string changedName = inArgs.propGetString(kOfxPropName);
 
       if(changedType == kOfxTypeParameter) {
+        // anything cached from the param is out of date
+        effectInstance->notifyParamChanged(changedName);
+
         // and call the plugin client code
         effectInstance->changedParam(args, changedName);
       }
@@ -4792,11 +5179,7 @@ namespace OFX {
         args.view = inArgs.propGetInt(kFnOfxImageEffectPropView, 0, false);
         
         
-        OFX::Private::VersionIDKey key;
-        key.id = plugname;
-        key.majorVersion = majorVersion;
-        key.minorVersion = minorVersion;
-        ImageEffectDescriptor* desc = gEffectDescriptors[key][effectInstance->getContext()];
+        ImageEffectDescriptor* desc = getEffectDescriptor(plugname, majorVersion, minorVersion, effectInstance->getContext());
         FrameViewsNeededSetter setter(outArgs,desc->getClipFrameViewsPropNames());
         effectInstance->getFrameViewsNeeded(args,setter);
         if (setter.setOutProperties()) {
@@ -4814,11 +5197,7 @@ namespace OFX {
         args.time = inArgs.propGetDouble(kOfxPropTime);
         args.view = inArgs.propGetInt(kFnOfxImageEffectPropView, 0, false);
         
-        OFX::Private::VersionIDKey key;
-        key.id = plugname;
-        key.majorVersion = majorVersion;
-        key.minorVersion = minorVersion;
-        ImageEffectDescriptor* desc = gEffectDescriptors[key][effectInstance->getContext()];
+        ImageEffectDescriptor* desc = getEffectDescriptor(plugname, majorVersion, minorVersion, effectInstance->getContext());
         ClipComponentsSetter setter(outArgs,desc->getClipPlanesPropNames());
         OfxStatus stat = effectInstance->getClipComponents(args,setter);
         if (!setter.setOutProperties()) {
@@ -4981,6 +5360,11 @@ namespace OFX {
       OFX::Log::print("********************************************************************************");
       OFX::Log::print("START mainEntry (%s)", actionRaw);
       OFX::Log::indent();
+#ifdef OFXS_TRACE
+      const ActionEnum tracedActionEnum = mapToActionEnum(actionRaw);
+      const char *tracedAction = mapActionEnumToName(tracedActionEnum);
+#endif
+      OFXS_TRACE_ACTION_BEGIN(tracedAction);
       OfxStatus stat = kOfxStatReplyDefault;
       try {
 
@@ -4997,11 +5381,11 @@ namespace OFX {
         OFX::PropertySet inArgs(inArgsRaw);
         OFX::PropertySet outArgs(outArgsRaw);
 
-        // turn the action into a std::string
-        std::string action(actionRaw);
+        // map the action to an enum, this neither allocates nor walks a chain of string compares
+        ActionEnum action = mapToActionEnum(actionRaw);
 
         // figure the actions
-        if (action == kOfxActionLoad) {
+        if (action == eActionLoad) {
           // call the support load function, param-less
           OFX::Private::loadAction(); 
 
@@ -5013,8 +5397,8 @@ namespace OFX {
         }
 
         // figure the actions
-        else if (action == kOfxActionUnload) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, true, true, true);
+        else if (action == eActionUnload) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, true, true, true);
 
           // call the plugin side unload action, param-less, should be called, eve if the stat above failed!
           factory->unload();
@@ -5026,8 +5410,8 @@ namespace OFX {
           stat = kOfxStatOK;
         }
 
-        else if(action == kOfxActionDescribe) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionDescribe) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // make the plugin descriptor
           ImageEffectDescriptor *desc = new ImageEffectDescriptor(handle);
@@ -5057,8 +5441,8 @@ namespace OFX {
           // got here, must be good
           stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionDescribeInContext) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionDescribeInContext) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // make the plugin descriptor and pass it to the plugin to do something with it
           ImageEffectDescriptor *desc = new ImageEffectDescriptor(handle);
@@ -5091,8 +5475,8 @@ namespace OFX {
           // got here, must be good
           stat = kOfxStatOK;
         }
-        else if(action == kOfxActionCreateInstance) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionCreateInstance) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // fetch the effect props to figure the context
           PropertySet effectProps = fetchEffectProps(handle);
@@ -5111,8 +5495,8 @@ namespace OFX {
           // got here, must be good
           stat = kOfxStatOK;
         }
-        else if(action == kOfxActionDestroyInstance) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionDestroyInstance) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // fetch our pointer out of the props on the handle
           ImageEffect *instance = retrieveImageEffectPointer(handle);
@@ -5123,8 +5507,8 @@ namespace OFX {
           // got here, must be good
           stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionRender) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionRender) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the render action skin
           renderAction(handle, inArgs);
@@ -5132,55 +5516,55 @@ namespace OFX {
           // got here, must be good
           stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionBeginSequenceRender) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionBeginSequenceRender) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the begin render action skin
           beginSequenceRenderAction(handle, inArgs);
         }
-        else if(action == kOfxImageEffectActionEndSequenceRender) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionEndSequenceRender) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the begin render action skin
           endSequenceRenderAction(handle, inArgs);
         }
-        else if(action == kOfxImageEffectActionIsIdentity) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionIsIdentity) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the identity action, if it is, return OK
           if(isIdentityAction(handle, inArgs, outArgs))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionGetRegionOfDefinition) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetRegionOfDefinition) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the rod action, return OK if it does something
           if(regionOfDefinitionAction(handle, inArgs, outArgs))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionGetRegionsOfInterest) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetRegionsOfInterest) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the RoI action, return OK if it does something
           if(regionsOfInterestAction(handle, inArgs, outArgs, plugname, it->second._plug->pluginVersionMajor, it->second._plug->pluginVersionMinor))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionGetFramesNeeded) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetFramesNeeded) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the frames needed action, return OK if it does something
           if(framesNeededAction(handle, inArgs, outArgs, plugname, it->second._plug->pluginVersionMajor, it->second._plug->pluginVersionMinor))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionGetClipPreferences) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, false);
+        else if(action == eActionGetClipPreferences) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, false);
 
           // call the frames needed action, return OK if it does something
           if(clipPreferencesAction(handle, outArgs, plugname, it->second._plug->pluginVersionMajor, it->second._plug->pluginVersionMinor))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxActionPurgeCaches) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionPurgeCaches) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // fetch our pointer out of the props on the handle
           ImageEffect *instance = retrieveImageEffectPointer(handle);
@@ -5188,8 +5572,8 @@ namespace OFX {
           // purge 'em
           instance->purgeCaches();
         }
-        else if(action == kOfxActionSyncPrivateData) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionSyncPrivateData) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // fetch our pointer out of the props on the handle
           ImageEffect *instance = retrieveImageEffectPointer(handle);
@@ -5197,33 +5581,33 @@ namespace OFX {
           // and sync it
           instance->syncPrivateData();
         }
-        else if(action == kOfxImageEffectActionGetTimeDomain) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, false);
+        else if(action == eActionGetTimeDomain) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, false);
 
           // call the get time domain action
           if(getTimeDomainAction(handle, outArgs))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxActionBeginInstanceChanged) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionBeginInstanceChanged) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the begin instance changed action
           beginInstanceChangedAction(handle, inArgs);
         }
-        else if(action == kOfxActionInstanceChanged) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionInstanceChanged) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the instance changed action
           instanceChangedAction(handle, inArgs);
         }
-        else if(action == kOfxActionEndInstanceChanged) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionEndInstanceChanged) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the end instance changed action
           endInstanceChangedAction(handle, inArgs);
         }
-        else if(action == kOfxActionBeginInstanceEdit) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionBeginInstanceEdit) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // fetch our pointer out of the props on the handle
           ImageEffect *instance = retrieveImageEffectPointer(handle);
@@ -5231,8 +5615,8 @@ namespace OFX {
           // call the begin edit function
           instance->beginEdit();
         }
-        else if(action == kOfxActionEndInstanceEdit) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionEndInstanceEdit) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // fetch our pointer out of the props on the handle
           ImageEffect *instance = retrieveImageEffectPointer(handle);
@@ -5241,22 +5625,22 @@ namespace OFX {
           instance->endEdit();
         }
 #ifdef OFX_SUPPORTS_OPENGLRENDER
-        else if(action == kOfxActionOpenGLContextAttached) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionOpenGLContextAttached) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // call the context attached action
           contextAttachedAction(handle, outArgs);
         }
-        else if(action == kOfxActionOpenGLContextDetached) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionOpenGLContextDetached) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // call the context detached action
           contextDetachedAction(handle, inArgs);
         }
 #endif
 #ifdef OFX_SUPPORTS_DIALOG
-        else if(action == kOfxActionDialog) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionDialog) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // fetch our pointer out of the props on the handle
           ImageEffect *instance = retrieveImageEffectPointer(handle);
@@ -5272,21 +5656,21 @@ namespace OFX {
         }
 #endif
 #ifdef OFX_EXTENSIONS_VEGAS
-        else if(action == kOfxImageEffectActionVegasKeyframeUplift) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
+        else if(action == eActionVegasKeyframeUplift) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, true);
 
           // call the uplift vegas keyframes function
           upliftVegasKeyframeAction(handle, inArgs);
         }
-        else if(action == kOfxImageEffectActionInvokeHelp) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionInvokeHelp) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // call the invoke help function
           if(invokeHelp(handle, plugname))
             stat = kOfxStatOK;
         }
-        else if(action == kOfxImageEffectActionInvokeAbout) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
+        else if(action == eActionInvokeAbout) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, true, true);
 
           // call the invoke help function
           if(invokeAbout(handle, plugname))
@@ -5294,24 +5678,24 @@ namespace OFX {
         }
 #endif
 #ifdef OFX_EXTENSIONS_NUKE
-        else if(action == kFnOfxImageEffectActionGetClipComponents) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetClipComponents) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the clip components function, return OK if it does something
           // the spec is not clear as to whether it is allowed to do nothing but
           // this action should always be implemented for multi-planes effects.
           stat = getClipComponentsAction(handle, inArgs, outArgs, plugname, it->second._plug->pluginVersionMajor, it->second._plug->pluginVersionMinor);
         }
-        else if(action == kFnOfxImageEffectActionGetFrameViewsNeeded) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetFrameViewsNeeded) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the frames views needed action, return OK if it does something
           if (getFrameViewsNeededAction(handle, inArgs, outArgs, plugname, it->second._plug->pluginVersionMajor, it->second._plug->pluginVersionMinor)) {
               stat = kOfxStatOK;
           }
         }
-        else if(action == kFnOfxImageEffectActionGetTransform) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetTransform) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the get transform function
           if(getTransform(handle, inArgs, outArgs))
@@ -5319,8 +5703,8 @@ namespace OFX {
         }
 #endif
 #ifdef OFX_EXTENSIONS_NATRON
-        else if(action == kOfxImageEffectActionGetInverseDistortion) {
-          checkMainHandles(actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
+        else if(action == eActionGetInverseDistortion) {
+          checkMainHandles(action, actionRaw, handleRaw, inArgsRaw, outArgsRaw, false, false, false);
 
           // call the get transform function
           if(getInverseDistortion(handle, inArgs, outArgs))
@@ -5395,6 +5779,13 @@ namespace OFX {
         stat = kOfxStatFailed;
       }
 
+      OFXS_TRACE_ACTION_END(tracedAction);
+#ifdef OFXS_TRACE
+      // the trace is also written when the binary goes, but not every host sends unload first
+      if(tracedActionEnum == eActionUnload)
+        OFX::Trace::dump();
+#endif
+
       OFX::Log::outdent();
       OFX::Log::print("STOP mainEntry (%s)\n", actionRaw);
       return stat;
@@ -37,6 +37,11 @@ England
 /** @brief This file contains code that skins the ofx param suite */
 
 #include <cstring>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFXS_USE_SSE2
+#endif
 #ifdef DEBUG
 #include <iostream>
 #endif
@@ -1376,6 +1381,7 @@ namespace OFX {
   void ParametricParamDescriptor::setParamSet(ParamSetDescriptor& paramSet)
   {
     _paramSet = &paramSet;
+    OFXS_TRACE_SUITE_CALL("paramGetHandle");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetHandle(_paramSet->getParamSetHandle(), getName().c_str(), &_ofxParamHandle, 0);
     throwSuiteStatusException(stat);
   }
@@ -1434,6 +1440,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("parametricParamAddControlPoint");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamAddControlPoint(_ofxParamHandle, id, time, x, y, addKey);
     throwSuiteStatusException(stat);
   }
@@ -1485,6 +1492,7 @@ namespace OFX {
     if(h) {
       // fetch me props
       OfxPropertySetHandle props;
+      OFXS_TRACE_SUITE_CALL("paramSetGetPropertySet");
       OfxStatus stat = OFX::Private::gParamSuite->paramSetGetPropertySet(h, &props);
       _paramSetProps.propSetHandle(props);
       throwSuiteStatusException(stat);
@@ -1519,6 +1527,7 @@ namespace OFX {
   /** @brief calls the raw OFX routine to define a param */
   void ParamSetDescriptor::defineRawParam(const std::string &name, ParamTypeEnum paramType, OfxPropertySetHandle &props)
   {
+    OFXS_TRACE_SUITE_CALL("paramDefine");
     OfxStatus stat = OFX::Private::gParamSuite->paramDefine(_paramSetHandle, mapParamTypeEnumToString(paramType), name.c_str(), &props);
     throwSuiteStatusException(stat);
   }
@@ -1817,7 +1826,11 @@ namespace OFX {
   {
     // fetch our property handle
     OfxPropertySetHandle propHandle;
-    OfxStatus stat = OFX::Private::gParamSuite->paramGetPropertySet(handle, &propHandle);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("paramGetPropertySet");
+      stat = OFX::Private::gParamSuite->paramGetPropertySet(handle, &propHandle);
+    }
     throwSuiteStatusException(stat);
     _paramProps.propSetHandle(propHandle);
 
@@ -2026,6 +2039,7 @@ namespace OFX {
   {
     if(!OFX::Private::gParamSuite->paramGetNumKeys) throwHostMissingSuiteException("paramGetNumKeys");
     unsigned int v = 0;
+    OFXS_TRACE_SUITE_CALL("paramGetNumKeys");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetNumKeys(_paramHandle, &v);
     throwSuiteStatusException(stat);
     return v;
@@ -2037,6 +2051,7 @@ namespace OFX {
   {
     if(!OFX::Private::gParamSuite->paramGetKeyTime) throwHostMissingSuiteException("paramGetKeyTime");
     double v = 0;
+    OFXS_TRACE_SUITE_CALL("paramGetKeyTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetKeyTime(_paramHandle, nthKey, &v);
 
     // oops?
@@ -2062,6 +2077,7 @@ namespace OFX {
     int dir = searchDir == eKeySearchBackwards ? -1 : (searchDir == eKeySearchNear ? 0 : 1);
 
     // call raw param function
+    OFXS_TRACE_SUITE_CALL("paramGetKeyIndex");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetKeyIndex(_paramHandle, time, dir, &v);
 
     // oops?
@@ -2080,6 +2096,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramDeleteKey) throwHostMissingSuiteException("paramDeleteKey");
+    OFXS_TRACE_SUITE_CALL("paramDeleteKey");
     OfxStatus stat = OFX::Private::gParamSuite->paramDeleteKey(_paramHandle, time);
     if(stat == kOfxStatFailed) return; // if no key at time, fail quietly
     throwSuiteStatusException(stat); 
@@ -2090,6 +2107,7 @@ namespace OFX {
     ValueParam::deleteAllKeys(void)
   { 
     if(!OFX::Private::gParamSuite->paramDeleteAllKeys) throwHostMissingSuiteException("paramDeleteAllKeys");
+    OFXS_TRACE_SUITE_CALL("paramDeleteAllKeys");
     OfxStatus stat = OFX::Private::gParamSuite->paramDeleteAllKeys(_paramHandle);
     throwSuiteStatusException(stat); 
   }
@@ -2098,6 +2116,7 @@ namespace OFX {
   void ValueParam::copyFrom(const ValueParam& from, OfxTime dstOffset, const OfxRangeD *frameRange)
   {
     if(!OFX::Private::gParamSuite->paramCopy) throwHostMissingSuiteException("paramCopy");
+    OFXS_TRACE_SUITE_CALL("paramCopy");
     OfxStatus stat = OFX::Private::gParamSuite->paramCopy(_paramHandle, from._paramHandle, dstOffset, frameRange);
     throwSuiteStatusException(stat);
   }
@@ -2113,6 +2132,7 @@ namespace OFX {
 #  endif
     if(!OFX::Private::gVegasKeyframeSuite) throwHostMissingSuiteException("vegasKeyframeSuite");
     char *cStr;
+    OFXS_TRACE_SUITE_CALL("paramGetKeyInterpolation");
     OfxStatus stat = OFX::Private::gVegasKeyframeSuite->paramGetKeyInterpolation(_paramHandle, time, &cStr);
     throwSuiteStatusException(stat); 
     return mapToInterpolationEnum(cStr);
@@ -2127,6 +2147,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gVegasKeyframeSuite) throwHostMissingSuiteException("vegasKeyframeSuite");
+    OFXS_TRACE_SUITE_CALL("paramSetKeyInterpolation");
     OfxStatus stat = OFX::Private::gVegasKeyframeSuite->paramSetKeyInterpolation(_paramHandle, time, mapToInterpolationTypeEnum(interpolation));
     throwSuiteStatusException(stat); 
   }
@@ -2184,6 +2205,7 @@ namespace OFX {
   /** @brief get value */
   void IntParam::getValue(int &v) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &v);
     throwSuiteStatusException(stat);
   }
@@ -2196,6 +2218,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &v);
     throwSuiteStatusException(stat);
   }
@@ -2203,6 +2226,7 @@ namespace OFX {
   /** @brief set value */
   void IntParam::setValue(int v)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, v);
     throwSuiteStatusException(stat);
   }
@@ -2216,6 +2240,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, v);
     throwSuiteStatusException(stat);
   }
@@ -2300,6 +2325,7 @@ namespace OFX {
   /** @brief get value */
   void Int2DParam::getValue(int &x, int &y) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &x, &y);
     throwSuiteStatusException(stat);
   }
@@ -2312,6 +2338,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &x, &y);
     throwSuiteStatusException(stat);
   }
@@ -2319,6 +2346,7 @@ namespace OFX {
   /** @brief set value */
   void Int2DParam::setValue(int x, int y)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, x, y);
     throwSuiteStatusException(stat);
   }
@@ -2332,6 +2360,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, x, y);
     throwSuiteStatusException(stat);
   }
@@ -2422,6 +2451,7 @@ namespace OFX {
   /** @brief get value */
   void Int3DParam::getValue(int &x, int &y, int &z) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &x, &y, &z);
     throwSuiteStatusException(stat);
   }
@@ -2434,6 +2464,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &x, &y, &z);
     throwSuiteStatusException(stat);
   }
@@ -2441,6 +2472,7 @@ namespace OFX {
   /** @brief set value */
   void Int3DParam::setValue(int x, int y, int z)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, x, y, z);
     throwSuiteStatusException(stat);
   }
@@ -2454,6 +2486,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, x, y, z);
     throwSuiteStatusException(stat);
   }
@@ -2608,6 +2641,7 @@ namespace OFX {
   /** @brief get value */
   void DoubleParam::getValue(double &v) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &v);
     throwSuiteStatusException(stat);
   }
@@ -2620,6 +2654,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &v);
     throwSuiteStatusException(stat);
   }
@@ -2632,6 +2667,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, v);
     throwSuiteStatusException(stat);
   }
@@ -2645,6 +2681,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, v);
     throwSuiteStatusException(stat);
   }
@@ -2658,6 +2695,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramGetDerivative) throwHostMissingSuiteException("paramGetDerivative");
+    OFXS_TRACE_SUITE_CALL("paramGetDerivative");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetDerivative(_paramHandle, t, &v);
     throwSuiteStatusException(stat);
   }
@@ -2671,6 +2709,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramGetIntegral) throwHostMissingSuiteException("paramGetIntegral");
+    OFXS_TRACE_SUITE_CALL("paramGetIntegral");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetIntegral(_paramHandle, t1, t2, &v);
     throwSuiteStatusException(stat);
   }
@@ -2755,6 +2794,7 @@ namespace OFX {
   /** @brief get value */
   void Double2DParam::getValue(double &x, double &y) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &x, &y);
     throwSuiteStatusException(stat);
   }
@@ -2767,6 +2807,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &x, &y);
     throwSuiteStatusException(stat);
   }
@@ -2779,6 +2820,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, x, y);
     throwSuiteStatusException(stat);
   }
@@ -2792,6 +2834,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, x, y);
     throwSuiteStatusException(stat);
   }
@@ -2805,6 +2848,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramGetDerivative) throwHostMissingSuiteException("paramGetDerivative");
+    OFXS_TRACE_SUITE_CALL("paramGetDerivative");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetDerivative(_paramHandle, t, &x, &y);
     throwSuiteStatusException(stat);
   }
@@ -2818,6 +2862,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramGetIntegral) throwHostMissingSuiteException("paramGetIntegral");
+    OFXS_TRACE_SUITE_CALL("paramGetIntegral");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetIntegral(_paramHandle, t1, t2, &x, &y);
     throwSuiteStatusException(stat);
   }
@@ -2907,6 +2952,7 @@ namespace OFX {
   /** @brief get value */
   void Double3DParam::getValue(double &x, double &y, double &z) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &x, &y, &z);
     throwSuiteStatusException(stat);
   }
@@ -2919,6 +2965,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &x, &y, &z);
     throwSuiteStatusException(stat);
   }
@@ -2931,6 +2978,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, x, y, z);
     throwSuiteStatusException(stat);
   }
@@ -2944,6 +2992,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, x, y, z);
     throwSuiteStatusException(stat);
   }
@@ -2957,6 +3006,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramGetDerivative) throwHostMissingSuiteException("paramGetDerivative");
+    OFXS_TRACE_SUITE_CALL("paramGetDerivative");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetDerivative(_paramHandle, t, &x, &y, &z);
     throwSuiteStatusException(stat);
   }
@@ -2970,6 +3020,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramGetIntegral) throwHostMissingSuiteException("paramGetIntegral");
+    OFXS_TRACE_SUITE_CALL("paramGetIntegral");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetIntegral(_paramHandle, t1, t2, &x, &y, &z);
     throwSuiteStatusException(stat);
   }
@@ -3010,6 +3061,7 @@ namespace OFX {
   /** @brief get value */
   void RGBParam::getValue(double &r, double &g, double &b) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &r, &g, &b);
     throwSuiteStatusException(stat);
   }
@@ -3022,6 +3074,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &r, &g, &b);
     throwSuiteStatusException(stat);
   }
@@ -3034,6 +3087,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, r, g, b);
     throwSuiteStatusException(stat);
   }
@@ -3047,6 +3101,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, r, g, b);
     throwSuiteStatusException(stat);
   }
@@ -3088,6 +3143,7 @@ namespace OFX {
   /** @brief get value */
   void RGBAParam::getValue(double &r, double &g, double &b, double &a) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &r, &g, &b, &a);
     throwSuiteStatusException(stat);
   }
@@ -3100,6 +3156,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &r, &g, &b, &a);
     throwSuiteStatusException(stat);
   }
@@ -3112,6 +3169,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, r, g, b, a);
     throwSuiteStatusException(stat);
   }
@@ -3125,6 +3183,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, r, g, b, a);
     throwSuiteStatusException(stat);
   }
@@ -3163,6 +3222,7 @@ namespace OFX {
   void StringParam::getValue(std::string &v) const
   {
     char *cStr;
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &cStr);
     throwSuiteStatusException(stat);
 # ifdef DEBUG
@@ -3182,6 +3242,7 @@ namespace OFX {
     }
 #  endif
     char *cStr;
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &cStr);
     throwSuiteStatusException(stat);
 # ifdef DEBUG
@@ -3195,6 +3256,7 @@ namespace OFX {
   /** @brief set value */
   void StringParam::setValue(const std::string &v)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, v.c_str());
     throwSuiteStatusException(stat);
 # ifdef DEBUG
@@ -3213,6 +3275,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, v.c_str());
     throwSuiteStatusException(stat);
 # ifdef DEBUG
@@ -3256,6 +3319,7 @@ namespace OFX {
   void BooleanParam::getValue(bool &v) const
   {
     int iVal;
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &iVal);
     throwSuiteStatusException(stat);
     v = iVal != 0;
@@ -3270,6 +3334,7 @@ namespace OFX {
     }
 #  endif
     int iVal;
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &iVal);
     throwSuiteStatusException(stat);
     v = iVal != 0;
@@ -3279,6 +3344,7 @@ namespace OFX {
   void BooleanParam::setValue(bool v)
   {
     int iVal = v;
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, iVal);
     throwSuiteStatusException(stat);
   }
@@ -3293,6 +3359,7 @@ namespace OFX {
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
     int iVal = v;
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, iVal);
     throwSuiteStatusException(stat);
   }
@@ -3330,6 +3397,7 @@ namespace OFX {
   /** @brief get value */
   void ChoiceParam::getValue(int &v) const
   {
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &v);
     throwSuiteStatusException(stat);
   }
@@ -3342,6 +3410,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &v);
     throwSuiteStatusException(stat);
   }
@@ -3349,6 +3418,7 @@ namespace OFX {
   /** @brief set value */
   void ChoiceParam::setValue(int v)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, v);
     throwSuiteStatusException(stat);
   }
@@ -3357,6 +3427,7 @@ namespace OFX {
   void ChoiceParam::setValueAtTime(double t, int v)
   {
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, v);
     throwSuiteStatusException(stat);
   }
@@ -3619,6 +3690,7 @@ namespace OFX {
   void CustomParam::getValue(std::string &v) const
   {
     char *cStr;
+    OFXS_TRACE_SUITE_CALL("paramGetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValue(_paramHandle, &cStr);
     throwSuiteStatusException(stat);
     v = cStr;
@@ -3633,6 +3705,7 @@ namespace OFX {
     }
 #  endif
     char *cStr;
+    OFXS_TRACE_SUITE_CALL("paramGetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetValueAtTime(_paramHandle, t, &cStr);
     throwSuiteStatusException(stat);
     v = cStr;
@@ -3641,6 +3714,7 @@ namespace OFX {
   /** @brief set value */
   void CustomParam::setValue(const std::string &v)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, v.c_str());
     throwSuiteStatusException(stat);
   }
@@ -3648,6 +3722,7 @@ namespace OFX {
   /** @brief set value */
   void CustomParam::setValue(const char* str)
   {
+    OFXS_TRACE_SUITE_CALL("paramSetValue");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValue(_paramHandle, str);
     throwSuiteStatusException(stat);
   }
@@ -3661,6 +3736,7 @@ namespace OFX {
     }
 #  endif
     if(!OFX::Private::gParamSuite->paramSetValueAtTime) throwHostMissingSuiteException("paramSetValueAtTime");
+    OFXS_TRACE_SUITE_CALL("paramSetValueAtTime");
     OfxStatus stat = OFX::Private::gParamSuite->paramSetValueAtTime(_paramHandle, t, v.c_str());
     throwSuiteStatusException(stat);
   }
@@ -3719,9 +3795,10 @@ namespace OFX {
   /** @brief hidden constructor */
   ParametricParam::ParametricParam(const ParamSet* paramSet, const std::string &name, OfxParamHandle handle)
       : Param(paramSet, name, eParametricParam, handle)
+      , _changeCount(0)
   {}
 
-  void ParametricParam::getRange(double &min, double &max)
+  void ParametricParam::getRange(double &min, double &max) const
   {
     double r[2] = {0., 0.};
     _paramProps.propGetDoubleN(kOfxParamPropParametricRange, r, 2);
@@ -3729,6 +3806,12 @@ namespace OFX {
     max = r[1];
   }
 
+  /** @brief get the number of curves */
+  int ParametricParam::getNCurves(void) const
+  {
+    return _paramProps.propGetInt(kOfxParamPropParametricDimension);
+  }
+
   /** @brief set the hard min/max range, default is -DBL_MAX, DBL_MAX */
   void ParametricParam::setDimensionRange(int curveIndex, double min, double max)
   {
@@ -3777,6 +3860,7 @@ namespace OFX {
     }
 #  endif
     double returnValue = 0.0;
+    OFXS_TRACE_SUITE_CALL("parametricParamGetValue");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamGetValue(_paramHandle,
                                                                                        curveIndex,
                                                                                        time,
@@ -3802,6 +3886,7 @@ namespace OFX {
     }
 #  endif
     int returnValue = 0;
+    OFXS_TRACE_SUITE_CALL("parametricParamGetNControlPoints");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamGetNControlPoints(_paramHandle,
                                                                                                 curveIndex,
                                                                                                 time,
@@ -3828,6 +3913,7 @@ namespace OFX {
     }
 #  endif
     std::pair<double, double> returnValue;
+    OFXS_TRACE_SUITE_CALL("parametricParamGetNthControlPoint");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamGetNthControlPoint(_paramHandle,
                                                                                                  curveIndex,
                                                                                                  time,
@@ -3871,6 +3957,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("parametricParamSetNthControlPoint");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamSetNthControlPoint(_paramHandle,
                                                                                                  curveIndex,
                                                                                                  time,
@@ -3925,6 +4012,7 @@ namespace OFX {
       throwSuiteStatusException(kOfxStatErrValue);
     }
 #  endif
+    OFXS_TRACE_SUITE_CALL("parametricParamAddControlPoint");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamAddControlPoint(_paramHandle, curveIndex, time, key, value, addAnimationKey);
     throwSuiteStatusException(stat);
   }
@@ -3937,6 +4025,7 @@ namespace OFX {
   void ParametricParam::deleteControlPoint(const int curveIndex,
                                             const int nthCtl)
   {
+    OFXS_TRACE_SUITE_CALL("parametricParamDeleteControlPoint");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamDeleteControlPoint(_paramHandle, curveIndex, nthCtl);
     throwSuiteStatusException(stat);
   }
@@ -3947,15 +4036,275 @@ namespace OFX {
   */
   void ParametricParam::deleteControlPoint(const int curveIndex)
   {
+    OFXS_TRACE_SUITE_CALL("parametricParamDeleteAllControlPoints");
     OfxStatus stat = OFX::Private::gParametricParameterSuite->parametricParamDeleteAllControlPoints(_paramHandle, curveIndex);
     throwSuiteStatusException(stat);
   }
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // curves of a parametric param baked into tables
+
+  /** @brief make an empty table with the given number of intervals per curve */
+  ParametricParamLUT::ParametricParamLUT(int resolution)
+    : _resolution(std::max(resolution, 1))
+    , _nCurves(0)
+    , _min(0.f)
+    , _scale(0.f)
+    , _param(NULL)
+    , _time(0.)
+    , _changeCount(0)
+  {
+  }
+
+  /** @brief sample the curves of the param at the given time, if not done already */
+  void ParametricParamLUT::bake(const ParametricParam *param, double t)
+  {
+    if(param == _param && t == _time && param->getChangeCount() == _changeCount)
+      return;
+
+    // nothing is baked until we are done, should the host fail
+    _param = NULL;
+
+    double min, max;
+    param->getRange(min, max);
+    _nCurves = param->getNCurves();
+    _min = (float) min;
+    _scale = max > min ? (float) (_resolution / (max - min)) : 0.f;
+    _table.resize(_nCurves * (_resolution + 1));
+
+    for(int c = 0; c < _nCurves; ++c) {
+      float *samples = &_table[c * (_resolution + 1)];
+      for(int i = 0; i <= _resolution; ++i)
+        samples[i] = (float) param->getValue(c, t, min + (max - min) * i / _resolution);
+    }
+
+    _param = param;
+    _time = t;
+    _changeCount = param->getChangeCount();
+  }
+
+  /** @brief values of a curve at n parametric positions */
+  void ParametricParamLUT::getValues(int curveIndex, const float *positions, float *values, int n) const
+  {
+    assert(isBaked(curveIndex));
+    if(!isBaked(curveIndex)) {
+      std::copy(positions, positions + n, values);
+      return;
+    }
+
+    int k = 0;
+#ifdef OFXS_USE_SSE2
+    const float *table = &_table[curveIndex * (_resolution + 1)];
+    const __m128 min = _mm_set1_ps(_min);
+    const __m128 scale = _mm_set1_ps(_scale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 top = _mm_set1_ps((float) _resolution);
+    const __m128i last = _mm_set1_epi32(_resolution - 1);
+    for(; k + 4 <= n; k += 4) {
+      // position in the table, clamped to it, NaNs go to 0
+      __m128 x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(positions + k), min), scale);
+      x = _mm_min_ps(_mm_max_ps(x, zero), top);
+      __m128i i = _mm_cvttps_epi32(x);
+      __m128i past = _mm_cmpgt_epi32(i, last);
+      i = _mm_or_si128(_mm_and_si128(past, last), _mm_andnot_si128(past, i));
+      __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+
+      int index[4];
+      _mm_storeu_si128((__m128i *) index, i);
+      __m128 t0 = _mm_setr_ps(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+      __m128 t1 = _mm_setr_ps(table[index[0] + 1], table[index[1] + 1], table[index[2] + 1], table[index[3] + 1]);
+      _mm_storeu_ps(values + k, _mm_add_ps(t0, _mm_mul_ps(f, _mm_sub_ps(t1, t0))));
+    }
+#endif
+    for(; k < n; ++k)
+      values[k] = getValue(curveIndex, positions[k]);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // values of a set of params at one time
+
+  namespace {
+    /** @brief number of values a param has in a snapshot, 0 if it can't be in one */
+    int snapshotDimension(ParamTypeEnum type)
+    {
+      switch(type) {
+      case eIntParam :
+      case eDoubleParam :
+      case eBooleanParam :
+      case eChoiceParam :
+        return 1;
+      case eInt2DParam :
+      case eDouble2DParam :
+        return 2;
+      case eInt3DParam :
+      case eDouble3DParam :
+      case eRGBParam :
+        return 3;
+      case eRGBAParam :
+        return 4;
+      default :
+        return 0;
+      }
+    }
+  }
+
+  /** @brief make an empty snapshot */
+  ParamSnapshot::ParamSnapshot(void)
+    : _time(0)
+    , _fetched(false)
+    , _changeCount(0)
+  {
+  }
+
+  /** @brief add a param to the ones fetched */
+  void ParamSnapshot::addParam(const Param *param)
+  {
+    int dimension = snapshotDimension(param->getType());
+    if(dimension == 0)
+      throw OFX::Exception::TypeRequest(("Param " + param->getName() + " can not be in a snapshot").c_str());
+
+    Entry entry = {param, (int) _values.size()};
+    std::vector<Entry>::iterator i = std::lower_bound(_entries.begin(), _entries.end(), entry, EntryLess());
+    if(i != _entries.end() && i->param == param)
+      return;
+    _entries.insert(i, entry);
+    _values.resize(_values.size() + dimension, 0.);
+    _fetched = false;
+  }
+
+  /** @brief is the param in the snapshot */
+  bool ParamSnapshot::hasParam(const Param *param) const
+  {
+    Entry entry = {param, 0};
+    std::vector<Entry>::const_iterator i = std::lower_bound(_entries.begin(), _entries.end(), entry, EntryLess());
+    return i != _entries.end() && i->param == param;
+  }
+
+  /** @brief the values of a param, checking it is there */
+  const double *ParamSnapshot::findValues(const Param *param) const
+  {
+    Entry entry = {param, 0};
+    std::vector<Entry>::const_iterator i = std::lower_bound(_entries.begin(), _entries.end(), entry, EntryLess());
+    if(i == _entries.end() || i->param != param)
+      throw OFX::Exception::TypeRequest(("Param " + param->getName() + " is not in the snapshot").c_str());
+    return &_values[i->offset];
+  }
+
+  /** @brief fetch the values of all the params at the given time */
+  void ParamSnapshot::fetch(double t)
+  {
+    _time = t;
+    for(std::vector<Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+      double *v = &_values[i->offset];
+      switch(i->param->getType()) {
+      case eIntParam :
+        v[0] = static_cast<const IntParam *>(i->param)->getValueAtTime(t);
+        break;
+      case eInt2DParam : {
+        OfxPointI p = static_cast<const Int2DParam *>(i->param)->getValueAtTime(t);
+        v[0] = p.x; v[1] = p.y;
+        break;
+      }
+      case eInt3DParam : {
+        Ofx3DPointI p = static_cast<const Int3DParam *>(i->param)->getValueAtTime(t);
+        v[0] = p.x; v[1] = p.y; v[2] = p.z;
+        break;
+      }
+      case eDoubleParam :
+        static_cast<const DoubleParam *>(i->param)->getValueAtTime(t, v[0]);
+        break;
+      case eDouble2DParam :
+        static_cast<const Double2DParam *>(i->param)->getValueAtTime(t, v[0], v[1]);
+        break;
+      case eDouble3DParam :
+        static_cast<const Double3DParam *>(i->param)->getValueAtTime(t, v[0], v[1], v[2]);
+        break;
+      case eRGBParam :
+        static_cast<const RGBParam *>(i->param)->getValueAtTime(t, v[0], v[1], v[2]);
+        break;
+      case eRGBAParam :
+        static_cast<const RGBAParam *>(i->param)->getValueAtTime(t, v[0], v[1], v[2], v[3]);
+        break;
+      case eBooleanParam :
+        v[0] = static_cast<const BooleanParam *>(i->param)->getValueAtTime(t) ? 1. : 0.;
+        break;
+      case eChoiceParam :
+        v[0] = static_cast<const ChoiceParam *>(i->param)->getValueAtTime(t);
+        break;
+      default :
+        break;
+      }
+    }
+  }
+
+  int ParamSnapshot::getValue(const IntParam *param) const
+  {
+    return (int) findValues(param)[0];
+  }
+
+  OfxPointI ParamSnapshot::getValue(const Int2DParam *param) const
+  {
+    const double *v = findValues(param);
+    OfxPointI p = {(int) v[0], (int) v[1]};
+    return p;
+  }
+
+  Ofx3DPointI ParamSnapshot::getValue(const Int3DParam *param) const
+  {
+    const double *v = findValues(param);
+    Ofx3DPointI p = {(int) v[0], (int) v[1], (int) v[2]};
+    return p;
+  }
+
+  double ParamSnapshot::getValue(const DoubleParam *param) const
+  {
+    return findValues(param)[0];
+  }
+
+  OfxPointD ParamSnapshot::getValue(const Double2DParam *param) const
+  {
+    const double *v = findValues(param);
+    OfxPointD p = {v[0], v[1]};
+    return p;
+  }
+
+  Ofx3DPointD ParamSnapshot::getValue(const Double3DParam *param) const
+  {
+    const double *v = findValues(param);
+    Ofx3DPointD p = {v[0], v[1], v[2]};
+    return p;
+  }
+
+  OfxRGBColourD ParamSnapshot::getValue(const RGBParam *param) const
+  {
+    const double *v = findValues(param);
+    OfxRGBColourD c = {v[0], v[1], v[2]};
+    return c;
+  }
+
+  OfxRGBAColourD ParamSnapshot::getValue(const RGBAParam *param) const
+  {
+    const double *v = findValues(param);
+    OfxRGBAColourD c = {v[0], v[1], v[2], v[3]};
+    return c;
+  }
+
+  bool ParamSnapshot::getValue(const BooleanParam *param) const
+  {
+    return findValues(param)[0] != 0.;
+  }
+
+  int ParamSnapshot::getValue(const ChoiceParam *param) const
+  {
+    return (int) findValues(param)[0];
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   //  for a set of parameters
   /** @brief hidden ctor */
   ParamSet::ParamSet(void)
     : _paramSetHandle(NULL)
+    , _paramChangeCount(0)
   {
   }
 
@@ -3969,6 +4318,7 @@ namespace OFX {
     if(h) {
       // fetch me props
       OfxPropertySetHandle props;
+      OFXS_TRACE_SUITE_CALL("paramSetGetPropertySet");
       OfxStatus stat = OFX::Private::gParamSuite->paramSetGetPropertySet(h, &props);
       _paramSetProps.propSetHandle(props);
       throwSuiteStatusException(stat);
@@ -3996,7 +4346,11 @@ namespace OFX {
   {
     OfxPropertySetHandle propHandle;
 
-    OfxStatus stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("paramGetHandle");
+      stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
+    }
     throwSuiteStatusException(stat);
 
     PropertySet props(propHandle);
@@ -4013,7 +4367,11 @@ namespace OFX {
   {
     OfxPropertySetHandle propHandle;
     OfxParamHandle handle;
-    OfxStatus stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("paramGetHandle");
+      stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
+    }
     throwSuiteStatusException(stat);
     PropertySet props(propHandle);
     // make sure it is of our type
@@ -4025,6 +4383,7 @@ namespace OFX {
   {
     OfxParamHandle handle;
     OfxPropertySetHandle propHandle;
+    OFXS_TRACE_SUITE_CALL("paramGetHandle");
     OfxStatus stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
     if(stat!=kOfxStatOK)
       return false;
@@ -4035,7 +4394,11 @@ namespace OFX {
   {
     OfxParamHandle handle;
     OfxPropertySetHandle propHandle;
-    OfxStatus stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
+    OfxStatus stat;
+    {
+      OFXS_TRACE_SUITE_CALL("paramGetHandle");
+      stat = OFX::Private::gParamSuite->paramGetHandle(_paramSetHandle, name.c_str(), &handle, &propHandle);
+    }
     throwSuiteStatusException(stat);
 
     PropertySet props(propHandle);
@@ -4307,9 +4670,42 @@ namespace OFX {
     return param;
   }
 
+  /** @brief fetch the values of the params in the snapshot at the given time */
+  void ParamSet::fetchParamSnapshot(double t, ParamSnapshot &snapshot) const
+  {
+    if(snapshot.getNumParams() == 0) {
+      std::map<std::string, Param *>::const_iterator iter;
+      for(iter = _fetchedParams.begin(); iter != _fetchedParams.end(); ++iter) {
+        if(iter->second && snapshotDimension(iter->second->getType()) > 0)
+          snapshot.addParam(iter->second);
+      }
+    }
+
+    // params without keys may still vary with time through expressions or links, so only
+    // a fetch at the same time with no param changed since is still good
+    unsigned int changeCount = _paramChangeCount;
+    if(snapshot._fetched && snapshot._changeCount == changeCount && snapshot._time == t)
+      return;
+
+    OFXS_TRACE_SCOPE("ParamSet::fetchParamSnapshot");
+    snapshot.fetch(t);
+    snapshot._fetched = true;
+    snapshot._changeCount = changeCount;
+  }
+
+  /** @brief called by the library when the host says the named param changed */
+  void ParamSet::notifyParamChanged(const std::string &name)
+  {
+    ++_paramChangeCount;
+    Param *param = findPreviouslyFetchedParam(name);
+    if(param && param->getType() == eParametricParam)
+      ++static_cast<ParametricParam *>(param)->_changeCount;
+  }
+
   /// open an undoblock
   void ParamSet::beginEditBlock(const std::string &name)
   {
+    OFXS_TRACE_SUITE_CALL("paramEditBegin");
     OfxStatus stat = OFX::Private::gParamSuite->paramEditBegin(_paramSetHandle, name.c_str());
     throwSuiteStatusException(stat);
   }
@@ -4317,6 +4713,7 @@ namespace OFX {
   /// close an undoblock
   void ParamSet::endEditBlock()
   {
+    OFXS_TRACE_SUITE_CALL("paramEditEnd");
     OfxStatus stat = OFX::Private::gParamSuite->paramEditEnd(_paramSetHandle);
     throwSuiteStatusException(stat);
   }
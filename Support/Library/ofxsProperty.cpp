@@ -42,7 +42,7 @@ namespace OFX {
 
   static
   void throwPropertyException(OfxStatus stat,
-    const std::string &propName) OFX_THROW4(std::bad_alloc,
+    const char *propName) OFX_THROW4(std::bad_alloc,
     OFX::Exception::PropertyUnknownToHost,
     OFX::Exception::PropertyValueIllegalToHost,
     OFX::Exception::Suite)
@@ -59,7 +59,7 @@ namespace OFX {
     case kOfxStatErrUnknown :
     case kOfxStatErrUnsupported : // unsupported implies unknow here
       if(OFX::PropertySet::getThrowOnUnsupportedProperties()) // are we suppressing this?
-        throw OFX::Exception::PropertyUnknownToHost(propName.c_str());
+        throw OFX::Exception::PropertyUnknownToHost(propName);
       break;
 
     case kOfxStatErrMemory :
@@ -67,7 +67,7 @@ namespace OFX {
       break;
 
     case kOfxStatErrValue :
-      throw  OFX::Exception::PropertyValueIllegalToHost(propName.c_str());
+      throw  OFX::Exception::PropertyValueIllegalToHost(propName);
       break;
 
     case kOfxStatErrBadHandle :
@@ -78,9 +78,6 @@ namespace OFX {
     }
   }
 
-  /** @brief are we logging property get/set */
-  int PropertySet::_gPropLogging = 1;
-
   /** @brief Do we throw an exception if a host returns 'unsupported' when setting a property */
   bool PropertySet::_gThrowOnUnsupported = true;
 
@@ -94,14 +91,12 @@ namespace OFX {
   {
     assert(_propHandle != 0);
     int dimension = 0;
+    OFXS_TRACE_SUITE_CALL("propGetDimension");
     OfxStatus stat = gPropSuite->propGetDimension(_propHandle, property, &dimension);
     Log::error(stat != kOfxStatOK && stat != kOfxStatErrUnknown, "Failed on fetching dimension for property %s, host returned status %s.", property, mapStatusToString(stat));
     if(throwOnFailure && stat != kOfxStatErrUnknown && stat != kOfxStatErrUnsupported)
       throwPropertyException(stat, property); 
 
-    if(_gPropLogging > 0) 
-      Log::print("Fetched dimension of property %s, returned status %s.",  property, mapStatusToString(stat));
-
     return stat == kOfxStatOK;
   }
 
@@ -113,14 +108,12 @@ namespace OFX {
   {
     assert(_propHandle != 0);
     int dimension = 0;
+    OFXS_TRACE_SUITE_CALL("propGetDimension");
     OfxStatus stat = gPropSuite->propGetDimension(_propHandle, property, &dimension);
     Log::error(stat != kOfxStatOK, "Failed on fetching dimension for property %s, host returned status %s.", property, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
 
-    if(_gPropLogging > 0) 
-      Log::print("Fetched dimension of property %s, returned %d.",  property, dimension);
-
     return dimension;
   }
 
@@ -131,11 +124,10 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propReset");
     OfxStatus stat = gPropSuite->propReset(_propHandle, property);
     Log::error(stat != kOfxStatOK, "Failed on reseting property %s to its defaults, host returned status %s.", property, mapStatusToString(stat));
     throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Reset property %s.",  property);
   }
 
   /** @brief, Set a single dimension pointer property */
@@ -145,13 +137,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propSetPointer");
     OfxStatus stat = gPropSuite->propSetPointer(_propHandle, property, idx, value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting pointer property %s[%d] to %p, host returned status %s;", 
       property, idx, value, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);  
-
-    if(_gPropLogging > 0) Log::print("Set pointer property %s[%d] to be %p.",  property, idx, value);
   }
 
   /** @brief, Set a single dimension string property */
@@ -161,13 +152,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propSetString");
     OfxStatus stat = gPropSuite->propSetString(_propHandle, property, idx, value.c_str());
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting string property %s[%d] to %s, host returned status %s;", 
       property, idx, value.c_str(), mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Set string property %s[%d] to be %s.",  property, idx, value.c_str());
   }
 
   /** @brief, Set a single dimension double property */
@@ -177,13 +167,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propSetDouble");
     OfxStatus stat = gPropSuite->propSetDouble(_propHandle, property, idx, value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting double property %s[%d] to %lf, host returned status %s;", 
       property, idx, value, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Set double property %s[%d] to be %lf.",  property, idx, value);
   }
 
   /** @brief, Set a single dimension int property */
@@ -193,13 +182,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propSetInt");
     OfxStatus stat = gPropSuite->propSetInt(_propHandle, property, idx, value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting int property %s[%d] to %d, host returned status %s (%d);", 
       property, idx, value, mapStatusToString(stat), stat);
     if(throwOnFailure)
       throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Set int property %s[%d] to be %d.",  property, idx, value);
   }
 
   void PropertySet::propSetStringN(const char* property, const std::vector<std::string> &values, bool throwOnFailure) OFX_THROW4(std::bad_alloc,
@@ -212,13 +200,12 @@ namespace OFX {
     for (std::size_t i = 0; i < values.size(); ++i) {
       data[i] = values[i].c_str();
     }
+    OFXS_TRACE_SUITE_CALL("propSetStringN");
     OfxStatus stat = gPropSuite->propSetStringN(_propHandle, property, (int)values.size(), &data[0]);
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting string property %s[0..%d], host returned status %s;",
                     property, (int)values.size()-1, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);
-    
-    if(_gPropLogging > 0) Log::print("Set string property %s[0..%d].",  property, (int)values.size()-1);
   }
 
   /** @brief, Set a multiple dimension double property */
@@ -237,13 +224,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propSetDoubleN");
     OfxStatus stat = gPropSuite->propSetDoubleN(_propHandle, property, count, values);
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting double property %s[0..%d], host returned status %s;",
       property, count-1, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Set double property %s[0..%d].",  property, count-1);
   }
   
   void PropertySet::propSetIntN(const char* property, const std::vector<int> &values, bool throwOnFailure) OFX_THROW4(std::bad_alloc,
@@ -261,14 +247,12 @@ namespace OFX {
   {
     assert(_propHandle != 0);
 
+    OFXS_TRACE_SUITE_CALL("propSetIntN");
     OfxStatus stat = gPropSuite->propSetIntN(_propHandle, property, count, values);
     OFX::Log::error(stat != kOfxStatOK, "Failed on setting int property %s[0..%d], host returned status %s;",
                     property, count-1, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);
-
-    if(_gPropLogging > 0) Log::print("Set int property %s[0..%d].",  property, count-1);
-
   }
 
   /** @brief Get single pointer property */
@@ -279,14 +263,13 @@ namespace OFX {
   {
     assert(_propHandle != 0);
     void *value = 0;
+    OFXS_TRACE_SUITE_CALL("propGetPointer");
     OfxStatus stat = gPropSuite->propGetPointer(_propHandle, property, idx, &value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting pointer property %s[%d], host returned status %s;", 
       property, idx, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
 
-    if(_gPropLogging > 0) Log::print("Retrieved pointer property %s[%d], was given %p.",  property, idx, value);
-
     return value;
   }
 
@@ -298,13 +281,12 @@ namespace OFX {
   {
     assert(_propHandle != 0);
     const char *value = NULL;
+    OFXS_TRACE_SUITE_CALL("propGetString");
     OfxStatus stat = gPropSuite->propGetString(_propHandle, property, idx, &value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting string property %s[%d], host returned status %s;", 
       property, idx, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);
-
-    if(_gPropLogging > 0) Log::print("Retrieved string property %s[%d], was given %s.",  property, idx, value);
     return value != NULL ?  std::string(value) : std::string();
   }
 
@@ -316,13 +298,12 @@ namespace OFX {
   {
     assert(_propHandle != 0);
     double value = 0;
+    OFXS_TRACE_SUITE_CALL("propGetDouble");
     OfxStatus stat = gPropSuite->propGetDouble(_propHandle, property, idx, &value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting double property %s[%d], host returned status %s;", 
       property, idx, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Retrieved double property %s[%d], was given %lf.",  property, idx, value);
     return value;
   }
 
@@ -334,13 +315,12 @@ namespace OFX {
   {
     assert(_propHandle != 0);
     int value = 0;
+    OFXS_TRACE_SUITE_CALL("propGetInt");
     OfxStatus stat = gPropSuite->propGetInt(_propHandle, property, idx, &value);
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting int property %s[%d], host returned status %s;", 
       property, idx, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property); 
-
-    if(_gPropLogging > 0) Log::print("Retrieved int property %s[%d], was given %d.",  property, idx, value);
     return value;
   }
     
@@ -355,13 +335,12 @@ namespace OFX {
       return;
     }
     std::vector<const char*> rawValue(dimension, (char*)0);
+    OFXS_TRACE_SUITE_CALL("propGetStringN");
     OfxStatus stat = gPropSuite->propGetStringN(_propHandle, property, dimension, &rawValue.front());
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting string property %s, host returned status %s;",
                       property, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);
-      
-    if(_gPropLogging > 0) Log::print("Retrieved string property %s, was given %s.", property, (const char*)&rawValue.front());
     
     values->resize(dimension);
     for (int i = 0; i < dimension; ++i) {
@@ -394,30 +373,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propGetDoubleN");
     OfxStatus stat = gPropSuite->propGetDoubleN(_propHandle, property, count, values);
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting double property %s, host returned status %s;",
                     property, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);
-
-    if(_gPropLogging > 0) {
-      switch (count) {
-      case 1:
-        Log::print("Retrieved doublex1 property %s, was given %g.", property, values[0]);
-        break;
-      case 2:
-        Log::print("Retrieved doublex2 property %s, was given %g %g.", property, values[0], values[1]);
-        break;
-      case 3:
-        Log::print("Retrieved doublex3 property %s, was given %g %g %g.", property, values[0], values[1], values[2]);
-        break;
-      case 4:
-        Log::print("Retrieved doublex4 property %s, was given %g %g %g %g.", property, values[0], values[1], values[2], values[3]);
-        break;
-      default:
-        Log::print("Retrieved doublex%d property %s.", count, property);
-      }
-    }
   }
 
   void PropertySet::propGetIntN(const char* property, std::vector<int>* values, bool throwOnFailure) const OFX_THROW4(std::bad_alloc,
@@ -441,31 +402,12 @@ namespace OFX {
     OFX::Exception::Suite)
   {
     assert(_propHandle != 0);
+    OFXS_TRACE_SUITE_CALL("propGetIntN");
     OfxStatus stat = gPropSuite->propGetIntN(_propHandle, property, count, values);
     OFX::Log::error(stat != kOfxStatOK, "Failed on getting int property %s, host returned status %s;",
                     property, mapStatusToString(stat));
     if(throwOnFailure)
       throwPropertyException(stat, property);
-
-    if(_gPropLogging > 0) {
-      switch (count) {
-      case 1:
-        Log::print("Retrieved intx1 property %s, was given %d.", property, values[0]);
-        break;
-      case 2:
-        Log::print("Retrieved intx2 property %s, was given %d %d.", property, values[0], values[1]);
-        break;
-      case 3:
-        Log::print("Retrieved intx3 property %s, was given %d %d %d.", property, values[0], values[1], values[2]);
-        break;
-      case 4:
-        Log::print("Retrieved intx4 property %s, was given %d %d %d %d.", property, values[0], values[1], values[2], values[3]);
-        break;
-      default:
-        Log::print("Retrieved intx%d property %s.", count, property);
-      }
-    }
-
   }
 
 };
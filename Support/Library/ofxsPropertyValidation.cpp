@@ -276,21 +276,16 @@ namespace OFX {
     void
       PropertySetDescription::validate(PropertySet &propSet, 
       bool checkDefaults,
-      bool logOrdinaryMessages)
+      bool /*logOrdinaryMessages*/)
     {
       OFX::Log::print("START validating properties of %s.", _setName.c_str());
       OFX::Log::indent();
 
-      // don't print ordinary messages whilst we are checking them
-      if(!logOrdinaryMessages) PropertySet::propDisableLogging();
-
       // check each property in the description
       int n = (int)_descriptions.size();
       for(int i = 0; i < n; i++) 
         _descriptions[i]->validate(checkDefaults, propSet);
 
-      if(!logOrdinaryMessages) PropertySet::propEnableLogging();
-
       OFX::Log::outdent();
       OFX::Log::print("STOP property validation of %s.", _setName.c_str());
     }
@@ -1245,54 +1240,58 @@ namespace OFX {
 
     /** @brief Validates action in/out arguments */
     void
-      validateActionArgumentsProperties(const std::string &action, PropertySet inArgs, PropertySet outArgs)
+      validateActionArgumentsProperties(Private::ActionEnum action, PropertySet inArgs, PropertySet outArgs)
     {
 #ifdef kOfxsDisableValidation
     (void)action;
     (void)inArgs;
     (void)outArgs;
 #else
-      if(action == kOfxActionInstanceChanged) {
-        gInstanceChangedInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxActionBeginInstanceChanged) {
-        gBeginInstanceChangedInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxActionEndInstanceChanged) {
-        gEndInstanceChangedInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxImageEffectActionGetRegionOfDefinition) {
-        gGetRegionOfDefinitionInArgPropSet.validate(inArgs);
-        gGetRegionOfDefinitionOutArgPropSet.validate(outArgs);
-      }
-      else if(action == kOfxImageEffectActionGetRegionsOfInterest) {
-        gGetRegionOfInterestInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxImageEffectActionGetTimeDomain) {
-        gGetTimeDomainOutArgPropSet.validate(outArgs);
-      }
-      else if(action == kOfxImageEffectActionGetFramesNeeded) {
-        gGetFramesNeededInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxImageEffectActionGetClipPreferences) {
-        gGetClipPreferencesOutArgPropSet.validate(outArgs);
-      }
-      else if(action == kOfxImageEffectActionIsIdentity) {
-        gIsIdentityActionInArgPropSet.validate(inArgs);
-        gIsIdentityActionOutArgPropSet.validate(outArgs);
-      }
-      else if(action == kOfxImageEffectActionRender) {
-        gRenderActionInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxImageEffectActionBeginSequenceRender) {
-        gBeginSequenceRenderActionInArgPropSet.validate(inArgs);
-      }
-      else if(action == kOfxImageEffectActionEndSequenceRender) {
-        gEndSequenceRenderActionInArgPropSet.validate(inArgs);
+      switch(action) {
+        case Private::eActionInstanceChanged :
+          gInstanceChangedInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionBeginInstanceChanged :
+          gBeginInstanceChangedInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionEndInstanceChanged :
+          gEndInstanceChangedInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionGetRegionOfDefinition :
+          gGetRegionOfDefinitionInArgPropSet.validate(inArgs);
+          gGetRegionOfDefinitionOutArgPropSet.validate(outArgs);
+          break;
+        case Private::eActionGetRegionsOfInterest :
+          gGetRegionOfInterestInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionGetTimeDomain :
+          gGetTimeDomainOutArgPropSet.validate(outArgs);
+          break;
+        case Private::eActionGetFramesNeeded :
+          gGetFramesNeededInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionGetClipPreferences :
+          gGetClipPreferencesOutArgPropSet.validate(outArgs);
+          break;
+        case Private::eActionIsIdentity :
+          gIsIdentityActionInArgPropSet.validate(inArgs);
+          gIsIdentityActionOutArgPropSet.validate(outArgs);
+          break;
+        case Private::eActionRender :
+          gRenderActionInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionBeginSequenceRender :
+          gBeginSequenceRenderActionInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionEndSequenceRender :
+          gEndSequenceRenderActionInArgPropSet.validate(inArgs);
+          break;
+        case Private::eActionDescribeInContext :
+          gDescribeInContextActionInArgPropSet.validate(inArgs);
+          break;
+        default :
+          break;
       }
-      else if(action == kOfxImageEffectActionDescribeInContext) {
-        gDescribeInContextActionInArgPropSet.validate(inArgs);
-      }     
 #endif 
     }
 
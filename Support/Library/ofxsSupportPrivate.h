@@ -46,7 +46,9 @@ England
 #endif
 #include "ofxsImageEffect.h"
 #include "ofxsLog.h"
+#include "ofxsTrace.h"
 #include "ofxsMultiThread.h"
+#include "ofxPropertyBatch.h"
 
 /** @brief Namespace private to the ofx support library.
 */
@@ -62,6 +64,9 @@ namespace OFX {
     /** @brief Pointer to the property suite */
     extern OfxPropertySuiteV1    *gPropSuite;
 
+    /** @brief Pointer to the optional property batch suite */
+    extern OfxPropertyBatchSuiteV1 *gPropBatchSuite;
+
     /** @brief Pointer to the  interact suite */
     extern OfxInteractSuiteV1    *gInteractSuite;
 
@@ -107,6 +112,60 @@ namespace OFX {
     extern OfxVegasKeyframeSuiteV1 *gVegasKeyframeSuite;
 #endif
 
+    /** @brief The actions the support library dispatches on */
+    enum ActionEnum {
+      eActionUnknown,
+      eActionLoad,
+      eActionUnload,
+      eActionDescribe,
+      eActionDescribeInContext,
+      eActionCreateInstance,
+      eActionDestroyInstance,
+      eActionRender,
+      eActionBeginSequenceRender,
+      eActionEndSequenceRender,
+      eActionIsIdentity,
+      eActionGetRegionOfDefinition,
+      eActionGetRegionsOfInterest,
+      eActionGetFramesNeeded,
+      eActionGetClipPreferences,
+      eActionPurgeCaches,
+      eActionSyncPrivateData,
+      eActionGetTimeDomain,
+      eActionBeginInstanceChanged,
+      eActionInstanceChanged,
+      eActionEndInstanceChanged,
+      eActionBeginInstanceEdit,
+      eActionEndInstanceEdit,
+#ifdef OFX_SUPPORTS_OPENGLRENDER
+      eActionOpenGLContextAttached,
+      eActionOpenGLContextDetached,
+#endif
+#ifdef OFX_SUPPORTS_DIALOG
+      eActionDialog,
+#endif
+#ifdef OFX_EXTENSIONS_VEGAS
+      eActionVegasKeyframeUplift,
+      eActionInvokeHelp,
+      eActionInvokeAbout,
+#endif
+#ifdef OFX_EXTENSIONS_NUKE
+      eActionGetClipComponents,
+      eActionGetFrameViewsNeeded,
+      eActionGetTransform,
+#endif
+#ifdef OFX_EXTENSIONS_NATRON
+      eActionGetInverseDistortion,
+#endif
+      eActionCount
+    };
+
+    /** @brief map an action name to an enum, eActionUnknown for NULL or an action the library does not handle.
+
+    This is a hash lookup and allocates nothing, so it is cheap enough to do on every call to the main entry point.
+    */
+    ActionEnum mapToActionEnum(const char *action);
+
     /** @brief Support lib function called on an ofx load action */
     void loadAction(void);
 
@@ -120,6 +179,12 @@ namespace OFX {
     /** @brief fetches our pointer out of the props on the handle */
     ImageEffect *retrieveImageEffectPointer(OfxImageEffectHandle handle);
 
+    /** @brief records an instance against its handle, so retrieveImageEffectPointer need not ask the host for it */
+    void registerImageEffectPointer(OfxImageEffectHandle handle, ImageEffect *instance);
+
+    /** @brief forgets the instance recorded against a handle */
+    void unregisterImageEffectPointer(OfxImageEffectHandle handle);
+
     /** @brief fetch the prop set from the effect handle */
     OFX::PropertySet
       fetchEffectProps(OfxImageEffectHandle handle);
@@ -152,8 +217,48 @@ namespace OFX {
         }
     };
       
+    /** @brief a plugin name and version, compared like a VersionIDKey without copying the name */
+    struct VersionIDRef
+    {
+        const char *id;
+        unsigned int majorVersion, minorVersion;
+    };
+
+#if __cplusplus >= 201402L
+    /** @brief orders VersionIDKey as its operator< does, and can compare it to a VersionIDRef */
+    struct VersionIDLess
+    {
+        typedef void is_transparent;
+
+        static int compare(const VersionIDKey& lhs, const VersionIDRef& rhs)
+        {
+            int c = lhs.id.compare(rhs.id);
+            if (c != 0) {
+                return c;
+            }
+            if (lhs.majorVersion != rhs.majorVersion) {
+                return lhs.majorVersion < rhs.majorVersion ? -1 : 1;
+            }
+            if (lhs.minorVersion != rhs.minorVersion) {
+                return lhs.minorVersion < rhs.minorVersion ? -1 : 1;
+            }
+            return 0;
+        }
+
+        bool operator()(const VersionIDKey& lhs, const VersionIDKey& rhs) const { return lhs < rhs; }
+        bool operator()(const VersionIDKey& lhs, const VersionIDRef& rhs) const { return compare(lhs, rhs) < 0; }
+        bool operator()(const VersionIDRef& lhs, const VersionIDKey& rhs) const { return compare(rhs, lhs) > 0; }
+    };
+
+    // a transparent comparator, so that the per frame actions find their descriptor without building a key
+    typedef std::map<VersionIDKey, EffectContextMap, VersionIDLess> EffectDescriptorMap;
+#else
     typedef std::map<VersionIDKey, EffectContextMap> EffectDescriptorMap;
+#endif
     extern EffectDescriptorMap gEffectDescriptors;
+
+    /** @brief the descriptor made by the describe action of the given plugin in the given context */
+    ImageEffectDescriptor *getEffectDescriptor(const char *plugname, unsigned int majorVersion, unsigned int minorVersion, ContextEnum context);
   };
 
   /** @brief The validation code has its own namespace */
@@ -303,7 +408,7 @@ namespace OFX {
 
     /** @brief Validates action in/out arguments */
     void
-      validateActionArgumentsProperties(const std::string &action, PropertySet inArgs, PropertySet outArgs);
+      validateActionArgumentsProperties(Private::ActionEnum action, PropertySet inArgs, PropertySet outArgs);
 
     /** @brief Validates parameter properties */
     void
@@ -0,0 +1,289 @@
+/*
+OFX Support Library, a library that skins the OFX plug-in API with C++ classes.
+Copyright (C) 2004-2005 The Open Effects Association Ltd
+Author Bruno Nicoletti bruno@thefoundry.co.uk
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The Open Effects Association Ltd
+1 Wardour St
+London W1D 6PA
+England
+
+
+*/
+
+/** @file This file contains the body of the tracing functions.
+
+Each thread that records gets its own ring buffer, made the first time it records and pushed onto a
+lock free list. Only the owning thread writes a buffer, and it publishes each event by bumping the
+buffer's count, so recording needs no lock. Buffers are never freed, a thread's events are wanted
+after it has gone, but when a thread exits its buffer is handed on to the next thread that starts
+recording, so a host that keeps making short lived threads does not keep growing the list. The
+threads sharing a buffer show up one after the other on the same track of the trace.
+
+The file is written in the Chrome trace event format, see
+https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+*/
+
+#include "ofxsTrace.h"
+
+#ifdef OFXS_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/// the number of events each thread's ring buffer holds, must be a power of 2, see ofxsTrace.h
+#ifndef OFXS_TRACE_BUFFER_EVENTS
+#define OFXS_TRACE_BUFFER_EVENTS 65536
+#endif
+
+/// environment variable for the trace file
+#define kTraceFileEnvVar "OFX_PLUGIN_TRACEFILE"
+
+namespace OFX {
+  namespace Trace {
+
+    static_assert((OFXS_TRACE_BUFFER_EVENTS & (OFXS_TRACE_BUFFER_EVENTS - 1)) == 0, "OFXS_TRACE_BUFFER_EVENTS must be a power of 2");
+
+    /** @brief a thread's ring buffer of events */
+    struct Buffer {
+      Event                 events[OFXS_TRACE_BUFFER_EVENTS];
+      std::atomic<uint64_t> count;  ///< how many events have ever been recorded
+      std::atomic<bool>     inUse;  ///< whether a live thread is recording into it
+      int                   thread; ///< the buffer's track number in the trace
+      Buffer               *next;
+    };
+
+    /** @brief this thread's buffer */
+    static thread_local Buffer *tBuffer = nullptr;
+
+    /** @brief set once this thread's BufferOwner is gone */
+    static thread_local bool tExited = false;
+
+    /** @brief hands a thread's buffer back when the thread exits
+
+    This is kept apart from tBuffer, as a thread_local with a destructor costs a check on every access.
+    The thread may still record from the destructors of thread_locals that go after this one, so it
+    forgets the buffer before handing it back, see record.
+    */
+    struct BufferOwner {
+      Buffer *buffer;
+
+      BufferOwner() : buffer(nullptr) {}
+      ~BufferOwner()
+      {
+        tBuffer = nullptr;
+        tExited = true;
+        if(buffer)
+          buffer->inUse.store(false, std::memory_order_release);
+      }
+    };
+
+    /** @brief every thread's buffer */
+    static std::atomic<Buffer *> gBuffers(nullptr);
+
+    /** @brief how many threads have traced */
+    static std::atomic<int> gNThreads(0);
+
+    /** @brief frees this thread's buffer when it exits */
+    static thread_local BufferOwner tBufferOwner;
+
+    /** @brief the clock's time when the binary was loaded, times in the trace are relative to this */
+    static const std::chrono::steady_clock::time_point gStart = std::chrono::steady_clock::now();
+
+    /** @brief the global trace file name */
+    static std::string gTraceFileName(getenv(kTraceFileEnvVar) ? getenv(kTraceFileEnvVar) : "ofxTrace.json");
+
+    /** @brief whether the trace has been written */
+    static std::atomic<bool> gDumped(false);
+
+    /** @brief take the buffer of a thread that has exited, or make a new one and add it to the list */
+    static Buffer *takeBuffer(void)
+    {
+      Buffer *buffer = gBuffers.load(std::memory_order_acquire);
+      for(; buffer; buffer = buffer->next) {
+        bool inUse = false;
+        if(!buffer->inUse.load(std::memory_order_relaxed) && buffer->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+          break;
+      }
+
+      if(!buffer) {
+        buffer = new Buffer;
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->inUse.store(true, std::memory_order_relaxed);
+        buffer->thread = ++gNThreads;
+        buffer->next = gBuffers.load(std::memory_order_relaxed);
+        while(!gBuffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed))
+          ;
+      }
+      return buffer;
+    }
+
+    /** @brief The time now in nanoseconds, from a steady clock. */
+    uint64_t now(void)
+    {
+      return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gStart).count();
+    }
+
+    /** @brief add an event to a buffer, publishing it by bumping the count */
+    static inline void append(Buffer &buffer, EventTypeEnum type, const char *name, uint64_t time, uint64_t duration, uint64_t value)
+    {
+      uint64_t count = buffer.count.load(std::memory_order_relaxed);
+      Event &event = buffer.events[count & (OFXS_TRACE_BUFFER_EVENTS - 1)];
+      event.time = time;
+      event.duration = duration;
+      event.value = value;
+      event.name = name;
+      event.type = type;
+      buffer.count.store(count + 1, std::memory_order_release);
+    }
+
+    /** @brief Records an event in the calling thread's ring buffer. */
+    void record(EventTypeEnum type, const char *name, uint64_t time, uint64_t duration, uint64_t value)
+    {
+      Buffer *buffer = tBuffer;
+      if(!buffer) {
+        buffer = takeBuffer();
+        if(tExited) {
+          // nothing would hand the buffer back, so only borrow it for this event
+          append(*buffer, type, name, time, duration, value);
+          buffer->inUse.store(false, std::memory_order_release);
+          return;
+        }
+        tBuffer = tBufferOwner.buffer = buffer;
+      }
+      append(*buffer, type, name, time, duration, value);
+    }
+
+    /** @brief Sets the name of the trace file. */
+    void setFileName(const std::string &value)
+    {
+      gTraceFileName = value;
+    }
+
+    /** @brief write a name as a JSON string */
+    static void writeName(FILE *fp, const char *name)
+    {
+      fputc('"', fp);
+      for(const char *c = name ? name : "unnamed"; *c; ++c) {
+        if(*c == '"' || *c == '\\')
+          fputc('\\', fp);
+        if((unsigned char) *c >= 0x20)
+          fputc(*c, fp);
+      }
+      fputc('"', fp);
+    }
+
+    /** @brief write one event */
+    static void writeEvent(FILE *fp, const Event &event, int thread)
+    {
+      static const char *const phases[] = {"B", "E", "X", "X", "C", "X"};
+      static const char *const categories[] = {"action", "action", "suite", "image", "bytes", "plugin"};
+
+      fputs(",\n{\"name\":", fp);
+      writeName(fp, event.name);
+      fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+              categories[event.type], phases[event.type], thread, event.time / 1000.0);
+      switch(event.type) {
+      case eEventSuiteCall :
+      case eEventScope :
+        fprintf(fp, ",\"dur\":%.3f", event.duration / 1000.0);
+        break;
+      case eEventImageFetch :
+        fprintf(fp, ",\"dur\":%.3f,\"args\":{\"bytes\":%llu}", event.duration / 1000.0, (unsigned long long) event.value);
+        break;
+      case eEventBytes :
+        fprintf(fp, ",\"args\":{\"bytes\":%llu}", (unsigned long long) event.value);
+        break;
+      default :
+        break;
+      }
+      fputc('}', fp);
+    }
+
+    /** @brief Writes the events held in every thread's buffer to the trace file. */
+    bool dump(void)
+    {
+      gDumped.store(true);
+      FILE *fp = fopen(gTraceFileName.c_str(), "w");
+      if(!fp)
+        return false;
+
+      fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"OFX plugin\"}}", fp);
+
+      std::vector<Event> events;
+      for(Buffer *buffer = gBuffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        // copy the buffer out, then drop anything its thread may have written over while we did,
+        // including the one event it may be half way through
+        uint64_t end = buffer->count.load(std::memory_order_acquire);
+        uint64_t begin = end > OFXS_TRACE_BUFFER_EVENTS ? end - OFXS_TRACE_BUFFER_EVENTS : 0;
+        events.resize((size_t)(end - begin));
+        for(uint64_t i = begin; i < end; ++i)
+          events[(size_t)(i - begin)] = buffer->events[i & (OFXS_TRACE_BUFFER_EVENTS - 1)];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = buffer->count.load(std::memory_order_relaxed);
+        uint64_t firstGood = after + 1 > OFXS_TRACE_BUFFER_EVENTS ? after + 1 - OFXS_TRACE_BUFFER_EVENTS : 0;
+
+        fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}", buffer->thread, buffer->thread);
+
+        // once the buffer has wrapped, the starts of the oldest actions may be gone, and viewers
+        // mismatch the rest of the track if they are given an end with no start, so skip those
+        int depth = 0;
+        for(uint64_t i = begin < firstGood ? firstGood : begin; i < end; ++i) {
+          const Event &event = events[(size_t)(i - begin)];
+          if(event.type == eEventActionBegin)
+            ++depth;
+          else if(event.type == eEventActionEnd) {
+            if(depth == 0)
+              continue;
+            --depth;
+          }
+          writeEvent(fp, event, buffer->thread);
+        }
+      }
+
+      fputs("\n]}\n", fp);
+      return fclose(fp) == 0;
+    }
+
+    /** @brief writes the trace when the binary is closed or the process exits, if it was not written on unload
+
+    This is defined after the file name, so it is destroyed before it.
+    */
+    static struct DumpAtExit {
+      ~DumpAtExit()
+      {
+        if(!gDumped.load())
+          dump();
+      }
+    } gDumpAtExit;
+  };
+};
+
+#endif
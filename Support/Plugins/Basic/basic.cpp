@@ -50,6 +50,7 @@ England
 #include "ofxsMultiThread.h"
 
 #include "../include/ofxsProcessing.H"
+#include "../include/ofxsPixelKernels.H"
 
 ////////////////////////////////////////////////////////////////////////////////
 // a dumb interact that just draw's a square you can drag
@@ -90,14 +91,6 @@ Minimum(T a, T b) {    return (a < b) ? a : b;}
 template <class T> inline T
 Absolute(T a) { return (a < 0) ? -a : a;}
 
-template <class T> inline T 
-Clamp(T v, int min, int max)
-{
-  if(v < T(min)) return T(min);
-  if(v > T(max)) return T(max);
-  return v;
-}
-
 // Base class for the RGBA and the Alpha processor
 class ImageScalerBase : public OFX::ImageProcessor {
 protected :
@@ -118,6 +111,8 @@ public :
     , _aScale(1)
     , _doMasking(false)
   {        
+    // masked rows cost more than the others, so hand them out a few at a time
+    setScheduling(OFX::eSchedulingDynamic);
   }
 
   /** @brief set the src image */
@@ -159,55 +154,46 @@ public :
     scales[2] = (float)_bScale;
     scales[3] = (float)_aScale;
 
-    float maskScale = 1.0f;
+    // the mask scale of each pixel in a run, used when we have a mask image
+    bool masked = _doMasking && _maskImg;
+    std::vector<float> maskScales(masked ? procWindow.x2 - procWindow.x1 : 0);
+
+    OFX::ImageView<PIX, nComponents> dst(_dstImg), src(_srcImg);
+    OFX::ImageView<PIX, 1> mask(masked ? _maskImg : NULL); // the mask clip is single channel
 
     for(int y = procWindow.y1; y < procWindow.y2; y++) {
       if(_effect.abort()) break;
 
-      PIX *dstPix = (PIX *) _dstImg->getPixelAddress(procWindow.x1, y);
-
-      for(int x = procWindow.x1; x < procWindow.x2; x++) {
+      PIX *dstPix = dst.getPixel(procWindow.x1, y);
 
-        PIX *srcPix = (PIX *)  (_srcImg ? _srcImg->getPixelAddress(x, y) : 0);
-
-        // are we doing masking
-        if(_doMasking) {
-          // we do, get the pixel from the mask
-          if(!_maskImg)
-            maskScale = 1.0f;
-          else
-          {
-            PIX *maskPix = (PIX *)  (_maskImg ? _maskImg->getPixelAddress(x, y) : 0);
-            // figure the scale factor from that pixel
-            maskScale = maskPix != 0 ? float(*maskPix)/float(max) : 0.0f;
-          }
-        }
+      for(int x = procWindow.x1; x < procWindow.x2; ) {
+        int x2 = procWindow.x2;
+        const PIX *srcPix = src.getRun(x, y, &x2);
 
         // do we have a source image to scale up
-        if(srcPix) {
-          for(int c = 0; c < nComponents; c++) {
-            float v;
-
-            // scale the component up by the scale factor, modulated by the maskScale
-            if(maskScale != 1.0f) 
-              v = srcPix[c] * (1.0f + (scales[c] - 1.0f) * maskScale);
-            else
-              v = srcPix[c] * scales[c];
-
-            if(max == 1)  // implies floating point and so no clamping
-              dstPix[c] = PIX(v);
-            else  // integer based and we need to clamp
-              dstPix[c] = PIX(Clamp(v, 0, max));
-          }
+        if(!srcPix) {
+          // no src pixel here, be black and transparent
+          memset(dstPix, 0, (x2 - x) * nComponents * sizeof(PIX));
+        }
+        else if(masked) {
+          // figure the scale factor from each mask pixel, 0 where there is none
+          OFX::RowSpan<PIX> maskRow = mask.getRowSpan(y, x, x2);
+          std::fill(&maskScales[0], &maskScales[0] + (maskRow.x1 - x), 0.0f);
+          for(int i = 0; i < maskRow.size(); i++)
+            maskScales[maskRow.x1 - x + i] = OFX::PixelKernels::PixelTraits<PIX>::toFloat(maskRow.pixels[i])/float(max);
+          std::fill(&maskScales[0] + (maskRow.x2 - x), &maskScales[0] + (x2 - x), 0.0f);
+
+          // scale the components up by the scale factor, modulated by the maskScale
+          OFX::PixelKernels::scaleMixedRow<PIX, nComponents>(srcPix, &maskScales[0], dstPix, x2 - x, scales);
         }
         else {
-          // no src pixel here, be black and transparent
-          for(int c = 0; c < nComponents; c++) {
-            dstPix[c] = 0;
-          }
+          // integer based components are clamped, floating point ones are not
+          OFX::PixelKernels::scaleOffsetRow<PIX, nComponents>(srcPix, dstPix, x2 - x, scales, NULL);
         }
+
         // increment the dst pixel
-        dstPix += nComponents;
+        dstPix += (x2 - x) * nComponents;
+        x = x2;
       }
     }
   }
@@ -229,6 +215,10 @@ protected :
   OFX::DoubleParam  *aScale_;
   OFX::BooleanParam *componentScalesEnabled_;
 
+  // the scale values, fetched again only at a new time or after a param change, we are
+  // render instance safe so only one render at a time uses it
+  OFX::ParamSnapshot values_;
+
 public :
   /** @brief ctor */
   BasicPlugin(OfxImageEffectHandle handle)
@@ -285,6 +275,14 @@ public :
   /* set up and run a processor */
   void
     setupAndProcess(ImageScalerBase &, const OFX::RenderArguments &args);
+
+  /* set up and run a processor for one pixel type, called back by OFX::dispatchPixelType */
+  template <class PIX, int nComponents, int maxValue>
+  void processPixels(const OFX::RenderArguments &args)
+  {
+    ImageScaler<PIX, nComponents, maxValue> fred(*this);
+    setupAndProcess(fred, args);
+  }
 };
 
 
@@ -331,15 +329,16 @@ BasicPlugin::setupAndProcess(ImageScalerBase &processor, const OFX::RenderArgume
     processor.setMaskImg(mask.get());
   }
 
-  // get the scale parameter values...
-  double r, g, b, a = aScale_->getValueAtTime(args.time);
-  r = g = b = scale_->getValueAtTime(args.time);
+  // get the scale parameter values, the tiles of a frame share one fetch
+  fetchParamSnapshot(args.time, values_);
+  double r, g, b, a = values_.getValue(aScale_);
+  r = g = b = values_.getValue(scale_);
 
   // see if the individual component scales are enabled
-  if(componentScalesEnabled_->getValueAtTime(args.time)) {
-    r *= rScale_->getValueAtTime(args.time);
-    g *= gScale_->getValueAtTime(args.time);
-    b *= bScale_->getValueAtTime(args.time);
+  if(values_.getValue(componentScalesEnabled_)) {
+    r *= values_.getValue(rScale_);
+    g *= values_.getValue(gScale_);
+    b *= values_.getValue(bScale_);
   }
 
   // set the images
@@ -384,57 +383,8 @@ BasicPlugin::getRegionsOfInterest(const OFX::RegionsOfInterestArguments &args, O
 void
 BasicPlugin::render(const OFX::RenderArguments &args)
 {
-  // instantiate the render code based on the pixel depth of the dst clip
-  OFX::BitDepthEnum       dstBitDepth    = dstClip_->getPixelDepth();
-  OFX::PixelComponentEnum dstComponents  = dstClip_->getPixelComponents();
-
-  // do the rendering
-  if(dstComponents == OFX::ePixelComponentRGBA) {
-    switch(dstBitDepth) {
-case OFX::eBitDepthUByte : {      
-  ImageScaler<unsigned char, 4, 255> fred(*this);
-  setupAndProcess(fred, args);
-                           }
-                           break;
-
-case OFX::eBitDepthUShort : {
-  ImageScaler<unsigned short, 4, 65535> fred(*this);
-  setupAndProcess(fred, args);
-                            }                          
-                            break;
-
-case OFX::eBitDepthFloat : {
-  ImageScaler<float, 4, 1> fred(*this);
-  setupAndProcess(fred, args);
-                           }
-                           break;
-default :
-  OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  }
-  else {
-    switch(dstBitDepth) {
-case OFX::eBitDepthUByte : {
-  ImageScaler<unsigned char, 1, 255> fred(*this);
-  setupAndProcess(fred, args);
-                           }
-                           break;
-
-case OFX::eBitDepthUShort : {
-  ImageScaler<unsigned short, 1, 65535> fred(*this);
-  setupAndProcess(fred, args);
-                            }                          
-                            break;
-
-case OFX::eBitDepthFloat : {
-  ImageScaler<float, 1, 1> fred(*this);
-  setupAndProcess(fred, args);
-                           }                          
-                           break;
-default :
-  OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  } 
+  // instantiate the render code based on the pixel depth and components of the dst clip
+  OFX::dispatchPixelType(dstClip_->getPixelDepth(), dstClip_->getPixelComponentCount(), *this, args);
 }
 
 // overridden is identity
@@ -657,6 +607,7 @@ void BasicExamplePluginFactory::describe(OFX::ImageEffectDescriptor& desc)
   // add supported pixel depths
   desc.addSupportedBitDepth(eBitDepthUByte);
   desc.addSupportedBitDepth(eBitDepthUShort);
+  desc.addSupportedBitDepth(eBitDepthHalf);
   desc.addSupportedBitDepth(eBitDepthFloat);
 
   // set a few flags
@@ -698,6 +649,10 @@ void BasicExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor& de
   ClipDescriptor *srcClip = desc.defineClip(kOfxImageEffectSimpleSourceClipName);
   srcClip->addSupportedComponent(ePixelComponentRGBA);
   srcClip->addSupportedComponent(ePixelComponentAlpha);
+  srcClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  srcClip->addSupportedComponent(ePixelComponentXY);
+#endif
   srcClip->setTemporalClipAccess(false);
   srcClip->setSupportsTiles(true);
   srcClip->setIsMask(false);
@@ -718,6 +673,10 @@ void BasicExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor& de
   ClipDescriptor *dstClip = desc.defineClip(kOfxImageEffectOutputClipName);
   dstClip->addSupportedComponent(ePixelComponentRGBA);
   dstClip->addSupportedComponent(ePixelComponentAlpha);
+  dstClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  dstClip->addSupportedComponent(ePixelComponentXY);
+#endif
   dstClip->setSupportsTiles(true);
 
   // make some pages and to things in 
@@ -78,42 +78,45 @@ public :
   {
     //eFieldLower only the spatially lower field is present
     //eFieldUpper only the spatially upper field is present
- 
+
+    // which component the field pins to max, and what a pixel is where there is no source
+    bool pinned[nComponents];
+    PIX blank[nComponents];
+    float scales[nComponents], offsets[nComponents];
+    for(int c = 0; c < nComponents; c++) {
+      pinned[c] = ((_field == OFX::eFieldLower) && (c==0)) || ((_field == OFX::eFieldUpper) && (c==2));
+      blank[c] = OFX::PixelKernels::PixelTraits<PIX>::fromFloat(pinned[c] ? float(max) : 0.0f);
+      scales[c] = -1.0f;
+      offsets[c] = float(max);
+    }
+    const PIX pin = OFX::PixelKernels::PixelTraits<PIX>::fromFloat(float(max));
+
+    OFX::ImageView<PIX, nComponents> dst(_dstImg), src(_srcImg);
     for(int y = procWindow.y1; y < procWindow.y2; y++) {
       if(_effect.abort()) break;
 
-      PIX *dstPix = (PIX *) _dstImg->getPixelAddress(procWindow.x1, y);
-
-      for(int x = procWindow.x1; x < procWindow.x2; x++) {
-
-        PIX *srcPix = (PIX *)  (_srcImg ? _srcImg->getPixelAddress(x, y) : 0);
-
-        // do we have a source image to scale up
-        if(srcPix) {
-          for(int c = 0; c < nComponents; c++) {
-            if((_field == OFX::eFieldLower) && (c==0))
-              dstPix[c] = max;
-            else if((_field == OFX::eFieldUpper) && (c==2))
-              dstPix[c] = max;
-            else
-              dstPix[c] = max - srcPix[c];
-          }
-        }
-        else {
-          // no src pixel here, be black and transparent
-          for(int c = 0; c < nComponents; c++) {
-            if((_field == OFX::eFieldLower) && (c==0))
-              dstPix[c] = max;
-            else if((_field == OFX::eFieldUpper) && (c==2))
-              dstPix[c] = max;
-            else
-              dstPix[c] = 0;
-          }
-        }
-
-        // increment the dst pixel
-        dstPix += nComponents;
-      }
+      PIX *dstPix = dst.getPixel(procWindow.x1, y);
+      OFX::RowSpan<PIX> srcRow = src.getRowSpan(y, procWindow.x1, procWindow.x2);
+
+      // no src pixel to the left of the source, be black and transparent
+      for(int x = procWindow.x1; x < srcRow.x1; x++, dstPix += nComponents)
+        for(int c = 0; c < nComponents; c++)
+          dstPix[c] = blank[c];
+
+      // invert the source, max - src, then pin the field's component, rather than a test per value
+      const int nValues = srcRow.size() * nComponents;
+      if(nValues > 0)
+        OFX::PixelKernels::scaleOffsetRow<PIX, nComponents>(srcRow.pixels, dstPix, srcRow.size(), scales, offsets);
+      for(int c = 0; c < nComponents; c++)
+        if(pinned[c])
+          for(int i = c; i < nValues; i += nComponents)
+            dstPix[i] = pin;
+      dstPix += nValues;
+
+      // and to the right of it
+      for(int x = srcRow.x2; x < procWindow.x2; x++, dstPix += nComponents)
+        for(int c = 0; c < nComponents; c++)
+          dstPix[c] = blank[c];
     }
   }
 };
@@ -142,6 +145,14 @@ public :
 
   /* set up and run a processor */
   void setupAndProcess(FieldBase &, const OFX::RenderArguments &args);
+
+  /* set up and run a processor for one pixel type, called back by OFX::dispatchPixelType */
+  template <class PIX, int nComponents, int maxValue>
+  void processPixels(const OFX::RenderArguments &args)
+  {
+    ImageFielder<PIX, nComponents, maxValue> fred(*this, args.fieldToRender);
+    setupAndProcess(fred, args);
+  }
 };
 
 
@@ -189,71 +200,11 @@ FieldPlugin::setupAndProcess(FieldBase &processor, const OFX::RenderArguments &a
 void
 FieldPlugin::render(const OFX::RenderArguments &args)
 {
-  // instantiate the render code based on the pixel depth of the dst clip
-  OFX::BitDepthEnum       dstBitDepth    = dstClip_->getPixelDepth();
-  OFX::PixelComponentEnum dstComponents  = dstClip_->getPixelComponents();
-
   double time = args.time;
   std::cout << "Rendering at time " << time << std::endl;
-  OFX::FieldEnum field = args.fieldToRender;
 
-  // do the rendering
-  if(dstComponents == OFX::ePixelComponentRGBA) 
-  {
-    switch(dstBitDepth) 
-    {
-    case OFX::eBitDepthUByte : 
-    {      
-      ImageFielder<unsigned char, 4, 255> fred(*this, field);
-      setupAndProcess(fred, args);
-    }
-    break;
-    
-    case OFX::eBitDepthUShort : 
-    {
-      ImageFielder<unsigned short, 4, 65535> fred(*this, field);
-      setupAndProcess(fred, args);
-    }                          
-    break;
-    
-    case OFX::eBitDepthFloat : 
-    {
-      ImageFielder<float, 4, 1> fred(*this, field);
-      setupAndProcess(fred, args);
-    }
-    break;
-    default :
-      OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  }
-  else 
-  {
-    switch(dstBitDepth) 
-    {
-    case OFX::eBitDepthUByte : 
-    {
-      ImageFielder<unsigned char, 1, 255> fred(*this, field);
-      setupAndProcess(fred, args);
-    }
-    break;
-      
-    case OFX::eBitDepthUShort : 
-    {
-      ImageFielder<unsigned short, 1, 65535> fred(*this, field);
-      setupAndProcess(fred, args);
-    }                          
-    break;
-      
-    case OFX::eBitDepthFloat : 
-    {
-      ImageFielder<float, 1, 1> fred(*this, field);
-      setupAndProcess(fred, args);
-    }                          
-    break;
-    default :
-      OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  } 
+  // instantiate the render code based on the pixel depth and components of the dst clip
+  OFX::dispatchPixelType(dstClip_->getPixelDepth(), dstClip_->getPixelComponentCount(), *this, args);
 }
 
 mDeclarePluginFactory(FieldExamplePluginFactory, {}, {});
@@ -271,6 +222,7 @@ void FieldExamplePluginFactory::describe(OFX::ImageEffectDescriptor &desc)
   // add supported pixel depths
   desc.addSupportedBitDepth(eBitDepthUByte);
   desc.addSupportedBitDepth(eBitDepthUShort);
+  desc.addSupportedBitDepth(eBitDepthHalf);
   desc.addSupportedBitDepth(eBitDepthFloat);
 
   // set a few flags
@@ -290,6 +242,10 @@ void FieldExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor &de
   ClipDescriptor *srcClip = desc.defineClip(kOfxImageEffectSimpleSourceClipName);
   srcClip->addSupportedComponent(ePixelComponentRGBA);
   srcClip->addSupportedComponent(ePixelComponentAlpha);
+  srcClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  srcClip->addSupportedComponent(ePixelComponentXY);
+#endif
   srcClip->setTemporalClipAccess(false);
   srcClip->setSupportsTiles(true);
   srcClip->setIsMask(false);
@@ -299,6 +255,10 @@ void FieldExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor &de
   ClipDescriptor *dstClip = desc.defineClip(kOfxImageEffectOutputClipName);
   dstClip->addSupportedComponent(ePixelComponentRGBA);
   dstClip->addSupportedComponent(ePixelComponentAlpha);
+  dstClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  dstClip->addSupportedComponent(ePixelComponentXY);
+#endif
   dstClip->setSupportsTiles(true);
 
 }
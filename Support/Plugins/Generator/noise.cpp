@@ -42,7 +42,7 @@ England
 
 #include "../include/ofxsProcessing.H"
 
-#include "randomGenerator.H"
+#include "counterRandomGenerator.H"
 
 ////////////////////////////////////////////////////////////////////////////////
 // base class for the noise
@@ -59,6 +59,8 @@ public :
     , _noiseLevel(0.5f)
     , _seed(0)
   {        
+    // the noise only depends on where a pixel is, so rows can be handed out in any order
+    setScheduling(OFX::eSchedulingDynamic);
   }
 
   /** @brief set the scale */
@@ -69,7 +71,7 @@ public :
 };
 
 /** @brief templated class to blend between two images */
-template <class PIX, int nComponents, int max>
+template <class PIX, int nComponents>
 class NoiseGenerator : public NoiseGeneratorBase {
 public :
   // ctor
@@ -80,29 +82,29 @@ public :
   // and do some processing
   void multiThreadProcessImages(const OfxRectI& procWindow, const OfxPointD& renderScale)
   {
-    float noiseLevel = _noiseLevel;
+    // the noise for a pixel is keyed on its position and the seed, so every tile and thread agrees on it
+    CounterRandomGenerator randy(_seed);
+    float scales[nComponents];
+    for(int c = 0; c < nComponents; c++)
+      scales[c] = _noiseLevel;
 
-    // set up a random number generator and set the seed
-    RandomGenerator randy(_seed + procWindow.y1);
+    // a run of random values, scaled by the noise level, before they are converted to our depth
+    const int kRunPixels = 1024;
+    float values[kRunPixels * nComponents];
 
     // push pixels
+    OFX::ImageView<PIX, nComponents> dst(_dstImg);
     for(int y = procWindow.y1; y < procWindow.y2; y++) {
       if(_effect.abort()) break;
 
-      PIX *dstPix = (PIX *) _dstImg->getPixelAddress(procWindow.x1, y);
+      PIX *dstPix = dst.getPixel(procWindow.x1, y);
 
-      for(int x = procWindow.x1; x < procWindow.x2; x++) {
-        for(int c = 0; c < nComponents; c++) {
-          // get the random value out of it, scale up by the pixel max level and the noise level
-          double randValue = max * noiseLevel * randy.random();
-
-          if(max == 1) // implies floating point, so don't clamp
-            dstPix[c] = PIX(randValue);
-          else {  // integer base one, clamp it
-            dstPix[c] = randValue < 0 ? 0 : (randValue > max ? max : PIX(randValue));
-          }
-        }
-        dstPix += nComponents;
+      for(int x = procWindow.x1; x < procWindow.x2; x += kRunPixels) {
+        const int n = (std::min)(kRunPixels, procWindow.x2 - x);
+        randy.randomRow(x, y, n, nComponents, values);
+        OFX::PixelKernels::scaleOffsetRow<float, nComponents>(values, values, n, scales, NULL);
+        OFX::PixelKernels::convertRow<float, PIX>(values, dstPix, n * nComponents);
+        dstPix += n * nComponents;
       }
     }
   }
@@ -118,6 +120,10 @@ protected :
 
   OFX::DoubleParam  *noise_;
 
+  // the noise level, fetched again only at a new time or after a param change, we are
+  // render instance safe so only one render at a time uses it
+  OFX::ParamSnapshot noiseValue_;
+
 public :
   /** @brief ctor */
   NoisePlugin(OfxImageEffectHandle handle)
@@ -127,6 +133,7 @@ public :
   {
     dstClip_ = fetchClip(kOfxImageEffectOutputClipName);
     noise_   = fetchDoubleParam("Noise");
+    noiseValue_.addParam(noise_);
   }
 
   /* Override the render */
@@ -138,6 +145,14 @@ public :
   /* set up and run a processor */
   void setupAndProcess(NoiseGeneratorBase &, const OFX::RenderArguments &args);
 
+  /* set up and run a processor for one pixel type, called back by OFX::dispatchPixelType */
+  template <class PIX, int nComponents, int maxValue>
+  void processPixels(const OFX::RenderArguments &args)
+  {
+    NoiseGenerator<PIX, nComponents> fred(*this);
+    setupAndProcess(fred, args);
+  }
+
   /** @brief The get RoD action.  We flag an infinite rod */
   bool getRegionOfDefinition(const OFX::RegionOfDefinitionArguments &args, OfxRectD &rod);
 };
@@ -166,7 +181,8 @@ NoisePlugin::setupAndProcess(NoiseGeneratorBase &processor, const OFX::RenderArg
   processor.setRenderWindow(args.renderWindow, args.renderScale);
 
   // set the scales
-  processor.setNoiseLevel((float)noise_->getValueAtTime(args.time));
+  fetchParamSnapshot(args.time, noiseValue_);
+  processor.setNoiseLevel((float)noiseValue_.getValue(noise_));
 
   // set the seed based on the current time, and double it we get difference seeds on different fields
   processor.setSeed(uint32_t(args.time * 2.0f + 2000.0f));
@@ -196,64 +212,8 @@ NoisePlugin::getRegionOfDefinition(const OFX::RegionOfDefinitionArguments &/*arg
 void
 NoisePlugin::render(const OFX::RenderArguments &args)
 {
-  // instantiate the render code based on the pixel depth of the dst clip
-  OFX::BitDepthEnum       dstBitDepth    = dstClip_->getPixelDepth();
-  OFX::PixelComponentEnum dstComponents  = dstClip_->getPixelComponents();
-
-  // do the rendering
-  if(dstComponents == OFX::ePixelComponentRGBA) {
-    switch(dstBitDepth) 
-    {
-    case OFX::eBitDepthUByte : {      
-      NoiseGenerator<unsigned char, 4, 255> fred(*this);
-      setupAndProcess(fred, args);
-                               }
-                               break;
-
-    case OFX::eBitDepthUShort : 
-      {
-        NoiseGenerator<unsigned short, 4, 65535> fred(*this);
-        setupAndProcess(fred, args);
-      }                          
-      break;
-
-    case OFX::eBitDepthFloat : 
-      {
-        NoiseGenerator<float, 4, 1> fred(*this);
-        setupAndProcess(fred, args);
-      }
-      break;
-    default :
-      OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  }
-  else {
-    switch(dstBitDepth) 
-    {
-    case OFX::eBitDepthUByte : 
-      {
-        NoiseGenerator<unsigned char, 1, 255> fred(*this);
-        setupAndProcess(fred, args);
-      }
-      break;
-
-    case OFX::eBitDepthUShort : 
-      {
-        NoiseGenerator<unsigned short, 1, 65535> fred(*this);
-        setupAndProcess(fred, args);
-      }                          
-      break;
-
-    case OFX::eBitDepthFloat : 
-      {
-        NoiseGenerator<float, 1, 1> fred(*this);
-        setupAndProcess(fred, args);
-      }                          
-      break;
-    default :
-      OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  } 
+  // instantiate the render code based on the pixel depth and components of the dst clip
+  OFX::dispatchPixelType(dstClip_->getPixelDepth(), dstClip_->getPixelComponentCount(), *this, args);
 }
 
 mDeclarePluginFactory(NoiseExamplePluginFactory, {}, {});
@@ -268,6 +228,7 @@ void NoiseExamplePluginFactory::describe(OFX::ImageEffectDescriptor &desc)
   desc.addSupportedContext(eContextGeneral);
   desc.addSupportedBitDepth(eBitDepthUByte);
   desc.addSupportedBitDepth(eBitDepthUShort);
+  desc.addSupportedBitDepth(eBitDepthHalf);
   desc.addSupportedBitDepth(eBitDepthFloat);
   desc.setSingleInstance(false);
   desc.setHostFrameThreading(false);
@@ -285,12 +246,20 @@ void NoiseExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor &de
   ClipDescriptor* srcClip = desc.defineClip( kOfxImageEffectSimpleSourceClipName );
   srcClip->addSupportedComponent( OFX::ePixelComponentRGBA );
   srcClip->addSupportedComponent( OFX::ePixelComponentAlpha );
+  srcClip->addSupportedComponent( OFX::ePixelComponentRGB );
+#ifdef OFX_EXTENSIONS_NATRON
+  srcClip->addSupportedComponent( OFX::ePixelComponentXY );
+#endif
   srcClip->setSupportsTiles(true);
   srcClip->setOptional(true);
 
   ClipDescriptor *dstClip = desc.defineClip(kOfxImageEffectOutputClipName);
   dstClip->addSupportedComponent(ePixelComponentRGBA);
   dstClip->addSupportedComponent(ePixelComponentAlpha);
+  dstClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  dstClip->addSupportedComponent(ePixelComponentXY);
+#endif
   dstClip->setSupportsTiles(true);
   dstClip->setFieldExtraction(eFieldExtractSingle);
   DoubleParamDescriptor *param = desc.defineDoubleParam("Noise");
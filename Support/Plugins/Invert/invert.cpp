@@ -44,6 +44,7 @@ England
 #include "ofxsMultiThread.h"
 
 #include "../include/ofxsProcessing.H"
+#include "../include/ofxsPixelKernels.H"
 
 
 // Base class for the RGBA and the Alpha processor
@@ -56,6 +57,8 @@ public :
     : OFX::ImageProcessor(instance)
     , _srcImg(NULL)
   {        
+    // each pixel only depends on the one under it, so rows can be handed out in any order
+    setScheduling(OFX::eSchedulingDynamic);
   }
 
   /** @brief set the src image */
@@ -74,30 +77,35 @@ public :
   // and do some processing
   void multiThreadProcessImages(const OfxRectI& procWindow, const OfxPointD& renderScale)
   {
+    // max - src, as a scale and offset
+    float scales[nComponents], offsets[nComponents];
+    for(int c = 0; c < nComponents; c++) {
+      scales[c] = -1.0f;
+      offsets[c] = float(max);
+    }
+
+    OFX::ImageView<PIX, nComponents> dst(_dstImg), src(_srcImg);
     for(int y = procWindow.y1; y < procWindow.y2; y++) {
       if(_effect.abort()) break;
 
-      PIX *dstPix = (PIX *) _dstImg->getPixelAddress(procWindow.x1, y);
-
-      for(int x = procWindow.x1; x < procWindow.x2; x++) {
+      PIX *dstPix = dst.getPixel(procWindow.x1, y);
 
-        PIX *srcPix = (PIX *)  (_srcImg ? _srcImg->getPixelAddress(x, y) : 0);
+      for(int x = procWindow.x1; x < procWindow.x2; ) {
+        int x2 = procWindow.x2;
+        const PIX *srcPix = src.getRun(x, y, &x2);
 
         // do we have a source image to scale up
         if(srcPix) {
-          for(int c = 0; c < nComponents; c++) {
-            dstPix[c] = max - srcPix[c];
-          }
+          OFX::PixelKernels::scaleOffsetRow<PIX, nComponents>(srcPix, dstPix, x2 - x, scales, offsets);
         }
         else {
           // no src pixel here, be black and transparent
-          for(int c = 0; c < nComponents; c++) {
-            dstPix[c] = 0;
-          }
+          memset(dstPix, 0, (x2 - x) * nComponents * sizeof(PIX));
         }
 
         // increment the dst pixel
-        dstPix += nComponents;
+        dstPix += (x2 - x) * nComponents;
+        x = x2;
       }
     }
   }
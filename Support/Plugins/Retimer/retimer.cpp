@@ -62,6 +62,8 @@ protected :
     OFX::DoubleParam  *speed_;      /**< @brief only used in the filter context. */
     OFX::DoubleParam  *duration_;   /**< @brief how long the output should be as a proportion of input. General context only  */
 
+    OFX::ParamSnapshot sourceTimeValue_; /**< @brief sourceTime_, fetched again only at a new time or after a param change. We are render instance safe, so only one render at a time uses it. */
+
 public :
     /** @brief ctor */
     RetimerPlugin(OfxImageEffectHandle handle)
@@ -76,9 +78,11 @@ public :
         srcClip_ = fetchClip(kOfxImageEffectSimpleSourceClipName);
 
         // What parameters we instantiate depend on the context
-        if(getContext() == OFX::eContextRetimer)
+        if(getContext() == OFX::eContextRetimer) {
             // fetch the mandated parameter which the host uses to pass us the frame to retime to
             sourceTime_   = fetchDoubleParam(kOfxImageEffectRetimerParamName);
+            sourceTimeValue_.addParam(sourceTime_);
+        }
         else // context == OFX::eContextFilter || context == OFX::eContextGeneral
             // filter context means we are in charge of how to retime, and our example is using a speed curve to do that
             speed_   = fetchDoubleParam("Speed");
@@ -100,6 +104,14 @@ public :
     /* set up and run a processor */
     void
     setupAndProcess(OFX::ImageBlenderBase &, const OFX::RenderArguments &args);
+
+    /* set up and run a processor for one pixel type, called back by OFX::dispatchPixelType */
+    template <class PIX, int nComponents, int maxValue>
+    void processPixels(const OFX::RenderArguments &args)
+    {
+        OFX::ImageBlender<PIX, nComponents> fred(*this);
+        setupAndProcess(fred, args);
+    }
 };
 
 
@@ -170,7 +182,8 @@ RetimerPlugin::setupAndProcess(OFX::ImageBlenderBase &processor, const OFX::Rend
     
     if(getContext() == OFX::eContextRetimer) {
         // the host is specifying it, so fetch it from the kOfxImageEffectRetimerParamName pseudo-param
-        sourceTime = sourceTime_->getValueAtTime(args.time);
+        fetchParamSnapshot(args.time, sourceTimeValue_);
+        sourceTime = sourceTimeValue_.getValue(sourceTime_);
     }
     else {
         // we have our own param, which is a speed, so we integrate it to get the time we want
@@ -246,57 +259,8 @@ RetimerPlugin::getTimeDomain(OfxRangeD &range)
 void
 RetimerPlugin::render(const OFX::RenderArguments &args)
 {
-    // instantiate the render code based on the pixel depth of the dst clip
-    OFX::BitDepthEnum       dstBitDepth    = dstClip_->getPixelDepth();
-    OFX::PixelComponentEnum dstComponents  = dstClip_->getPixelComponents();
-
-    // do the rendering
-    if(dstComponents == OFX::ePixelComponentRGBA) {
-        switch(dstBitDepth) {
-        case OFX::eBitDepthUByte : {      
-            OFX::ImageBlender<unsigned char, 4> fred(*this);
-            setupAndProcess(fred, args);
-        }
-        break;
-
-        case OFX::eBitDepthUShort : {
-            OFX::ImageBlender<unsigned short, 4> fred(*this);
-            setupAndProcess(fred, args);
-        }                          
-        break;
-
-        case OFX::eBitDepthFloat : {
-            OFX::ImageBlender<float, 4> fred(*this);
-            setupAndProcess(fred, args);
-        }
-        break;
-        default :
-            OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-        }
-    }
-    else {
-        switch(dstBitDepth) {
-        case OFX::eBitDepthUByte : {
-            OFX::ImageBlender<unsigned char, 1> fred(*this);
-            setupAndProcess(fred, args);
-        }
-        break;
-
-        case OFX::eBitDepthUShort : {
-            OFX::ImageBlender<unsigned short, 1> fred(*this);
-            setupAndProcess(fred, args);
-        }                          
-        break;
-
-        case OFX::eBitDepthFloat : {
-            OFX::ImageBlender<float, 1> fred(*this);
-            setupAndProcess(fred, args);
-        }                          
-        break;
-        default :
-            OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-        }
-    } // switch
+    // instantiate the render code based on the pixel depth and components of the dst clip
+    OFX::dispatchPixelType(dstClip_->getPixelDepth(), dstClip_->getPixelComponentCount(), *this, args);
 }
 
 using namespace OFX;
@@ -328,6 +292,7 @@ void RetimerExamplePluginFactory::describe(OFX::ImageEffectDescriptor &desc)
   // Add supported pixel depths
   desc.addSupportedBitDepth(eBitDepthUByte);
   desc.addSupportedBitDepth(eBitDepthUShort);
+  desc.addSupportedBitDepth(eBitDepthHalf);
   desc.addSupportedBitDepth(eBitDepthFloat);
 
   // set a few flags
@@ -347,6 +312,10 @@ void RetimerExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor &
   ClipDescriptor *srcClip = desc.defineClip(kOfxImageEffectSimpleSourceClipName);
   srcClip->addSupportedComponent(ePixelComponentRGBA);
   srcClip->addSupportedComponent(ePixelComponentAlpha);
+  srcClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  srcClip->addSupportedComponent(ePixelComponentXY);
+#endif
   srcClip->setTemporalClipAccess(true); // say we will be doing random time access on this clip
   srcClip->setSupportsTiles(true);
   srcClip->setFieldExtraction(eFieldExtractDoubled); // which is the default anyway
@@ -355,6 +324,10 @@ void RetimerExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor &
   ClipDescriptor *dstClip = desc.defineClip(kOfxImageEffectOutputClipName);
   dstClip->addSupportedComponent(ePixelComponentRGBA);
   dstClip->addSupportedComponent(ePixelComponentAlpha);
+  dstClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  dstClip->addSupportedComponent(ePixelComponentXY);
+#endif
   dstClip->setFieldExtraction(eFieldExtractDoubled); // which is the default anyway
   dstClip->setSupportsTiles(true);
 
@@ -0,0 +1,203 @@
+/*
+  OFX Support Library, a library that skins the OFX plug-in API with C++ classes.
+  Copyright (C) 2005 The Open Effects Association Ltd
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name The Open Effects Association Ltd, nor the names of its 
+      contributors may be used to endorse or promote products derived from this
+      software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The Open Effects Association Ltd
+1 Wardour St
+London W1D 6PA
+England
+
+
+*/
+
+/*
+  Checks the depth conversions of ofxsPixelKernels.H on every instruction set the CPU has.
+
+  - all 65536 halfs convert to the same floats on every path, and back to themselves,
+    NaNs coming back quieted
+  - float to half gives the same halfs as the scalar path on every path, over every
+    float bit pattern, or every step'th one
+  - bytes round trip exactly through float, half and short, and bytes widen to shorts
+    as v * 257
+  - shorts round trip exactly through float, and through half to within the half's
+    precision, 16 at the top of the range
+
+  Prints what failed, and exits non zero if anything did.
+
+  Usage : conversionTest [step]
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ofxsPixelKernels.H"
+
+using namespace OFX::PixelKernels;
+
+static const char *gSetNames[] = {"scalar", "SSE2", "AVX2"};
+
+/** @brief number of failed checks */
+static int gNFailed = 0;
+
+static void check(bool ok, const char *what, int set)
+{
+  if(!ok) {
+    printf("FAILED %s (%s)\n", what, gSetNames[set]);
+    ++gNFailed;
+  }
+}
+
+/** @brief the instruction sets this CPU has, the scalar one first */
+static std::vector<InstructionSetEnum> getInstructionSets(void)
+{
+  std::vector<InstructionSetEnum> sets;
+  for(int set = eInstructionSetScalar; set <= eInstructionSetAVX2; ++set)
+    if(setInstructionSet((InstructionSetEnum) set) == set)
+      sets.push_back((InstructionSetEnum) set);
+  return sets;
+}
+
+/** @brief every half to float and back */
+static void checkHalfs(const std::vector<InstructionSetEnum> &sets)
+{
+  std::vector<Half> halfs(65536), back(65536);
+  for(int i = 0; i < 65536; ++i)
+    halfs[i].bits = (unsigned short) i;
+
+  std::vector<float> scalarFloats(65536), floats(65536);
+  setInstructionSet(eInstructionSetScalar);
+  convertRow<Half, float>(&halfs[0], &scalarFloats[0], 65536);
+
+  for(size_t s = 0; s < sets.size(); ++s) {
+    setInstructionSet(sets[s]);
+    convertRow<Half, float>(&halfs[0], &floats[0], 65536);
+    check(memcmp(&floats[0], &scalarFloats[0], 65536 * sizeof(float)) == 0, "halfs give the scalar path's floats", sets[s]);
+
+    convertRow<float, Half>(&floats[0], &back[0], 65536);
+    bool same = true;
+    for(int i = 0; i < 65536; ++i) {
+      bool isNaN = (i & 0x7c00) == 0x7c00 && (i & 0x3ff) != 0;
+      same = same && back[i].bits == (isNaN ? (i | 0x200) : i);
+    }
+    check(same, "half to float to half is exact", sets[s]);
+  }
+}
+
+/** @brief float to half against the scalar path, over every step'th float bit pattern */
+static void checkFloatsToHalfs(const std::vector<InstructionSetEnum> &sets, unsigned int step)
+{
+  const int kBatch = 1 << 20;
+  std::vector<float> floats(kBatch);
+  std::vector<Half> scalarHalfs(kBatch), halfs(kBatch);
+  std::vector<bool> same(sets.size(), true);
+
+  unsigned long long pattern = 0;
+  while(pattern < (1ull << 32)) {
+    int n = 0;
+    for(; n < kBatch && pattern < (1ull << 32); ++n, pattern += step) {
+      unsigned int bits = (unsigned int) pattern;
+      memcpy(&floats[n], &bits, sizeof(float));
+    }
+    setInstructionSet(eInstructionSetScalar);
+    convertRow<float, Half>(&floats[0], &scalarHalfs[0], n);
+    for(size_t s = 1; s < sets.size(); ++s) {
+      setInstructionSet(sets[s]);
+      convertRow<float, Half>(&floats[0], &halfs[0], n);
+      same[s] = same[s] && memcmp(&halfs[0], &scalarHalfs[0], n * sizeof(Half)) == 0;
+    }
+  }
+  for(size_t s = 1; s < sets.size(); ++s)
+    check(same[s], "floats give the scalar path's halfs", sets[s]);
+}
+
+/** @brief src to MID and back, true if it comes back unchanged */
+template <class PIX, class MID>
+static bool roundTrips(const std::vector<PIX> &src)
+{
+  std::vector<MID> mid(src.size());
+  std::vector<PIX> back(src.size());
+  convertRow<PIX, MID>(&src[0], &mid[0], (int) src.size());
+  convertRow<MID, PIX>(&mid[0], &back[0], (int) src.size());
+  return back == src;
+}
+
+/** @brief bytes and shorts through the other depths */
+static void checkIntegers(const std::vector<InstructionSetEnum> &sets)
+{
+  std::vector<unsigned char> bytes(256);
+  for(int i = 0; i < 256; ++i)
+    bytes[i] = (unsigned char) i;
+  std::vector<unsigned short> shorts(65536), widened(256), back(65536);
+  for(int i = 0; i < 65536; ++i)
+    shorts[i] = (unsigned short) i;
+  std::vector<Half> halfs(65536);
+
+  for(size_t s = 0; s < sets.size(); ++s) {
+    setInstructionSet(sets[s]);
+    check(roundTrips<unsigned char, float>(bytes), "bytes round trip through float", sets[s]);
+    check(roundTrips<unsigned char, Half>(bytes), "bytes round trip through half", sets[s]);
+    check(roundTrips<unsigned char, unsigned short>(bytes), "bytes round trip through short", sets[s]);
+
+    convertRow<unsigned char, unsigned short>(&bytes[0], &widened[0], 256);
+    bool exact = true;
+    for(int i = 0; i < 256; ++i)
+      exact = exact && widened[i] == i * 257;
+    check(exact, "bytes widen to shorts as v * 257", sets[s]);
+
+    check(roundTrips<unsigned short, float>(shorts), "shorts round trip through float", sets[s]);
+
+    // a half keeps 11 significant bits, so in [0.5, 1] it steps by 2^-11, 32 shorts
+    convertRow<unsigned short, Half>(&shorts[0], &halfs[0], 65536);
+    convertRow<Half, unsigned short>(&halfs[0], &back[0], 65536);
+    int maxError = 0;
+    for(int i = 0; i < 65536; ++i)
+      maxError = std::max(maxError, abs(int(back[i]) - i));
+    check(maxError <= 16, "shorts round trip through half to within 16", sets[s]);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int step = argc > 1 ? (unsigned int) atoi(argv[1]) : 1;
+  if(step < 1)
+    step = 1;
+
+  std::vector<InstructionSetEnum> sets = getInstructionSets();
+  printf("instruction sets :");
+  for(size_t s = 0; s < sets.size(); ++s)
+    printf(" %s", gSetNames[sets[s]]);
+  printf("\n");
+
+  checkHalfs(sets);
+  checkFloatsToHalfs(sets, step);
+  checkIntegers(sets);
+
+  printf("%s\n", gNFailed ? "FAILED" : "passed");
+  return gNFailed ? 1 : 0;
+}
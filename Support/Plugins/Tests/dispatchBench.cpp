@@ -0,0 +1,145 @@
+/*
+  OFX Support Library, a library that skins the OFX plug-in API with C++ classes.
+  Copyright (C) 2005 The Open Effects Association Ltd
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name The Open Effects Association Ltd, nor the names of its 
+      contributors may be used to endorse or promote products derived from this
+      software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The Open Effects Association Ltd
+1 Wardour St
+London W1D 6PA
+England
+
+
+*/
+
+/*
+  Times how the Support library's main entry point finds the action it is called with.
+
+  The library used to copy the action name into a std::string and compare it with each
+  action it handles in turn. It now maps the name to an enum with mapToActionEnum. This
+  times both over the actions a host calls most, with the names passed as the host's
+  own copies, as a host does not pass our addresses, after checking that both find the
+  same action for every name.
+
+  Usage : dispatchBench [iterations]
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "ofxsSupportPrivate.h"
+
+using namespace OFX::Private;
+
+/** @brief the actions in the order of the ActionEnum values that follow eActionUnknown */
+static const char *gActionNames[] = {
+  kOfxActionLoad,
+  kOfxActionUnload,
+  kOfxActionDescribe,
+  kOfxImageEffectActionDescribeInContext,
+  kOfxActionCreateInstance,
+  kOfxActionDestroyInstance,
+  kOfxImageEffectActionRender,
+  kOfxImageEffectActionBeginSequenceRender,
+  kOfxImageEffectActionEndSequenceRender,
+  kOfxImageEffectActionIsIdentity,
+  kOfxImageEffectActionGetRegionOfDefinition,
+  kOfxImageEffectActionGetRegionsOfInterest,
+  kOfxImageEffectActionGetFramesNeeded,
+  kOfxImageEffectActionGetClipPreferences,
+  kOfxActionPurgeCaches,
+  kOfxActionSyncPrivateData,
+  kOfxImageEffectActionGetTimeDomain,
+  kOfxActionBeginInstanceChanged,
+  kOfxActionInstanceChanged,
+  kOfxActionEndInstanceChanged,
+  kOfxActionBeginInstanceEdit,
+  kOfxActionEndInstanceEdit
+};
+static const int gNActions = (int) (sizeof(gActionNames) / sizeof(gActionNames[0]));
+
+/** @brief the way the main entry point used to find the action, a string and a chain of compares */
+static int findByCompares(const char *actionRaw)
+{
+  std::string action(actionRaw);
+  for(int i = 0; i < gNActions; ++i)
+    if(action == gActionNames[i])
+      return i + 1;
+  return eActionUnknown;
+}
+
+/** @brief keeps the results from being optimised away */
+static volatile long gSink;
+
+int main(int argc, char **argv)
+{
+  const int nIterations = argc > 1 ? atoi(argv[1]) : 4000000;
+
+  // the host passes its own copies of the names
+  std::vector<char *> hostNames;
+  for(int i = 0; i < gNActions; ++i)
+    hostNames.push_back(strdup(gActionNames[i]));
+
+  int nBad = 0;
+  for(int i = 0; i < gNActions; ++i) {
+    if(mapToActionEnum(hostNames[i]) != (ActionEnum) (i + 1) || findByCompares(hostNames[i]) != i + 1) {
+      printf("%s is not found\n", gActionNames[i]);
+      ++nBad;
+    }
+  }
+  if(mapToActionEnum("OfxActionNotOne") != eActionUnknown || mapToActionEnum(NULL) != eActionUnknown) {
+    printf("an unknown action is found\n");
+    ++nBad;
+  }
+  if(nBad)
+    return 1;
+
+  // render, is identity, region of definition, regions of interest and instance changed
+  const char *hot[] = {hostNames[6], hostNames[9], hostNames[10], hostNames[11], hostNames[18]};
+  const int nHot = (int) (sizeof(hot) / sizeof(hot[0]));
+
+  long sink = 0;
+  for(int pass = 0; pass < 2; ++pass) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < nIterations; ++i)
+      sink += findByCompares(hot[i % nHot]);
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for(int i = 0; i < nIterations; ++i)
+      sink += mapToActionEnum(hot[i % nHot]);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    printf("string compares %.1f ns/call, enum lookup %.1f ns/call\n",
+           std::chrono::duration<double, std::nano>(middle - start).count() / nIterations,
+           std::chrono::duration<double, std::nano>(end - middle).count() / nIterations);
+  }
+  gSink = sink;
+
+  for(int i = 0; i < gNActions; ++i)
+    free(hostNames[i]);
+  return 0;
+}
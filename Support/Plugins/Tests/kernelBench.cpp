@@ -0,0 +1,227 @@
+/*
+  OFX Support Library, a library that skins the OFX plug-in API with C++ classes.
+  Copyright (C) 2005 The Open Effects Association Ltd
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name The Open Effects Association Ltd, nor the names of its 
+      contributors may be used to endorse or promote products derived from this
+      software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The Open Effects Association Ltd
+1 Wardour St
+London W1D 6PA
+England
+
+
+*/
+
+/*
+  Times the row kernels of ofxsPixelKernels.H against the per pixel loops the example
+  processors used before them, on a 1920x1080 frame with one thread.
+
+  The loops fetch each pixel through an out of line address function, as the processors
+  did through OFX::Image::getPixelAddress, and the kernels work a row at a time. Each
+  kernel is timed with every instruction set the CPU has, after checking that its output
+  is the same as the loop's.
+
+  Usage : kernelBench
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include "ofxsPixelKernels.H"
+
+using namespace OFX::PixelKernels;
+
+/** @brief stands in for OFX::Image, whose getPixelAddress is in the library and not inlined */
+struct Frame {
+  int   width, height, pixelBytes;
+  char *data;
+
+#if defined(__GNUC__) || defined(__clang__)
+  __attribute__((noinline))
+#endif
+  void *getPixelAddress(int x, int y)
+  {
+    if(x < 0 || x >= width || y < 0 || y >= height)
+      return 0;
+    return data + ((size_t) y * width + x) * pixelBytes;
+  }
+};
+
+template <class PIX, int nComponents>
+Frame makeFrame(std::vector<PIX> &pixels, int width, int height)
+{
+  Frame frame = {width, height, nComponents * (int) sizeof(PIX), (char *) &pixels[0]};
+  return frame;
+}
+
+/** @brief the loop of OFX::ImageBlender */
+template <class PIX, int nComponents>
+void blendLoop(Frame &from, Frame &to, Frame &dst, float blend)
+{
+  for(int y = 0; y < dst.height; ++y) {
+    PIX *dstPix = (PIX *) dst.getPixelAddress(0, y);
+    for(int x = 0; x < dst.width; ++x) {
+      PIX *fromPix = (PIX *) from.getPixelAddress(x, y);
+      PIX *toPix = (PIX *) to.getPixelAddress(x, y);
+      for(int c = 0; c < nComponents; ++c)
+        dstPix[c] = PIX((toPix[c] - fromPix[c]) * blend + fromPix[c]);
+      dstPix += nComponents;
+    }
+  }
+}
+
+template <class PIX, int nComponents>
+void blendKernel(Frame &from, Frame &to, Frame &dst, float blend)
+{
+  for(int y = 0; y < dst.height; ++y)
+    blendRow<PIX, nComponents>((PIX *) from.getPixelAddress(0, y), (PIX *) to.getPixelAddress(0, y),
+                               (PIX *) dst.getPixelAddress(0, y), dst.width, blend);
+}
+
+/** @brief the loop of the Basic example's scaler */
+template <class PIX, int nComponents, int maxValue>
+void scaleLoop(Frame &src, Frame &dst, const float *scales)
+{
+  for(int y = 0; y < dst.height; ++y) {
+    PIX *dstPix = (PIX *) dst.getPixelAddress(0, y);
+    for(int x = 0; x < dst.width; ++x) {
+      PIX *srcPix = (PIX *) src.getPixelAddress(x, y);
+      for(int c = 0; c < nComponents; ++c) {
+        float v = srcPix[c] * scales[c];
+        if(maxValue != 1)
+          v = std::min(std::max(v, 0.f), float(maxValue));
+        dstPix[c] = PIX(v);
+      }
+      dstPix += nComponents;
+    }
+  }
+}
+
+template <class PIX, int nComponents>
+void scaleKernel(Frame &src, Frame &dst, const float *scales)
+{
+  for(int y = 0; y < dst.height; ++y)
+    scaleOffsetRow<PIX, nComponents>((PIX *) src.getPixelAddress(0, y), (PIX *) dst.getPixelAddress(0, y), dst.width, scales, NULL);
+}
+
+/** @brief the loop of the Invert example */
+template <class PIX, int nComponents, int maxValue>
+void invertLoop(Frame &src, Frame &dst)
+{
+  for(int y = 0; y < dst.height; ++y) {
+    PIX *dstPix = (PIX *) dst.getPixelAddress(0, y);
+    for(int x = 0; x < dst.width; ++x) {
+      PIX *srcPix = (PIX *) src.getPixelAddress(x, y);
+      for(int c = 0; c < nComponents; ++c)
+        dstPix[c] = PIX(maxValue - srcPix[c]);
+      dstPix += nComponents;
+    }
+  }
+}
+
+template <class PIX, int nComponents, int maxValue>
+void invertKernel(Frame &src, Frame &dst)
+{
+  const float scales[4] = {-1.f, -1.f, -1.f, -1.f};
+  const float offsets[4] = {float(maxValue), float(maxValue), float(maxValue), float(maxValue)};
+  for(int y = 0; y < dst.height; ++y)
+    scaleOffsetRow<PIX, nComponents>((PIX *) src.getPixelAddress(0, y), (PIX *) dst.getPixelAddress(0, y), dst.width, scales, offsets);
+}
+
+/** @brief the best of five runs of f, in ms */
+template <class F>
+double bestTime(F f)
+{
+  f();
+  double best = 1e30;
+  for(int run = 0; run < 5; ++run) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best;
+}
+
+/** @brief time the loops and the kernels on one pixel type, false if the kernels differ from the loops */
+template <class PIX, int nComponents, int maxValue>
+bool bench(const char *name)
+{
+  const int width = 1920, height = 1080;
+  std::vector<PIX> a(width * height * nComponents), b(a.size()), loopOut(a.size()), kernelOut(a.size());
+  for(size_t i = 0; i < a.size(); ++i) {
+    a[i] = PIX(maxValue == 1 ? (rand() % 1000) / 999.f : rand() % (maxValue + 1));
+    b[i] = PIX(maxValue == 1 ? (rand() % 1000) / 999.f : rand() % (maxValue + 1));
+  }
+  Frame A = makeFrame<PIX, nComponents>(a, width, height);
+  Frame B = makeFrame<PIX, nComponents>(b, width, height);
+  Frame L = makeFrame<PIX, nComponents>(loopOut, width, height);
+  Frame K = makeFrame<PIX, nComponents>(kernelOut, width, height);
+  const float scales[4] = {0.8f, 1.3f, 0.5f, 1.f};
+  const float blend = 0.3f;
+
+  printf("%s %dx%d, ms per frame, one thread\n", name, width, height);
+  printf("  %-14s blend %6.2f  scale %6.2f  invert %6.2f\n", "loops",
+         bestTime([&] { blendLoop<PIX, nComponents>(A, B, L, blend); }),
+         bestTime([&] { scaleLoop<PIX, nComponents, maxValue>(A, L, scales); }),
+         bestTime([&] { invertLoop<PIX, nComponents, maxValue>(A, L); }));
+
+  static const char *setNames[] = {"scalar", "SSE2", "AVX2"};
+  bool same = true;
+  for(int set = eInstructionSetScalar; set <= eInstructionSetAVX2; ++set) {
+    if(setInstructionSet((InstructionSetEnum) set) != set)
+      break;
+
+    bool setSame = true;
+    blendLoop<PIX, nComponents>(A, B, L, blend);
+    blendKernel<PIX, nComponents>(A, B, K, blend);
+    setSame = setSame && loopOut == kernelOut;
+    scaleLoop<PIX, nComponents, maxValue>(A, L, scales);
+    scaleKernel<PIX, nComponents>(A, K, scales);
+    setSame = setSame && loopOut == kernelOut;
+    invertLoop<PIX, nComponents, maxValue>(A, L);
+    invertKernel<PIX, nComponents, maxValue>(A, K);
+    setSame = setSame && loopOut == kernelOut;
+
+    printf("  kernels %-6s blend %6.2f  scale %6.2f  invert %6.2f  %s\n", setNames[set],
+           bestTime([&] { blendKernel<PIX, nComponents>(A, B, K, blend); }),
+           bestTime([&] { scaleKernel<PIX, nComponents>(A, K, scales); }),
+           bestTime([&] { invertKernel<PIX, nComponents, maxValue>(A, K); }),
+           setSame ? "same output" : "DIFFERENT OUTPUT");
+    same = same && setSame;
+  }
+  setInstructionSet(eInstructionSetAVX2);
+  return same;
+}
+
+int main(void)
+{
+  bool same = bench<unsigned char, 4, 255>("8 bit RGBA");
+  same = bench<unsigned short, 4, 65535>("16 bit RGBA") && same;
+  same = bench<float, 4, 1>("float RGBA") && same;
+  same = bench<unsigned char, 1, 255>("8 bit A") && same;
+  return same ? 0 : 1;
+}
@@ -81,6 +81,14 @@ public :
   /* set up and run a processor */
   void
     setupAndProcess(OFX::ImageBlenderBase &, const OFX::RenderArguments &args);
+
+  /* set up and run a processor for one pixel type, called back by OFX::dispatchPixelType */
+  template <class PIX, int nComponents, int maxValue>
+  void processPixels(const OFX::RenderArguments &args)
+  {
+    OFX::ImageBlender<PIX, nComponents> fred(*this);
+    setupAndProcess(fred, args);
+  }
 };
 
 
@@ -143,57 +151,8 @@ CrossFadePlugin::setupAndProcess(OFX::ImageBlenderBase &processor, const OFX::Re
 void
 CrossFadePlugin::render(const OFX::RenderArguments &args)
 {
-  // instantiate the render code based on the pixel depth of the dst clip
-  OFX::BitDepthEnum       dstBitDepth    = dstClip_->getPixelDepth();
-  OFX::PixelComponentEnum dstComponents  = dstClip_->getPixelComponents();
-
-  // do the rendering
-  if(dstComponents == OFX::ePixelComponentRGBA) {
-    switch(dstBitDepth) {
-case OFX::eBitDepthUByte : {      
-  OFX::ImageBlender<unsigned char, 4> fred(*this);
-  setupAndProcess(fred, args);
-                           }
-                           break;
-
-case OFX::eBitDepthUShort : {
-  OFX::ImageBlender<unsigned short, 4> fred(*this);
-  setupAndProcess(fred, args);
-                            }                          
-                            break;
-
-case OFX::eBitDepthFloat : {
-  OFX::ImageBlender<float, 4> fred(*this);
-  setupAndProcess(fred, args);
-                           }
-                           break;
-default :
-  OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  }
-  else {
-    switch(dstBitDepth) {
-case OFX::eBitDepthUByte : {
-  OFX::ImageBlender<unsigned char, 1> fred(*this);
-  setupAndProcess(fred, args);
-                           }
-                           break;
-
-case OFX::eBitDepthUShort : {
-  OFX::ImageBlender<unsigned short, 1> fred(*this);
-  setupAndProcess(fred, args);
-                            }                          
-                            break;
-
-case OFX::eBitDepthFloat : {
-  OFX::ImageBlender<float, 1> fred(*this);
-  setupAndProcess(fred, args);
-                           }                          
-                           break;
-default :
-  OFX::throwSuiteStatusException(kOfxStatErrUnsupported);
-    }
-  } // switch
+  // instantiate the render code based on the pixel depth and components of the dst clip
+  OFX::dispatchPixelType(dstClip_->getPixelDepth(), dstClip_->getPixelComponentCount(), *this, args);
 }
 
 // overridden is identity
@@ -243,6 +202,7 @@ void CrossFadeExamplePluginFactory::describe(OFX::ImageEffectDescriptor &desc)
   // Add supported pixel depths
   desc.addSupportedBitDepth(eBitDepthUByte);
   desc.addSupportedBitDepth(eBitDepthUShort);
+  desc.addSupportedBitDepth(eBitDepthHalf);
   desc.addSupportedBitDepth(eBitDepthFloat);
 
   // set a few flags
@@ -262,6 +222,10 @@ void CrossFadeExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor
   ClipDescriptor *fromClip = desc.defineClip(kOfxImageEffectTransitionSourceFromClipName);
   fromClip->addSupportedComponent(ePixelComponentRGBA);
   fromClip->addSupportedComponent(ePixelComponentAlpha);
+  fromClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  fromClip->addSupportedComponent(ePixelComponentXY);
+#endif
   fromClip->setTemporalClipAccess(false);
   fromClip->setSupportsTiles(true);
 
@@ -269,6 +233,10 @@ void CrossFadeExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor
   ClipDescriptor *toClip = desc.defineClip(kOfxImageEffectTransitionSourceToClipName);
   toClip->addSupportedComponent(ePixelComponentRGBA);
   toClip->addSupportedComponent(ePixelComponentAlpha);
+  toClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  toClip->addSupportedComponent(ePixelComponentXY);
+#endif
   toClip->setTemporalClipAccess(false);
   toClip->setSupportsTiles(true);
 
@@ -276,6 +244,10 @@ void CrossFadeExamplePluginFactory::describeInContext(OFX::ImageEffectDescriptor
   ClipDescriptor *dstClip = desc.defineClip(kOfxImageEffectOutputClipName);
   dstClip->addSupportedComponent(ePixelComponentRGBA);
   dstClip->addSupportedComponent(ePixelComponentAlpha);
+  dstClip->addSupportedComponent(ePixelComponentRGB);
+#ifdef OFX_EXTENSIONS_NATRON
+  dstClip->addSupportedComponent(ePixelComponentXY);
+#endif
   dstClip->setSupportsTiles(true);
 
   // Define the mandated "Transition" param, note that we don't do anything with this other than.
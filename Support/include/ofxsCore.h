@@ -332,18 +332,15 @@ namespace OFX {
     /** @brief The raw property handle */
     OfxPropertySetHandle _propHandle;
 
-    /** @brief Class static, whether we are logging each property action */
-    static int _gPropLogging;
-
     /** @brief Do not throw an exception if a host returns 'unsupported' when setting a property */
     static bool _gThrowOnUnsupported;
 
   public :
-    /** @brief turns on logging of property access functions */
-    static void propEnableLogging(void)  {++_gPropLogging;}
+    /** @brief does nothing, property accesses are no longer logged, they are traced if OFX_SUPPORTS_TRACE is defined, see ofxsTrace.h */
+    static void propEnableLogging(void)  {}
 
-    /** @brief turns off logging of property access functions */
-    static void propDisableLogging(void) {--_gPropLogging;}
+    /** @brief does nothing, see propEnableLogging */
+    static void propDisableLogging(void) {}
 
     /** @brief Do we throw an exception if a host returns 'unsupported' when setting a property. Default is true */
     static void setThrowOnUnsupportedProperties(bool v) {_gThrowOnUnsupported = v;}
@@ -46,6 +46,8 @@ of the direct OFX objects and any library side only functions.
 #include <string>
 #include <sstream> // stringstream
 #include <memory>
+#include <algorithm> // min and max in ImageView
+#include <stddef.h> // ptrdiff_t
 #ifndef NDEBUG
 #include <stdio.h> // printf in debug
 #endif
@@ -959,6 +961,10 @@ namespace OFX {
     const void* _inverseDistortionFunctionData;
 #endif
 
+  private :
+    /** @brief fetch the image properties through the property batch suite, if the host has it */
+    bool fetchPropertiesBatched(std::string &components, std::string &depth, std::string &premult, std::string &field);
+
   public :
     /** @brief ctor */
     ImageBase(OfxPropertySetHandle props);
@@ -1089,6 +1095,122 @@ namespace OFX {
     const void *getPixelAddressNearest(int x, int y) const;
   };
 
+  ////////////////////////////////////////////////////////////////////////////////
+  /** @brief A run of pixels along a row of an ImageView, from x1 up to but not including x2.
+
+  pixels points at the pixel at x1, or is NULL if the image has no data over the run.
+  */
+  template <class PIX>
+  struct RowSpan {
+    PIX *pixels;
+    int x1, x2;
+
+    /** @brief the number of pixels in the run */
+    int size(void) const { return x2 - x1; }
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /** @brief A typed view onto an image's pixels, for processors that know the depth and components at compile time.
+
+  Unlike Image::getPixelAddress, getRow and getPixel do no bounds checks, the caller clips once per row
+  with getRowSpan or getRun and then walks plain pointers, which lets the compiler vectorise the inner loops.
+  The view does not own the image, which must outlive it.
+  */
+  template <class PIX, int nComponents>
+  class ImageView {
+  protected :
+    char     *_data;      /**< @brief address of the pixel at (_bounds.x1, _bounds.y1), NULL for an empty view */
+    int       _rowBytes;  /**< @brief bytes from one row to the next, may be negative */
+    OfxRectI  _bounds;    /**< @brief the bounds on the pixel data */
+
+  public :
+    /** @brief an empty view, with no pixels anywhere */
+    ImageView()
+      : _data(NULL)
+      , _rowBytes(0)
+    {
+      _bounds.x1 = _bounds.y1 = _bounds.x2 = _bounds.y2 = 0;
+    }
+
+    /** @brief view an image, which may be NULL, in which case the view is empty */
+    explicit ImageView(const Image *img)
+      : _data(NULL)
+      , _rowBytes(0)
+    {
+      _bounds.x1 = _bounds.y1 = _bounds.x2 = _bounds.y2 = 0;
+      if(img && img->getPixelBytes() != 0) {
+        assert(img->getPixelBytes() == int(nComponents * sizeof(PIX)));
+        _data = (char *) img->getPixelData();
+        _rowBytes = img->getRowBytes();
+        _bounds = img->getBounds();
+      }
+    }
+
+    /** @brief view some pixel data, whose first pixel is at (bounds.x1, bounds.y1) */
+    ImageView(void *data, const OfxRectI &bounds, int rowBytes)
+      : _data((char *) data)
+      , _rowBytes(rowBytes)
+      , _bounds(bounds)
+    {
+    }
+
+    /** @brief is there no image data */
+    bool isEmpty(void) const { return _data == NULL; }
+
+    /** @brief get the bounds of the pixel data */
+    const OfxRectI &getBounds(void) const { return _bounds; }
+
+    /** @brief get the bytes from one row to the next */
+    int getRowBytes(void) const { return _rowBytes; }
+
+    /** @brief does the image have data on row y */
+    bool hasRow(int y) const { return _data && y >= _bounds.y1 && y < _bounds.y2; }
+
+    /** @brief the address of pixel (x, y), which must be within the bounds */
+    PIX *getPixel(int x, int y) const
+    {
+      return (PIX *) (_data + (ptrdiff_t)(y - _bounds.y1) * _rowBytes) + (ptrdiff_t)(x - _bounds.x1) * nComponents;
+    }
+
+    /** @brief the first pixel of row y, which must be within the bounds */
+    PIX *getRow(int y) const { return getPixel(_bounds.x1, y); }
+
+    /** @brief the part of row y between x1 and x2 that the image has data for.
+
+    If it has none, the span is empty, starting and ending at x2, and its pixels are NULL.
+    */
+    RowSpan<PIX> getRowSpan(int y, int x1, int x2) const
+    {
+      RowSpan<PIX> span;
+      span.x1 = (std::max)(x1, _bounds.x1);
+      span.x2 = (std::min)(x2, _bounds.x2);
+      if(!hasRow(y) || span.x1 >= span.x2) {
+        span.x1 = span.x2 = x2;
+        span.pixels = NULL;
+      }
+      else
+        span.pixels = getPixel(span.x1, y);
+      return span;
+    }
+
+    /** @brief the pixels of row y from x over which the image is either all there or all missing.
+
+    *x2 is pulled in to the end of that run, and NULL is returned if the image is missing over it.
+    Several images can share a run by passing each of them the same x2.
+    */
+    PIX *getRun(int x, int y, int *x2) const
+    {
+      if(!hasRow(y) || x >= _bounds.x2)
+        return NULL;
+      if(x < _bounds.x1) {
+        *x2 = (std::min)(*x2, _bounds.x1);
+        return NULL;
+      }
+      *x2 = (std::min)(*x2, _bounds.x2);
+      return getPixel(x, y);
+    }
+  };
+
   ////////////////////////////////////////////////////////////////////////////////
   /** @brief Wraps up an OpenGL texture */
   class Texture : public ImageBase {
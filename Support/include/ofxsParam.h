@@ -51,6 +51,10 @@ each represent the actions that can be carried out on those particular OFX objec
  */
 
 #include <memory>
+#include <functional>
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
 #include "ofxsCore.h"
 
 #ifdef OFX_EXTENSIONS_NUKE
@@ -2159,10 +2163,23 @@ namespace OFX {
         // so it can make one
         friend class ParamSet;
 
+        /** @brief number of changes the host told us of, counted by instanceChanged and read by renders */
+#if __cplusplus >= 201103L
+        std::atomic<unsigned int> _changeCount;
+#else
+        unsigned int _changeCount; ///< racy without C++11, a render may then bake a change one render late
+#endif
+
     public:
 
         /** @brief get the parametric range */
-        void getRange(double &min, double &max);
+        void getRange(double &min, double &max) const;
+
+        /** @brief get the number of curves */
+        int getNCurves(void) const;
+
+        /** @brief number of times the host has told the plugin the param changed, see ParametricParamLUT */
+        unsigned int getChangeCount(void) const {return _changeCount;}
 
         /** @brief set the hard min/max range, default is -DBL_MAX, DBL_MAX */
         void setDimensionRange(int curveIndex, double min, double max);
@@ -2235,6 +2252,143 @@ namespace OFX {
     };
 #endif
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /** @brief The curves of a parametric param at one time, baked into tables.
+
+    bake() samples each curve at getResolution() + 1 evenly spaced positions over the
+    param's range, and getValue() then interpolates linearly between the two nearest
+    samples, clamping positions to the range, so that evaluating a curve per pixel costs a
+    table lookup instead of a call to the host. getValues() evaluates a whole array of
+    positions, using SSE2 where the compiler targets it.
+
+    bake() does nothing if the table already holds the param at that time and the host
+    has not told the plugin of a change to the param since, so it can be called at the
+    start of every render. A baked table is read-only and can be shared by all the threads
+    of a render, but renders that run concurrently must not share one table.
+
+    Reading a curve that is not baked, because bake() was not called or failed, or whose
+    index is out of range, asserts in debug builds and returns the position unchanged.
+    */
+    class ParametricParamLUT {
+    public :
+        /** @brief make an empty table with the given number of intervals per curve */
+        explicit ParametricParamLUT(int resolution = 1024);
+
+        /** @brief sample the curves of the param at the given time, if not done already */
+        void bake(const ParametricParam *param, double t);
+
+        /** @brief forget the baked curves, so that the next bake() resamples them */
+        void invalidate(void) {_param = NULL;}
+
+        /** @brief the number of intervals per curve */
+        int getResolution(void) const {return _resolution;}
+
+        /** @brief the number of curves baked */
+        int getNCurves(void) const {return _nCurves;}
+
+        /** @brief value of a curve at a parametric position */
+        float getValue(int curveIndex, float position) const
+        {
+            assert(isBaked(curveIndex));
+            if(!isBaked(curveIndex))
+                return position;
+            float x = (position - _min) * _scale;
+            x = x > 0.f ? (x < (float) _resolution ? x : (float) _resolution) : 0.f;
+            int i = (int) x;
+            if(i == _resolution)
+                --i;
+            const float *t = &_table[curveIndex * (_resolution + 1) + i];
+            return t[0] + (x - (float) i) * (t[1] - t[0]);
+        }
+
+        /** @brief values of a curve at n parametric positions */
+        void getValues(int curveIndex, const float *positions, float *values, int n) const;
+
+    private :
+        /** @brief whether the curve is in the table */
+        bool isBaked(int curveIndex) const {return _param != NULL && curveIndex >= 0 && curveIndex < _nCurves;}
+
+        int                    _resolution;
+        int                    _nCurves;
+        float                  _min;       ///< start of the range
+        float                  _scale;     ///< intervals per unit of position
+        std::vector<float>     _table;     ///< _resolution + 1 samples per curve
+        const ParametricParam *_param;     ///< what is baked, NULL if nothing
+        double                 _time;
+        unsigned int           _changeCount; ///< of the param when baked, only used by the render owning the table
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /** @brief The values of a set of params at one time, fetched in one go.
+
+    Declare the params with addParam, or let ParamSet::fetchParamSnapshot take all the
+    value params fetched from the set, then call fetch. The values are kept in a flat
+    array and the getValue functions read them without calling the host, so once fetched
+    a snapshot can be read from any number of processing threads at once.
+
+    The OFX API gets one param at a time, so a fetch costs a suite call per param. A
+    snapshot kept on the plugin instance and fetched with ParamSet::fetchParamSnapshot
+    is only fetched again at another time, or when one of the set's params has changed
+    since, so the tiles of a frame share one fetch. Such a snapshot must not be fetched
+    from several render threads at once, guard it with a mutex if the plugin renders
+    concurrently.
+
+    Integer, double, colour, 2D, 3D, boolean and choice params can be in a snapshot.
+    */
+    class ParamSnapshot {
+    public :
+        /** @brief make an empty snapshot */
+        ParamSnapshot(void);
+
+        /** @brief add a param to the ones fetched, throws OFX::Exception::TypeRequest on param types that can't be in a snapshot */
+        void addParam(const Param *param);
+
+        /** @brief is the param in the snapshot */
+        bool hasParam(const Param *param) const;
+
+        /** @brief number of params in the snapshot */
+        int getNumParams(void) const {return (int) _entries.size();}
+
+        /** @brief fetch the values of all the params at the given time, always calling the host */
+        void fetch(double t);
+
+        /** @brief the time of the last fetch */
+        double getTime(void) const {return _time;}
+
+        /** @brief get the values fetched for a param, throws OFX::Exception::TypeRequest if it is not in the snapshot */
+        int getValue(const IntParam *param) const;
+        OfxPointI getValue(const Int2DParam *param) const;
+        Ofx3DPointI getValue(const Int3DParam *param) const;
+        double getValue(const DoubleParam *param) const;
+        OfxPointD getValue(const Double2DParam *param) const;
+        Ofx3DPointD getValue(const Double3DParam *param) const;
+        OfxRGBColourD getValue(const RGBParam *param) const;
+        OfxRGBAColourD getValue(const RGBAParam *param) const;
+        bool getValue(const BooleanParam *param) const;
+        int getValue(const ChoiceParam *param) const;
+
+    private :
+        struct Entry {
+            const Param *param;
+            int          offset; ///< of the param's first value in _values
+        };
+
+        struct EntryLess {
+            bool operator()(const Entry &a, const Entry &b) const {return std::less<const Param *>()(a.param, b.param);}
+        };
+
+        /** @brief the values of a param, checking it is there */
+        const double *findValues(const Param *param) const;
+
+        double             _time;
+        std::vector<Entry> _entries; ///< sorted by param
+        std::vector<double> _values;
+        bool               _fetched;     ///< whether the values are from a fetch since the last addParam
+        unsigned int       _changeCount; ///< the change count of the ParamSet at the last fetch
+
+        friend class ParamSet;
+    };
+
     ////////////////////////////////////////////////////////////////////////////////
     /** @brief A set of parameters in a plugin instance */
     class ParamSet { 
@@ -2251,6 +2405,13 @@ namespace OFX {
         /** @brief Set of all previously fetched parameters, created on demand */
         mutable std::map<std::string, Param *> _fetchedParams;
 
+        /** @brief number of param changes the host told us about, see fetchParamSnapshot */
+#if __cplusplus >= 201103L
+        std::atomic<unsigned int> _paramChangeCount;
+#else
+        unsigned int _paramChangeCount; ///< racy without C++11, a render may miss a change made while it runs
+#endif
+
         /** @brief see if we have a param of the given name in out map */
         Param *findPreviouslyFetchedParam(const std::string &name) const;
 
@@ -2356,6 +2517,17 @@ namespace OFX {
 
         /** @brief Fetch a parametric param */
         ParametricParam* fetchParametricParam(const std::string &name) const;
+
+        /** @brief fetch the values of the params in the snapshot at the given time.
+
+        If no params were added to the snapshot, all the params of this set fetched so far
+        that can be in a snapshot are added first. Nothing is fetched if the snapshot was
+        fetched at the same time since the last change to a param of this set.
+        */
+        void fetchParamSnapshot(double t, ParamSnapshot &snapshot) const;
+
+        /** @brief called by the library when the host says the named param changed, before changedParam */
+        void notifyParamChanged(const std::string &name);
     };
 };
 
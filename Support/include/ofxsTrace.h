@@ -0,0 +1,179 @@
+#ifndef _ofxsTrace_H_
+#define _ofxsTrace_H_
+/*
+OFX Support Library, a library that skins the OFX plug-in API with C++ classes.
+Copyright (C) 2004-2005 The Open Effects Association Ltd
+Author Bruno Nicoletti bruno@thefoundry.co.uk
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+* Neither the name The Open Effects Association Ltd, nor the names of its 
+contributors may be used to endorse or promote products derived from this
+software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The Open Effects Association Ltd
+1 Wardour St
+London W1D 6PA
+England
+
+
+*/
+
+/** @file This file contains OFX tracing header code.
+
+Tracing records small binary events, actions starting and stopping, calls into the host's
+suites, image fetches and byte counts, into a ring buffer per thread. Recording an event
+never locks or formats anything, so it hardly perturbs what it is measuring. The events
+are written out as a Chrome trace, which chrome://tracing or ui.perfetto.dev will show.
+
+Tracing is compiled in by defining OFX_SUPPORTS_TRACE, and needs C++11. Otherwise the
+OFXS_TRACE_ macros expand to nothing and cost nothing.
+
+Each thread's buffer holds the last OFXS_TRACE_BUFFER_EVENTS events, 65536 by default, which
+is 40 bytes an event, so 2.5MB. Define it to another power of 2 when building the support
+library to keep more or less history. Buffers are kept until the plugin is unloaded, but the
+buffer of a thread that has exited is reused by the next thread that traces, so the memory
+used goes with the most threads tracing at once, not with all the threads ever made.
+*/
+
+#if defined(OFX_SUPPORTS_TRACE) && __cplusplus >= 201103L
+#define OFXS_TRACE
+#endif
+
+#ifdef OFXS_TRACE
+
+#include <stdint.h>
+#include <string>
+
+/** @brief The core 'OFX Support' namespace, used by plugin implementations. All code for these are defined in the common support libraries.
+*/
+namespace OFX {
+
+  /** @brief this namespace wraps up tracing functionality */
+  namespace Trace {
+    /** @brief the kinds of event that are traced */
+    enum EventTypeEnum {
+      eEventActionBegin, /**< @brief an action started */
+      eEventActionEnd,   /**< @brief an action finished */
+      eEventSuiteCall,   /**< @brief a call into a host suite, with its duration */
+      eEventImageFetch,  /**< @brief a clip image fetch, with its duration and the size of the image in bytes */
+      eEventBytes,       /**< @brief a count of bytes, shown as a counter */
+      eEventScope        /**< @brief any other timed scope, eg: part of a plugin's render */
+    };
+
+    /** @brief A traced event.
+
+    Only the pointer to the name is kept, so it must be a string literal or otherwise outlive the trace.
+    */
+    struct Event {
+      uint64_t      time;     /**< @brief when it happened, or started, in nanoseconds */
+      uint64_t      duration; /**< @brief how long it took in nanoseconds, for timed events */
+      uint64_t      value;    /**< @brief the bytes of image fetches and byte counts */
+      const char   *name;
+      EventTypeEnum type;
+    };
+
+    /** @brief The time now in nanoseconds, from a steady clock. */
+    uint64_t now(void);
+
+    /** @brief Records an event in the calling thread's ring buffer, it neither locks nor allocates, bar the first time a thread records. */
+    void record(EventTypeEnum type, const char *name, uint64_t time, uint64_t duration = 0, uint64_t value = 0);
+
+    /** @brief Sets the name of the trace file, by default the OFX_PLUGIN_TRACEFILE environment variable or "ofxTrace.json". */
+    void setFileName(const std::string &value);
+
+    /** @brief Writes the events held in every thread's buffer to the trace file, returns whether this was sucessful or not.
+
+    The support library does this when the plugin is unloaded, or if it never was by the time the
+    process exits or the binary is closed. Threads may carry on tracing while it runs, any events they
+    overwrite whilst it is being written are left out.
+    */
+    bool dump(void);
+
+    /** @brief Records an event lasting as long as this object. */
+    class Scope {
+    public :
+      /** @brief ctor, starts the clock */
+      Scope(EventTypeEnum type, const char *name)
+        : _type(type)
+        , _name(name)
+        , _start(now())
+        , _value(0)
+      {}
+
+      /** @brief dtor, records the event */
+      ~Scope()
+      {
+        record(_type, _name, _start, now() - _start, _value);
+      }
+
+      /** @brief set the value recorded with the event, eg: the bytes fetched */
+      void setValue(uint64_t value) {_value = value;}
+
+    private :
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+      EventTypeEnum _type;
+      const char   *_name;
+      uint64_t      _start;
+      uint64_t      _value;
+    };
+  };
+};
+
+/** @brief the named action has started */
+#define OFXS_TRACE_ACTION_BEGIN(name) OFX::Trace::record(OFX::Trace::eEventActionBegin, (name), OFX::Trace::now())
+
+/** @brief the named action has finished */
+#define OFXS_TRACE_ACTION_END(name)   OFX::Trace::record(OFX::Trace::eEventActionEnd, (name), OFX::Trace::now())
+
+/** @brief times the rest of the enclosing block as a call into a host suite */
+#define OFXS_TRACE_SUITE_CALL(name)   OFX::Trace::Scope ofxsTraceScope(OFX::Trace::eEventSuiteCall, (name))
+
+/** @brief times the rest of the enclosing block as an image fetch, set its size with OFXS_TRACE_SET_BYTES */
+#define OFXS_TRACE_IMAGE_FETCH(name)  OFX::Trace::Scope ofxsTraceScope(OFX::Trace::eEventImageFetch, (name))
+
+/** @brief times the rest of the enclosing block */
+#define OFXS_TRACE_SCOPE(name)        OFX::Trace::Scope ofxsTraceScope(OFX::Trace::eEventScope, (name))
+
+/** @brief sets the bytes recorded by the enclosing OFXS_TRACE_IMAGE_FETCH */
+#define OFXS_TRACE_SET_BYTES(bytes)   ofxsTraceScope.setValue(bytes)
+
+/** @brief records a count of bytes */
+#define OFXS_TRACE_BYTES(name, bytes) OFX::Trace::record(OFX::Trace::eEventBytes, (name), OFX::Trace::now(), 0, (bytes))
+
+/** @brief writes the trace file */
+#define OFXS_TRACE_DUMP()             OFX::Trace::dump()
+
+#else
+
+#define OFXS_TRACE_ACTION_BEGIN(name) ((void)0)
+#define OFXS_TRACE_ACTION_END(name)   ((void)0)
+#define OFXS_TRACE_SUITE_CALL(name)   ((void)0)
+#define OFXS_TRACE_IMAGE_FETCH(name)  ((void)0)
+#define OFXS_TRACE_SCOPE(name)        ((void)0)
+#define OFXS_TRACE_SET_BYTES(bytes)   ((void)0)
+#define OFXS_TRACE_BYTES(name, bytes) ((void)0)
+#define OFXS_TRACE_DUMP()             ((void)0)
+
+#endif
+
+#endif
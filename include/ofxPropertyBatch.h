@@ -0,0 +1,108 @@
+#ifndef _ofxPropertyBatch_h_
+#define _ofxPropertyBatch_h_
+
+/*
+Software License :
+
+Copyright (c) 2003-2009, The Open Effects Association Ltd. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name The Open Effects Association Ltd, nor the names of its 
+      contributors may be used to endorse or promote products derived from this
+      software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "ofxCore.h"
+#include "ofxProperty.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @file ofxPropertyBatch.h
+Contains an optional suite that gets or sets several properties of a property set in a single call.
+
+Every call through ::OfxPropertySuiteV1 costs a suite call and a property lookup on the host,
+plugins that read a dozen properties at a time, such as when an image is fetched, can use this
+suite to make a single call instead. Plugins should fall back to ::OfxPropertySuiteV1 when the
+host does not provide it.
+*/
+
+/** @brief Name of the property batch suite */
+#define kOfxPropertyBatchSuite "OfxPropertyBatchSuite"
+
+/** @brief Types of properties in an ::OfxPropertyBatchRequest */
+typedef enum OfxPropertyBatchType {
+  kOfxPropertyBatchTypeInt = 0,     /**< values is an int array */
+  kOfxPropertyBatchTypeDouble = 1,  /**< values is a double array */
+  kOfxPropertyBatchTypeString = 2,  /**< values is a char * array */
+  kOfxPropertyBatchTypePointer = 3  /**< values is a void * array */
+} OfxPropertyBatchType;
+
+/** @brief One property to get or set in a call to the property batch suite */
+typedef struct OfxPropertyBatchRequest {
+  const char *name;           /**< name of the property */
+  OfxPropertyBatchType type;  /**< type of the property, which must match the actual type */
+  int count;                  /**< number of values to get or set, as for propGetN/propSetN */
+  void *values;               /**< array of count values of the given type */
+  OfxStatus status;           /**< set by the host to the status of this request alone */
+} OfxPropertyBatchRequest;
+
+/** @brief Suite that gets or sets several properties at once
+
+Each request is handled as the matching propGetN or propSetN of ::OfxPropertySuiteV1 would handle
+it, and its status is written into the request. A failed request does not stop the others from
+being handled.
+*/
+typedef struct OfxPropertyBatchSuiteV1 {
+  /** @brief Get the values of several properties
+
+      \arg properties is the handle of the thing holding the properties
+      \arg requests is an array of requests, the values of each are filled in
+      \arg nRequests is the number of requests
+
+      @returns
+        - ::kOfxStatOK if all the requests succeeded
+        - ::kOfxStatErrBadHandle if the property set handle is bad, no request is handled
+        - the status of the first failed request otherwise
+   */
+  OfxStatus (*propGetBatch)(OfxPropertySetHandle properties, OfxPropertyBatchRequest *requests, int nRequests);
+
+  /** @brief Set the values of several properties
+
+      \arg properties is the handle of the thing holding the properties
+      \arg requests is an array of requests, holding the values to set
+      \arg nRequests is the number of requests
+
+      @returns
+        - ::kOfxStatOK if all the requests succeeded
+        - ::kOfxStatErrBadHandle if the property set handle is bad, no request is handled
+        - the status of the first failed request otherwise
+   */
+  OfxStatus (*propSetBatch)(OfxPropertySetHandle properties, OfxPropertyBatchRequest *requests, int nRequests);
+} OfxPropertyBatchSuiteV1;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif